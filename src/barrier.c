@@ -0,0 +1,80 @@
+/**
+ *  \file barrier.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Reusable barrier.
+ *
+ *  Defined operations:
+ *     \li barrier set up
+ *     \li arrival at the barrier.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "barrier.h"
+
+/**
+ *  \brief Barrier set up.
+ *
+ *  The array of the number of arrivals must have been placed beforehand (see <tt>sharedDataSync.h</tt>).
+ *
+ *  \param p_b pointer to the barrier
+ *  \param nPart number of participants in every episode (>= 1)
+ *  \param nEpis number of episodes
+ *  \param window number of episodes which may be under way at once (>= 1)
+ *  \param sem0 identification of the release semaphore of sense 0 (the others follow in order)
+ */
+
+void barrierInit (BARRIER *p_b, unsigned int nPart, unsigned int nEpis, unsigned int window, unsigned int sem0)
+{
+  unsigned int s;                                                                               /* counting variable */
+
+  p_b->nPart = nPart;
+  p_b->nEpis = nEpis;
+  p_b->window = window;
+  p_b->sem0 = sem0;
+  for (s = 0; s <= window; s++)
+    BARRIERCNT (p_b, s) = 0;                                                   /* nobody has arrived in any episode */
+}
+
+/**
+ *  \brief Arrival at the barrier.
+ *
+ *  It must be called within a critical region which serializes the participants.
+ *
+ *  \param p_b pointer to the barrier
+ *  \param e episode the participant has arrived at the end of
+ *  \param p_sense pointer to the location where the sense to wait on, or to release, is to be stored
+ *  \param p_nRel pointer to the location where the number of participants to be released is to be stored
+ *
+ *  \return \c BARRIER_WAIT, if the participant must wait
+ *  \return \c BARRIER_PASS, if the participant may go on
+ *  \return \c BARRIER_FINAL, if the participant is the last one to arrive in the last episode
+ */
+
+unsigned int barrierArrive (BARRIER *p_b, unsigned int e, unsigned int *p_sense, unsigned int *p_nRel)
+{
+  unsigned int s = e % (p_b->window + 1);                                                      /* sense of episode e */
+
+  *p_nRel = 0;
+  if (++BARRIERCNT (p_b, s) < p_b->nPart)
+     { if (e + 1 < p_b->window)                                         /* there is no episode to wait for, as yet */
+          return BARRIER_PASS;
+       *p_sense = s;
+       return BARRIER_WAIT;
+     }
+  BARRIERCNT (p_b, s) = 0;                                           /* the episode is over: its sense may be reused */
+  if (e + p_b->window - 1 < p_b->nEpis)                    /* the participants waiting for it are released at once */
+     { *p_sense = (e + p_b->window - 1) % (p_b->window + 1);
+       *p_nRel = p_b->nPart - 1;
+     }
+  return (e + 1 == p_b->nEpis) ? BARRIER_FINAL : BARRIER_PASS;
+}
@@ -0,0 +1,83 @@
+/**
+ *  \file barrier.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Reusable barrier.
+ *
+ *  Defined operations:
+ *     \li barrier set up
+ *     \li arrival at the barrier.
+ *
+ *  A barrier is kept in the shared region and used once per episode (a flight, for the end-of-flight rendezvous of
+ *  the passengers). Arrivals are counted within the critical region of the caller, at a constant cost.
+ *
+ *  The participants may run ahead by up to a <em>window</em> of W episodes: the one arriving at the end of episode e
+ *  only waits for episode e-W+1 to be over, that is, for all the participants to have arrived at its end. With W = 1,
+ *  it is a plain rendezvous. Every episode has a <em>sense</em>, e mod (W+1): those who must wait block on the
+ *  release semaphore of the sense of their episode, <tt>BARRIERSEM (p_b, sense)</tt>, and the last one to arrive at
+ *  the end of episode e releases the ones waiting at the end of episode e+W-1 with a single <em>up</em> of
+ *  <tt>nPart - 1</tt>. As no participant may be more than W episodes ahead of another, W+1 senses ensure that nobody
+ *  ever takes a release meant for someone still leaving an earlier episode.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#ifndef BARRIER_H_
+#define BARRIER_H_
+
+#include "sharedDataSync.h"
+
+/** \brief the participant must wait for an earlier episode to be over */
+#define  BARRIER_WAIT        0
+
+/** \brief the participant may go on */
+#define  BARRIER_PASS        1
+
+/** \brief the participant is the last one to arrive in the last episode */
+#define  BARRIER_FINAL       2
+
+/** \brief identification of the release semaphore of sense s */
+#define  BARRIERSEM(p_b,s)   ((p_b)->sem0+(s))
+
+/** \brief number of participants who have arrived in the episode of sense s */
+#define  BARRIERCNT(p_b,s)   (((unsigned int *) SHADDR (p_b, (p_b)->countOff))[s])
+
+/**
+ *  \brief Barrier set up.
+ *
+ *  The array of the number of arrivals must have been placed beforehand (see <tt>sharedDataSync.h</tt>).
+ *
+ *  \param p_b pointer to the barrier
+ *  \param nPart number of participants in every episode (>= 1)
+ *  \param nEpis number of episodes
+ *  \param window number of episodes which may be under way at once (>= 1)
+ *  \param sem0 identification of the release semaphore of sense 0 (the others follow in order)
+ */
+
+extern void barrierInit (BARRIER *p_b, unsigned int nPart, unsigned int nEpis, unsigned int window, unsigned int sem0);
+
+/**
+ *  \brief Arrival at the barrier.
+ *
+ *  It must be called within a critical region which serializes the participants. A participant who must wait blocks
+ *  on <tt>BARRIERSEM (p_b, *p_sense)</tt> after leaving it. Otherwise, if <tt>*p_nRel</tt> is not zero, she must up
+ *  <tt>BARRIERSEM (p_b, *p_sense)</tt> by <tt>*p_nRel</tt>.
+ *
+ *  \param p_b pointer to the barrier
+ *  \param e episode the participant has arrived at the end of
+ *  \param p_sense pointer to the location where the sense to wait on, or to release, is to be stored
+ *  \param p_nRel pointer to the location where the number of participants to be released is to be stored
+ *
+ *  \return \c BARRIER_WAIT, if the participant must wait
+ *  \return \c BARRIER_PASS, if the participant may go on
+ *  \return \c BARRIER_FINAL, if the participant is the last one to arrive in the last episode
+ */
+
+extern unsigned int barrierArrive (BARRIER *p_b, unsigned int e, unsigned int *p_sense, unsigned int *p_nRel);
+
+#endif /* BARRIER_H_ */
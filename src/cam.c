@@ -15,6 +15,9 @@
  *     \li test for CAM full
  *     \li test for CAM empty.
  *
+ *  The storage region holds a counter per key, the number of values equal to it presently stored, and the total
+ *  is kept apart. Every operation but the initialization is thus carried out in constant time.
+ *
  *  \author António Rui Borges - November 2013
  */
 
@@ -37,7 +40,13 @@
 
 void camInit (CAM *p_c)
 {
+  unsigned int i;                      /* counting variable */
+  unsigned int *cnt;                   /* storage region */
+
   if (p_c == NULL) return;
+  cnt = SHADDR (p_c, p_c->memOff);
+  for (i = 0; i < p_c->nKeys; i++)
+    cnt[i] = 0;
   p_c->n = 0;
 }
 
@@ -56,24 +65,18 @@ void camInit (CAM *p_c)
 
 bool camSearch (CAM *p_c, unsigned int val)
 {
-  unsigned int i;                      /* counting variable */
-
-  if (p_c == NULL) return false;
-  for (i = 0; i < p_c->n; i++)
-    if (p_c->mem[i].id == val)
-       return true;
-       else if (p_c->mem[i].id > val)
-               return false;
-  return false;
+  if ((p_c == NULL) || (val >= p_c->nKeys)) return false;
+  return ((unsigned int *) SHADDR (p_c, p_c->memOff))[val] != 0;
 }
 
 /**
  *  \brief Insertion of a value into the CAM.
  *
  *         The key is in this case the value itself to be stored.
- *         The function fails if a null pointer is passed as a parameter or the CAM is full.
+ *         The function fails if a null pointer is passed as a parameter, the CAM is full or the value is not a key
+ *         (it must be lower than the number of keys).
  *         Nothing is stored if the function fails.
- *         If an equal value is already stored in the CAM, the new value is stored in FIFO order.
+ *         Equal values are not told apart: storing one more just increments their count.
  *
  *  \param p_c pointer to the location where the CAM is stored
  *  \param val value to be stored
@@ -81,25 +84,8 @@ bool camSearch (CAM *p_c, unsigned int val)
 
 void camIn (CAM *p_c, unsigned int val)
 {
-  unsigned int i, j;                   /* counting variables */
-
-  if ((p_c == NULL) || (p_c->n == M*N)) return;
-  if (p_c->n == 0)
-     /* CAM is empty */
-     p_c->mem[0].id = val;
-     else if (p_c->mem[0].id > val)
-             { /* insertion at the beginning of the array */
-               for (i = p_c->n; i > 0; i--)
-                 p_c->mem[i] = p_c->mem[i-1];
-               p_c->mem[0].id = val;
-             }
-             else { /* insertion somewhere else */
-                    for (i = 1; i < p_c->n; i++)
-                      if (p_c->mem[i].id > val) break;
-                    for (j = p_c->n; j > i; j--)
-                      p_c->mem[j] = p_c->mem[j-1];
-                    p_c->mem[i].id = val;
-                  }
+  if ((p_c == NULL) || (p_c->n == p_c->size) || (val >= p_c->nKeys)) return;
+  ((unsigned int *) SHADDR (p_c, p_c->memOff))[val] += 1;
   p_c->n += 1;
 }
 
@@ -110,7 +96,7 @@ void camIn (CAM *p_c, unsigned int val)
  *         The function fails if a null pointer is passed as a parameter or the CAM is empty or no value is presently
  *         stored there.
  *         Nothing is retrieved if the function fails.
- *         If more than one value is stored in the CAM, the extracted value is retrieved in FIFO order.
+ *         If more than one equal value is stored in the CAM, their count is decremented.
  *
  *  \param p_c pointer to the location where the CAM is stored
  *  \param val value to be retrieved
@@ -118,16 +104,14 @@ void camIn (CAM *p_c, unsigned int val)
 
 void camOut (CAM *p_c, unsigned int val)
 {
-  unsigned int i, j;                   /* counting variables */
-
-  if ((p_c == NULL) || (p_c->n == 0)) return;
-  for (i = 0; i < p_c->n; i++)
-    if (p_c->mem[i].id == val)
-       { for (j = i + 1; j < p_c->n; j++)
-           p_c->mem[j-1] = p_c->mem[j];
-         p_c->n -= 1;
-         break;
-       }
+  unsigned int *cnt;                   /* storage region */
+
+  if ((p_c == NULL) || (p_c->n == 0) || (val >= p_c->nKeys)) return;
+  cnt = SHADDR (p_c, p_c->memOff);
+  if (cnt[val] != 0)
+     { cnt[val] -= 1;
+       p_c->n -= 1;
+     }
 }
 
 /**
@@ -144,7 +128,7 @@ void camOut (CAM *p_c, unsigned int val)
 bool camFull (CAM *p_c)
 {
   if (p_c == NULL) return false;
-  return p_c->n == M*N;
+  return p_c->n == p_c->size;
 }
 
 /**
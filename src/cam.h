@@ -55,9 +55,10 @@ extern bool camSearch (CAM *p_c, unsigned int val);
  *  \brief Insertion of a value into the CAM.
  *
  *         The key is in this case the value itself to be stored.
- *         The function fails if a null pointer is passed as a parameter or the CAM is full.
+ *         The function fails if a null pointer is passed as a parameter, the CAM is full or the value is not a key
+ *         (it must be lower than the number of keys).
  *         Nothing is stored if the function fails.
- *         If an equal value is already stored in the CAM, the new value is stored in FIFO order.
+ *         Equal values are not told apart: storing one more just increments their count.
  *
  *  \param p_c pointer to the location where the CAM is stored
  *  \param val value to be stored
@@ -72,7 +73,7 @@ extern void camIn (CAM *p_c, unsigned int val);
  *         The function fails if a null pointer is passed as a parameter or the CAM is empty or no value is presently
  *         stored there.
  *         Nothing is retrieved if the function fails.
- *         If more than one value is stored in the CAM, the extracted value is retrieved in FIFO order.
+ *         If more than one equal value is stored in the CAM, their count is decremented.
  *
  *  \param p_c pointer to the location where the CAM is stored
  *  \param val value to be retrieved
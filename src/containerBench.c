@@ -0,0 +1,415 @@
+/**
+ *  \file containerBench.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Microbenchmarks of the containers kept in the shared region: the CAM of the conveyor belt and the queue of the
+ *  transfer ride.
+ *
+ *  Usage: <tt>containerBench</tt> [<em>repetitions</em>]
+ *
+ *  Every operation is timed at several numbers of passengers N and occupancy patterns, and reported in nanoseconds
+ *  per operation:
+ *     \li CAM - insertion, search of stored and of absent values and retrieval, with the belt (M*N bags, M = 2)
+ *         empty, half full and full; the same operations of the former CAM, a sorted array of bags, are timed as
+ *         well as a reference, up to <tt>SORTEDMAX</tt> passengers
+ *     \li queue - insertion followed by retrieval, retrieval of a busload (<tt>BUSLOAD</tt> identifications) in one
+ *         call followed by their insertion, peek at every position and a pass of the iterator, with one, N/2 and N
+ *         identifications stored, and the retrieval pointer in the middle of the storage region so that positions
+ *         wrap around; the queue is timed with a power of two storage region (indices masked, <tt>queue</tt>) and
+ *         with one of N - 1 identifications (indices compared against the size, <tt>queue-np2</tt>).
+ *
+ *  The values are drawn from a generator with a fixed seed, so that every run times the same sequence of operations.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "cam.h"
+#include "queue.h"
+
+/** \brief default number of repetitions of every measure */
+#define  REPS          5
+
+/** \brief maximum number of pieces of luggage per passenger */
+#define  M             2
+
+/** \brief largest number of passengers the reference CAM is timed at (its insertion is quadratic) */
+#define  SORTEDMAX     4096
+
+/** \brief number of identifications retrieved from the queue in one call (bus seats) */
+#define  BUSLOAD       8
+
+/** \brief numbers of passengers (N) the containers are timed at */
+static const unsigned int nPass[] = { 16, 256, 4096, 32768 };
+
+/** \brief seed of the random number generator */
+static unsigned int seed;
+
+/** \brief results of the operations, so that they are not optimized away */
+static volatile unsigned long sink;
+
+/**
+ *  \brief Definition of <em>reference CAM</em> data type (the former sorted array of bags).
+ */
+typedef struct
+        { /** \brief storage region */
+          BAG *mem;
+          /** \brief size of the storage region */
+          unsigned int size;
+          /** \brief number of bags presently stored */
+          unsigned int n;
+        } SORTED;
+
+/**
+ *  \brief Next value of the random number generator (linear congruential).
+ *
+ *  \param lim upper bound (exclusive)
+ *
+ *  \return value in 0 .. lim-1
+ */
+
+static unsigned int draw (unsigned int lim)
+{
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 8) % lim;
+}
+
+/**
+ *  \brief Present time of the monotonic clock.
+ *
+ *  \return time (in nanoseconds)
+ */
+
+static double clockNs (void)
+{
+  struct timespec t;                                                                                 /* present time */
+
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+/**
+ *  \brief Allocation of a container and its storage region.
+ *
+ *  The storage region is placed right after the descriptor and zero filled. The caller sets the <tt>memOff</tt>
+ *  field of the descriptor accordingly, as it is done in the shared region.
+ *
+ *  \param dSize size of the descriptor (in bytes)
+ *  \param mSize size of the storage region (in bytes)
+ *
+ *  \return pointer to the descriptor
+ */
+
+static void *alloc (size_t dSize, size_t mSize)
+{
+  void *p;                                                                                /* pointer to the container */
+
+  if ((p = calloc (1, dSize + mSize)) == NULL)
+     { perror ("error on allocating a container");
+       exit (EXIT_FAILURE);
+     }
+  return p;
+}
+
+/**
+ *  \brief Reporting a measure.
+ *
+ *  \param cont container name
+ *  \param op operation name
+ *  \param n number of passengers
+ *  \param occ occupancy pattern
+ *  \param ns elapsed time (in nanoseconds)
+ *  \param nOp number of operations carried out
+ */
+
+static void report (const char *cont, const char *op, unsigned int n, const char *occ, double ns, unsigned long nOp)
+{
+  if (nOp != 0)                                                    /* only the operations carried out are reported */
+     printf ("%-9s %-12s %6u  %-6s %10.2f\n", cont, op, n, occ, ns / nOp);
+}
+
+/* reference CAM */
+
+/**
+ *  \brief Search for a value in the reference CAM.
+ *
+ *  \param p_c pointer to the reference CAM
+ *  \param val value to be searched
+ *
+ *  \return \c true, if the value is found
+ *  \return \c false, otherwise
+ */
+
+static bool sortedSearch (SORTED *p_c, unsigned int val)
+{
+  unsigned int i;                                                                               /* counting variable */
+
+  for (i = 0; i < p_c->n; i++)
+    if (p_c->mem[i].id == val)
+       return true;
+       else if (p_c->mem[i].id > val)
+               return false;
+  return false;
+}
+
+/**
+ *  \brief Insertion of a value into the reference CAM.
+ *
+ *  \param p_c pointer to the reference CAM
+ *  \param val value to be stored
+ */
+
+static void sortedIn (SORTED *p_c, unsigned int val)
+{
+  unsigned int i, j;                                                                           /* counting variables */
+
+  if (p_c->n == p_c->size) return;
+  for (i = 0; (i < p_c->n) && (p_c->mem[i].id <= val); i++);
+  for (j = p_c->n; j > i; j--)
+    p_c->mem[j] = p_c->mem[j-1];
+  p_c->mem[i].id = val;
+  p_c->n += 1;
+}
+
+/**
+ *  \brief Retrieval of a value from the reference CAM.
+ *
+ *  \param p_c pointer to the reference CAM
+ *  \param val value to be retrieved
+ */
+
+static void sortedOut (SORTED *p_c, unsigned int val)
+{
+  unsigned int i, j;                                                                           /* counting variables */
+
+  for (i = 0; i < p_c->n; i++)
+    if (p_c->mem[i].id == val)
+       { for (j = i + 1; j < p_c->n; j++)
+           p_c->mem[j-1] = p_c->mem[j];
+         p_c->n -= 1;
+         break;
+       }
+}
+
+/* measures */
+
+/**
+ *  \brief Timing the CAM at a number of passengers.
+ *
+ *  The belt is filled with bags of the even numbered passengers, so that the odd numbered ones are never found.
+ *
+ *  \param n number of passengers
+ *  \param reps number of repetitions
+ */
+
+static void benchCam (unsigned int n, unsigned int reps)
+{
+  static const char *occName[] = { "empty", "half", "full" };                              /* occupancy patterns */
+  CAM *p_c;                                                                                      /* CAM under test */
+  SORTED ref;                                                                                      /* reference CAM */
+  unsigned int size = M * n,                                                                    /* number of bags */
+               *val,                                                                        /* values to be stored */
+               occ, fill, i, r;                                          /* occupancy, fill level, counting variables */
+  double t[2][4];                                               /* elapsed times (in, hit, miss, out) per container */
+  bool sorted = (n <= SORTEDMAX);                                                 /* the reference CAM is timed */
+  unsigned long nOp[4];                                                         /* number of operations per measure */
+
+  p_c = alloc (sizeof (CAM), n * sizeof (unsigned int));
+  p_c->memOff = sizeof (CAM);
+  p_c->nKeys = n;
+  p_c->size = size;
+  ref.mem = alloc (0, size * sizeof (BAG));
+  ref.size = size;
+  if ((val = malloc (size * sizeof (unsigned int))) == NULL)
+     { perror ("error on allocating the values");
+       exit (EXIT_FAILURE);
+     }
+  for (occ = 0; occ < 3; occ++)
+  { fill = occ * size / 2;
+    memset (t, 0, sizeof (t));
+    memset (nOp, 0, sizeof (nOp));
+    for (r = 0; r < reps; r++)
+    { seed = 1 + occ;
+      for (i = 0; i < size; i++)
+        val[i] = 2 * draw ((n + 1) / 2);
+      camInit (p_c);
+      ref.n = 0;
+      for (i = 0; i < fill; i++)                                                        /* set the occupancy pattern */
+      { camIn (p_c, val[i]);
+        if (sorted) sortedIn (&ref, val[i]);
+      }
+                                                          /* insertion up to full (of one bag, if it is already full) */
+      t[0][0] -= clockNs ();
+      for (i = fill; i < size; i++)
+        camIn (p_c, val[i]);
+      t[0][0] += clockNs ();
+      t[1][0] -= clockNs ();
+      for (i = fill; sorted && (i < size); i++)
+        sortedIn (&ref, val[i]);
+      t[1][0] += clockNs ();
+      nOp[0] += size - fill;
+      for (i = fill; i < size; i++)                                                  /* back to the occupancy pattern */
+      { camOut (p_c, val[i]);
+        if (sorted) sortedOut (&ref, val[i]);
+      }
+                                                                                /* search of stored and absent values */
+      t[0][1] -= clockNs ();
+      for (i = 0; i < size; i++)
+        sink += camSearch (p_c, val[i % ((fill != 0) ? fill : 1)]);
+      t[0][1] += clockNs ();
+      t[1][1] -= clockNs ();
+      for (i = 0; sorted && (i < size); i++)
+        sink += sortedSearch (&ref, val[i % ((fill != 0) ? fill : 1)]);
+      t[1][1] += clockNs ();
+      t[0][2] -= clockNs ();
+      for (i = 0; i < size; i++)
+        sink += camSearch (p_c, val[i] | 1);
+      t[0][2] += clockNs ();
+      t[1][2] -= clockNs ();
+      for (i = 0; sorted && (i < size); i++)
+        sink += sortedSearch (&ref, val[i] | 1);
+      t[1][2] += clockNs ();
+      nOp[1] += size;
+      nOp[2] += size;
+                                                                              /* retrieval of all the values stored */
+      t[0][3] -= clockNs ();
+      for (i = 0; i < fill; i++)
+        camOut (p_c, val[i]);
+      t[0][3] += clockNs ();
+      t[1][3] -= clockNs ();
+      for (i = 0; sorted && (i < fill); i++)
+        sortedOut (&ref, val[i]);
+      t[1][3] += clockNs ();
+      nOp[3] += fill;
+    }
+    report ("cam", "insert", n, occName[occ], t[0][0], nOp[0]);
+    report ("cam", "search-hit", n, occName[occ], t[0][1], (fill != 0) ? nOp[1] : 0);
+    report ("cam", "search-miss", n, occName[occ], t[0][2], nOp[2]);
+    report ("cam", "remove", n, occName[occ], t[0][3], nOp[3]);
+    if (sorted)
+       { report ("sorted", "insert", n, occName[occ], t[1][0], nOp[0]);
+         report ("sorted", "search-hit", n, occName[occ], t[1][1], (fill != 0) ? nOp[1] : 0);
+         report ("sorted", "search-miss", n, occName[occ], t[1][2], nOp[2]);
+         report ("sorted", "remove", n, occName[occ], t[1][3], nOp[3]);
+       }
+  }
+  free (val);
+  free (ref.mem);
+  free (p_c);
+}
+
+/**
+ *  \brief Timing the queue at a storage region size.
+ *
+ *  \param name container name to be reported
+ *  \param n size of the storage region
+ *  \param reps number of repetitions
+ */
+
+static void benchQueue (const char *name, unsigned int n, unsigned int reps)
+{
+  static const char *occName[] = { "one", "half", "full" };                                /* occupancy patterns */
+  QUEUE *p_q;                                                                                  /* queue under test */
+  QUEUEIT it;                                                                                    /* queue iterator */
+  unsigned int len[3],                                                            /* queue lengths of the patterns */
+               occ, i, j, r, v, c,                         /* occupancy, counting variables, value, retrieved values */
+               load[BUSLOAD];                                                                   /* retrieved busload */
+  double t[4];                                                 /* elapsed times (in and out, busload, peek, iterate) */
+  unsigned long nOp[4];                                                         /* number of operations per measure */
+
+  p_q = alloc (sizeof (QUEUE), n * sizeof (unsigned int));
+  p_q->memOff = sizeof (QUEUE);
+  p_q->size = n;
+  len[0] = 1;
+  len[1] = (n > 1) ? n / 2 : 1;
+  len[2] = n;
+  for (occ = 0; occ < 3; occ++)
+  { memset (t, 0, sizeof (t));
+    memset (nOp, 0, sizeof (nOp));
+    for (r = 0; r < reps; r++)
+    { seed = 11 + occ;
+      queueInit (p_q);
+      for (i = 0; i < n / 2; i++)                          /* move the pointers to the middle of the storage region */
+      { queueIn (p_q, i);
+        queueOut (p_q, &v);
+      }
+      for (i = 0; i < len[occ]; i++)                                                    /* set the occupancy pattern */
+        queueIn (p_q, draw (n));
+      t[0] -= clockNs ();                               /* retrieval followed by insertion, at a constant length */
+      for (i = 0; i < 4 * n; i++)
+      { queueOut (p_q, &v);
+        queueIn (p_q, v);
+      }
+      t[0] += clockNs ();
+      nOp[0] += 4 * n;
+      t[1] -= clockNs ();                       /* retrieval of a busload followed by its insertion (per value) */
+      for (i = 0; i < 4 * n; i += c)
+      { c = queueOutN (p_q, load, BUSLOAD);
+        for (j = 0; j < c; j++)
+          queueIn (p_q, load[j]);
+      }
+      t[1] += clockNs ();
+      nOp[1] += i;
+      t[2] -= clockNs ();                                                              /* peek at every position */
+      for (j = 0; j < 4; j++)
+        for (i = 0; i < n; i++)
+          sink += queuePeek (p_q, i);
+      t[2] += clockNs ();
+      nOp[2] += 4 * n;
+      t[3] -= clockNs ();                                                  /* a pass of the iterator (per value) */
+      for (j = 0; j < 4; j++)
+      { queueIterInit (p_q, &it);
+        while (queueIterNext (&it, &v))
+          sink += v;
+      }
+      t[3] += clockNs ();
+      nOp[3] += 4 * queueSize (p_q);
+    }
+    report (name, "out+in", n, occName[occ], t[0], nOp[0]);
+    report (name, "outN+in", n, occName[occ], t[1], nOp[1]);
+    report (name, "peek", n, occName[occ], t[2], nOp[2]);
+    report (name, "iterate", n, occName[occ], t[3], nOp[3]);
+  }
+  free (p_q);
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+  unsigned int reps = REPS,                                                                 /* number of repetitions */
+               i;                                                                               /* counting variable */
+  char *tinp;                                                                      /* numerical parameters test flag */
+
+  if (argc > 2)
+     { fprintf (stderr, "usage: %s [repetitions]\n", argv[0]);
+       return EXIT_FAILURE;
+     }
+  if (argc == 2)
+     { reps = (unsigned int) strtoul (argv[1], &tinp, 0);
+       if ((*tinp != '\0') || (reps == 0))
+          { fprintf (stderr, "invalid number of repetitions: %s\n", argv[1]);
+            return EXIT_FAILURE;
+          }
+     }
+  printf ("%-9s %-12s %6s  %-6s %10s\n", "cont", "operation", "N", "occup", "ns/op");
+  for (i = 0; i < sizeof (nPass) / sizeof (nPass[0]); i++)
+    benchCam (nPass[i], reps);
+  for (i = 0; i < sizeof (nPass) / sizeof (nPass[0]); i++)
+  { benchQueue ("queue", nPass[i], reps);
+    benchQueue ("queue-np2", nPass[i] - 1, reps);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/**
+ *  \file departure.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  \brief Scheduling the departures of the bus.
+ *
+ *  Defined operations:
+ *     \li timetable set up
+ *     \li reading the clock
+ *     \li recording the arrival of a passenger at the bus queue
+ *     \li scheduled departure time of the present ride
+ *     \li recording a departure
+ *     \li writing the departure report.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "queue.h"
+#include "departure.h"
+
+/** \brief nanoseconds in a millisecond */
+#define  MSEC           1000000ULL
+
+/**
+ *  \brief Timetable set up.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param spec timetable (<tt>NULL</tt> for the default one)
+ *  \param t0 start of the timetable (in ns)
+ *
+ *  \return \c true, upon success
+ *  \return \c false, if the timetable is not valid
+ */
+
+bool depSetup (FULL_STAT *p_fSt, char *spec, unsigned long long t0)
+{
+  DEPSCHED *p_d = &(p_fSt->dep);                                                      /* pointer to the timetable */
+  unsigned long val;                                                                              /* converted value */
+  char *q;                                                                                    /* present list pointer */
+  size_t len;                                                                                    /* length of a name */
+
+  memset (p_d, 0, sizeof (DEPSCHED));
+  p_d->maxWait = DEPART_WAIT * MSEC;
+  p_d->load = p_fSt->dim.t;
+  p_d->slack = DEPART_SLACK * MSEC;
+  p_d->t0 = t0;
+  if (spec == NULL) return true;
+  q = spec;
+  while (*q != '\0')
+  { if ((len = strcspn (q, "=")) == strlen (q)) return false;
+    if ((q[len + 1] < '0') || (q[len + 1] > '9')) return false;
+    val = strtoul (q + len + 1, NULL, 10);
+    if ((val > DEPART_MAX) && ((len != 4) || (strncmp (q, "load", len) != 0))) return false;
+    if ((len == 7) && (strncmp (q, "headway", len) == 0))
+       p_d->headway = val * MSEC;
+       else if ((len == 4) && (strncmp (q, "wait", len) == 0))
+               p_d->maxWait = val * MSEC;
+               else if ((len == 4) && (strncmp (q, "load", len) == 0) && (val >= 1) && (val <= p_fSt->dim.t))
+                       p_d->load = (unsigned int) val;
+                       else if ((len == 5) && (strncmp (q, "slack", len) == 0))
+                               p_d->slack = val * MSEC;
+                               else return false;
+    q += len + 1 + strspn (q + len + 1, "0123456789");
+    if (*q == ',') q += 1;
+       else if (*q != '\0') return false;
+  }
+  return (p_d->headway != 0) || (p_d->maxWait != 0);
+}
+
+/**
+ *  \brief Reading the clock the timetable is kept in.
+ *
+ *  \return the present time of the monotonic clock (in ns)
+ */
+
+unsigned long long depClock (void)
+{
+  struct timespec t;                                                                                 /* present time */
+
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return (unsigned long long) t.tv_sec * 1000000000ULL + (unsigned long long) t.tv_nsec;
+}
+
+/**
+ *  \brief Recording the arrival of a passenger at the bus queue.
+ *
+ *  It should be called within the bus queue critical region, right after the passenger has queued.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param id passenger identification
+ *  \param now present time (in ns)
+ *
+ *  \return \c true, if the bus driver should be told (she is the first one in line or the load threshold is reached)
+ *  \return \c false, otherwise
+ */
+
+bool depQueued (FULL_STAT *p_fSt, unsigned int id, unsigned long long now)
+{
+  unsigned int n = queueSize (&(p_fSt->busQueue));                                /* number of queueing passengers */
+
+  QTIME (p_fSt, id) = now;
+  if (n == 1)
+     p_fSt->dep.firstQ = now;
+  return (n == 1) || (n >= p_fSt->dep.load);
+}
+
+/**
+ *  \brief Scheduled departure time of the present ride.
+ *
+ *  It should be called within the bus queue critical region, with someone queueing.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *
+ *  \return the scheduled departure time (in ns)
+ */
+
+unsigned long long depDeadline (FULL_STAT *p_fSt)
+{
+  DEPSCHED *p_d = &(p_fSt->dep);                                                      /* pointer to the timetable */
+  unsigned long long dl = 0, slot;                                    /* scheduled departure time and timetable slot */
+
+  if (p_d->maxWait != 0)
+     dl = p_d->firstQ + p_d->maxWait;
+  if (p_d->headway != 0)
+     { slot = p_d->t0;                                       /* first slot not earlier than the first one in line */
+       if (p_d->firstQ > p_d->t0)
+          slot += (p_d->firstQ - p_d->t0 + p_d->headway - 1) / p_d->headway * p_d->headway;
+       if ((dl == 0) || (slot < dl)) dl = slot;
+     }
+  return dl;
+}
+
+/**
+ *  \brief Recording a departure.
+ *
+ *  It should be called within the bus queue critical region, right after the passengers have been summoned from the
+ *  queue. A departure within the slack past the scheduled time is on time. If some are left behind, the next ride is
+ *  waited for since the one who is now first in line queued.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param now present time (in ns)
+ *  \param n number of passengers who board the bus
+ *  \param b bus they board
+ */
+
+void depDepart (FULL_STAT *p_fSt, unsigned long long now, unsigned int n, unsigned int b)
+{
+  DEPSCHED *p_d = &(p_fSt->dep);                                                      /* pointer to the timetable */
+  unsigned long long dl = depDeadline (p_fSt);                                              /* scheduled departure */
+
+  p_d->nDep += 1;
+  p_d->nPass += n;
+  BUS (p_fSt, b).nDep += 1;
+  BUS (p_fSt, b).nPass += n;
+  if (now > p_d->firstQ)
+     p_d->waitSum += now - p_d->firstQ;
+  if (now > dl + p_d->slack)
+     { p_d->nLate += 1;
+       p_d->lateSum += now - dl;
+       if (now - dl > p_d->lateMax) p_d->lateMax = now - dl;
+     }
+     else if ((now < dl) && (n >= p_d->load))
+             p_d->nLoad += 1;
+  p_d->firstQ = queueEmpty (&(p_fSt->busQueue)) ? 0 : QTIME (p_fSt, queuePeek (&(p_fSt->busQueue), 0));
+}
+
+/**
+ *  \brief Writing the departure report.
+ *
+ *  The departures of the whole fleet are summed up, followed by a line per bus.
+ *
+ *  \param fic file descriptor
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ */
+
+void depReport (FILE *fic, FULL_STAT *p_fSt)
+{
+  DEPSCHED *p_d = &(p_fSt->dep);                                                      /* pointer to the timetable */
+  unsigned int b;                                                                               /* counting variable */
+
+  fprintf (fic, "bus departures: %u (%u early on the load threshold, %u late), average load %.2f of %u seats, "
+           "average wait of the first in line %.3f ms\n", p_d->nDep, p_d->nLoad, p_d->nLate,
+           (p_d->nDep != 0) ? (double) p_d->nPass / p_d->nDep : 0.0, p_fSt->dim.t,
+           (p_d->nDep != 0) ? (double) p_d->waitSum / p_d->nDep / MSEC : 0.0);
+  fprintf (fic, "lateness against the timetable: average %.3f ms, largest %.3f ms\n",
+           (p_d->nDep != 0) ? (double) p_d->lateSum / p_d->nDep / MSEC : 0.0, (double) p_d->lateMax / MSEC);
+  for (b = 0; b < p_fSt->dim.b; b++)
+    fprintf (fic, "bus %u: %u departures, %u passengers, average load %.2f\n", b, BUS (p_fSt, b).nDep,
+             BUS (p_fSt, b).nPass,
+             (BUS (p_fSt, b).nDep != 0) ? (double) BUS (p_fSt, b).nPass / BUS (p_fSt, b).nDep : 0.0);
+}
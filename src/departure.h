@@ -0,0 +1,124 @@
+/**
+ *  \file departure.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  \brief Scheduling the departures of the bus.
+ *
+ *  Defined operations:
+ *     \li timetable set up
+ *     \li reading the clock
+ *     \li recording the arrival of a passenger at the bus queue
+ *     \li scheduled departure time of the present ride
+ *     \li recording a departure
+ *     \li writing the departure report.
+ *
+ *  The bus leaves the arrival transfer terminal as soon as the number of queueing passengers reaches the load
+ *  threshold or, if someone is queueing, at the scheduled departure time. The timetable, given as a list of
+ *  <tt>name=value</tt> pairs separated by commas, combines
+ *     \li <tt>headway=</tt><em>ms</em> - departures are scheduled every so many milliseconds since the start of the
+ *         day; the bus leaves at the first of them since the first passenger in line queued
+ *     \li <tt>wait=</tt><em>ms</em> - the first passenger in line waits no longer than so many milliseconds
+ *     \li <tt>load=</tt><em>n</em> - the bus leaves as soon as n passengers are queueing (1 .. T)
+ *     \li <tt>slack=</tt><em>ms</em> - a departure so many milliseconds past the scheduled time is still on time.
+ *
+ *  The scheduled time is the earliest of those which apply. By default, the first passenger in line waits no longer
+ *  than <tt>DEPART_WAIT</tt> ms, the load threshold is the number of seats in the bus and the slack is
+ *  <tt>DEPART_SLACK</tt> ms, which covers the wake-up delay of the bus driver. No time may exceed <tt>DEPART_MAX</tt>
+ *  ms, and at least one of <tt>headway</tt> and <tt>wait</tt> must remain set, otherwise the last passengers of the
+ *  day might never leave.
+ *
+ *  With several buses, the timetable applies to the departures of the fleet as a whole, whichever bus is dispatched.
+ *
+ *  Every departure is compared against the scheduled time: it is on time if it is no later than the slack allows,
+ *  early if it was triggered by the load threshold, and late otherwise, for instance because the bus was still away on
+ *  the previous ride.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#ifndef DEPARTURE_H_
+#define DEPARTURE_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Timetable set up.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param spec timetable (<tt>NULL</tt> for the default one)
+ *  \param t0 start of the timetable (in ns)
+ *
+ *  \return \c true, upon success
+ *  \return \c false, if the timetable is not valid
+ */
+
+extern bool depSetup (FULL_STAT *p_fSt, char *spec, unsigned long long t0);
+
+/**
+ *  \brief Reading the clock the timetable is kept in.
+ *
+ *  \return the present time of the monotonic clock (in ns)
+ */
+
+extern unsigned long long depClock (void);
+
+/**
+ *  \brief Recording the arrival of a passenger at the bus queue.
+ *
+ *  It should be called within the bus queue critical region, right after the passenger has queued.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param id passenger identification
+ *  \param now present time (in ns)
+ *
+ *  \return \c true, if the bus driver should be told (she is the first one in line or the load threshold is reached)
+ *  \return \c false, otherwise
+ */
+
+extern bool depQueued (FULL_STAT *p_fSt, unsigned int id, unsigned long long now);
+
+/**
+ *  \brief Scheduled departure time of the present ride.
+ *
+ *  It should be called within the bus queue critical region, with someone queueing.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *
+ *  \return the scheduled departure time (in ns)
+ */
+
+extern unsigned long long depDeadline (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Recording a departure.
+ *
+ *  It should be called within the bus queue critical region, right after the passengers have been summoned from the
+ *  queue. A departure within the slack past the scheduled time is on time. If some are left behind, the next ride is
+ *  waited for since the one who is now first in line queued.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param now present time (in ns)
+ *  \param n number of passengers who board the bus
+ *  \param b bus they board
+ */
+
+extern void depDepart (FULL_STAT *p_fSt, unsigned long long now, unsigned int n, unsigned int b);
+
+/**
+ *  \brief Writing the departure report.
+ *
+ *  The departures of the whole fleet are summed up, followed by a line per bus.
+ *
+ *  \param fic file descriptor
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ */
+
+extern void depReport (FILE *fic, FULL_STAT *p_fSt);
+
+#endif /* DEPARTURE_H_ */
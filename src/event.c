@@ -0,0 +1,161 @@
+/**
+ *  \file event.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Event list management.
+ *
+ *  The event list is a priority queue of timestamped events, kept as a binary heap. Events with the same time stamp
+ *  are retrieved by order of insertion.
+ *
+ *  The following operations are defined:
+ *     \li initialization
+ *     \li insertion of an event
+ *     \li retrieval of the earliest event
+ *     \li test for event list empty
+ *     \li release of the storage.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "event.h"
+
+/**
+ *  \brief Event precedence.
+ *
+ *  \param p_a pointer to the first event
+ *  \param p_b pointer to the second event
+ *
+ *  \return \c true, if the first event is to be retrieved before the second one
+ *  \return \c false, otherwise
+ */
+
+static bool before (EVENT *p_a, EVENT *p_b)
+{
+  return (p_a->time < p_b->time) || ((p_a->time == p_b->time) && (p_a->seq < p_b->seq));
+}
+
+/**
+ *  \brief Event list initialization.
+ *
+ *         The event list will be empty after it.
+ *         The function fails if a null pointer is passed as a parameter or there is not enough memory.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *  \param size initial storage size (the storage grows as needed)
+ *
+ *  \return \c true, upon success
+ *  \return \c false, otherwise
+ */
+
+bool evInit (EVLIST *p_l, unsigned int size)
+{
+  if (p_l == NULL) return false;
+  if (size == 0) size = 1;
+  if ((p_l->mem = malloc (size * sizeof (EVENT))) == NULL) return false;
+  p_l->size = size;
+  p_l->n = 0;
+  p_l->seq = 0;
+  return true;
+}
+
+/**
+ *  \brief Insertion of an event into the event list.
+ *
+ *         The function fails if a null pointer is passed as a parameter or there is not enough memory.
+ *         Nothing is stored if the function fails.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *  \param time time of occurrence
+ *  \param ent identification of the entity the event is addressed to
+ *
+ *  \return \c true, upon success
+ *  \return \c false, otherwise
+ */
+
+bool evIn (EVLIST *p_l, unsigned long long time, unsigned int ent)
+{
+  EVENT ev;                                                                                    /* event to be stored */
+  EVENT *mem;                                                                                  /* new storage region */
+  unsigned int i;                                                                            /* position in the heap */
+
+  if (p_l == NULL) return false;
+  if (p_l->n == p_l->size)
+     { if ((mem = realloc (p_l->mem, 2 * p_l->size * sizeof (EVENT))) == NULL) return false;
+       p_l->mem = mem;
+       p_l->size *= 2;
+     }
+  ev.time = time;
+  ev.seq = p_l->seq++;
+  ev.ent = ent;
+  for (i = p_l->n++; (i > 0) && before (&ev, &(p_l->mem[(i-1)/2])); i = (i-1)/2)
+    p_l->mem[i] = p_l->mem[(i-1)/2];                                                         /* sift the parent down */
+  p_l->mem[i] = ev;
+  return true;
+}
+
+/**
+ *  \brief Retrieval of the earliest event from the event list.
+ *
+ *         The function fails if a null pointer is passed as a parameter or the event list is empty.
+ *         Nothing is retrieved if the function fails.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *  \param p_ev pointer to the location where the retrieved event is to be stored
+ */
+
+void evOut (EVLIST *p_l, EVENT *p_ev)
+{
+  EVENT last;                                                                            /* event to be repositioned */
+  unsigned int i, c;                                                                        /* positions in the heap */
+
+  if ((p_l == NULL) || (p_l->n == 0)) return;
+  *p_ev = p_l->mem[0];
+  last = p_l->mem[--p_l->n];
+  for (i = 0; (c = 2*i + 1) < p_l->n; i = c)
+  { if ((c + 1 < p_l->n) && before (&(p_l->mem[c+1]), &(p_l->mem[c]))) c += 1;           /* earliest of the children */
+    if (!before (&(p_l->mem[c]), &last)) break;
+    p_l->mem[i] = p_l->mem[c];                                                                  /* sift the child up */
+  }
+  p_l->mem[i] = last;
+}
+
+/**
+ *  \brief Test for event list empty.
+ *
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *
+ *  \return \c true, if the event list is empty
+ *  \return \c false, otherwise
+ */
+
+bool evEmpty (EVLIST *p_l)
+{
+  if (p_l == NULL) return true;
+  return (p_l->n == 0);
+}
+
+/**
+ *  \brief Release of the event list storage.
+ *
+ *         The event list can not be used afterwards unless it is initialized again.
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ */
+
+void evDestroy (EVLIST *p_l)
+{
+  if (p_l == NULL) return;
+  free (p_l->mem);
+  p_l->mem = NULL;
+  p_l->size = p_l->n = 0;
+}
@@ -0,0 +1,121 @@
+/**
+ *  \file event.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Event list management.
+ *
+ *  The event list is a priority queue of timestamped events, kept as a binary heap. Events with the same time stamp
+ *  are retrieved by order of insertion.
+ *
+ *  The following operations are defined:
+ *     \li initialization
+ *     \li insertion of an event
+ *     \li retrieval of the earliest event
+ *     \li test for event list empty
+ *     \li release of the storage.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+#include <stdbool.h>
+
+/**
+ *  \brief Definition of <em>event</em> data type.
+ */
+typedef struct
+        { /** \brief time of occurrence (in microseconds of the virtual clock) */
+          unsigned long long time;
+          /** \brief insertion order */
+          unsigned long long seq;
+          /** \brief identification of the entity the event is addressed to */
+          unsigned int ent;
+        } EVENT;
+
+/**
+ *  \brief Definition of <em>event list</em> data type.
+ */
+typedef struct
+        { /** \brief storage region (heap ordered) */
+          EVENT *mem;
+          /** \brief storage size */
+          unsigned int size;
+          /** \brief number of events in the list */
+          unsigned int n;
+          /** \brief insertion counter */
+          unsigned long long seq;
+        } EVLIST;
+
+/**
+ *  \brief Event list initialization.
+ *
+ *         The event list will be empty after it.
+ *         The function fails if a null pointer is passed as a parameter or there is not enough memory.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *  \param size initial storage size (the storage grows as needed)
+ *
+ *  \return \c true, upon success
+ *  \return \c false, otherwise
+ */
+
+extern bool evInit (EVLIST *p_l, unsigned int size);
+
+/**
+ *  \brief Insertion of an event into the event list.
+ *
+ *         The function fails if a null pointer is passed as a parameter or there is not enough memory.
+ *         Nothing is stored if the function fails.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *  \param time time of occurrence
+ *  \param ent identification of the entity the event is addressed to
+ *
+ *  \return \c true, upon success
+ *  \return \c false, otherwise
+ */
+
+extern bool evIn (EVLIST *p_l, unsigned long long time, unsigned int ent);
+
+/**
+ *  \brief Retrieval of the earliest event from the event list.
+ *
+ *         The function fails if a null pointer is passed as a parameter or the event list is empty.
+ *         Nothing is retrieved if the function fails.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *  \param p_ev pointer to the location where the retrieved event is to be stored
+ */
+
+extern void evOut (EVLIST *p_l, EVENT *p_ev);
+
+/**
+ *  \brief Test for event list empty.
+ *
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ *
+ *  \return \c true, if the event list is empty
+ *  \return \c false, otherwise
+ */
+
+extern bool evEmpty (EVLIST *p_l);
+
+/**
+ *  \brief Release of the event list storage.
+ *
+ *         The event list can not be used afterwards unless it is initialized again.
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_l pointer to the location where the event list is stored
+ */
+
+extern void evDestroy (EVLIST *p_l);
+
+#endif /* EVENT_H_ */
@@ -0,0 +1,133 @@
+/**
+ *  \file logRing.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Ring of logging records.
+ *
+ *  The following operations are defined:
+ *     \li insertion of a snapshot of the present state
+ *     \li insertion of the end of logging mark
+ *     \li retrieval of a record and writing it in the logging file.
+ *
+ *  The records are snapshots of the state. A record whose flight number is <tt>ENDREC</tt> is the end of logging mark.
+ *  Insertions are serialized by the statistics critical region and there is a single log writer, so the insertion
+ *  and the retrieval pointers are only changed by one process at a time; the semaphores <tt>logFree</tt> and
+ *  <tt>logFull</tt> count the free and the filled records.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+
+/** \brief flight number of the end of logging mark */
+#define  ENDREC       ((unsigned int) -1)
+
+/** \brief record i of the ring */
+#define  LOGREC(p_r,i)       ((SNAPSHOT *) ((char *) SHADDR (p_r, (p_r)->memOff) + (size_t) (i) * (p_r)->recSize))
+
+/**
+ *  \brief <em>Down</em> of a semaphore, which is resumed if interrupted by a signal.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sindex semaphore location in the set
+ */
+
+static void waitOn (int semgid, unsigned int sindex)
+{
+  while (semDown (semgid, sindex) == -1)
+    if (errno != EINTR)
+       { perror ("error on the down operation for a logging records semaphore");
+         exit (EXIT_FAILURE);
+       }
+}
+
+/**
+ *  \brief Insertion of a snapshot of the present full state into the ring.
+ *
+ *  It replaces <tt>saveState</tt> and must be called within the statistics critical region. The caller is only
+ *  blocked if the ring is full. Nothing is done if the state is not selected by the logging control (see
+ *  <tt>logging.h</tt>).
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param k flight number
+ *  \param who entity saving the state (passenger identification, <tt>LOGPORTER</tt>, <tt>LOGDRIVER</tt> or
+ *         <tt>LOGSUMMARY</tt>)
+ */
+
+void logRingPut (int semgid, SHARED_DATA *sh, unsigned int k, unsigned int who)
+{
+  if (!logSample (&(sh->fSt), who)) return;                                                /* the state is skipped */
+  waitOn (semgid, sh->logFree);                                                            /* wait for a free record */
+  takeSnapshot (k, &(sh->fSt), LOGREC (&(sh->log), sh->log.ii));
+  sh->log.ii = (sh->log.ii + 1) % sh->log.size;
+  if (semUp (semgid, sh->logFull) == -1)                                                   /* signal a filled record */
+     { perror ("error on the up operation for semaphore logFull");
+       exit (EXIT_FAILURE);
+     }
+}
+
+/**
+ *  \brief Insertion of the end of logging mark into the ring.
+ *
+ *  It must be called once, after all the intervening entities have terminated.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ */
+
+void logRingEnd (int semgid, SHARED_DATA *sh)
+{
+  waitOn (semgid, sh->logFree);                                                            /* wait for a free record */
+  LOGREC (&(sh->log), sh->log.ii)->k = ENDREC;
+  sh->log.ii = (sh->log.ii + 1) % sh->log.size;
+  if (semUp (semgid, sh->logFull) == -1)                                                   /* signal a filled record */
+     { perror ("error on the up operation for semaphore logFull");
+       exit (EXIT_FAILURE);
+     }
+}
+
+/**
+ *  \brief Retrieval of a record from the ring and writing it in the logging file.
+ *
+ *  The caller is blocked while the ring is empty.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param fic file descriptor of the logging file (opened for appending)
+ *  \param fmt format of the logging file (see <tt>logSink.h</tt>)
+ *
+ *  \return \c true, if a snapshot of the state was written
+ *  \return \c false, if the end of logging mark was retrieved
+ */
+
+bool logRingGet (int semgid, SHARED_DATA *sh, FILE *fic, int fmt)
+{
+  SNAPSHOT *rec;                                                                                   /* present record */
+  bool more;                                                                         /* it is not the end of logging */
+
+  waitOn (semgid, sh->logFull);                                                          /* wait for a filled record */
+  rec = LOGREC (&(sh->log), sh->log.ri);
+  if ((more = (rec->k != ENDREC)))
+     writeSnapshot (fic, &(sh->fSt.dim), rec, fmt);
+  sh->log.ri = (sh->log.ri + 1) % sh->log.size;
+  if (semUp (semgid, sh->logFree) == -1)                                                     /* signal a free record */
+     { perror ("error on the up operation for semaphore logFree");
+       exit (EXIT_FAILURE);
+     }
+  return more;
+}
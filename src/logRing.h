@@ -0,0 +1,75 @@
+/**
+ *  \file logRing.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Ring of logging records.
+ *
+ *  The intervening entities do not write the logging file themselves: they take a snapshot of the state into the
+ *  ring, kept in the shared region, and go on. A log writer drains the ring and writes the snapshots in the logging
+ *  file, which is kept open along the whole simulation.
+ *
+ *  The following operations are defined:
+ *     \li insertion of a snapshot of the present state
+ *     \li insertion of the end of logging mark
+ *     \li retrieval of a record and writing it in the logging file.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#ifndef LOGRING_H_
+#define LOGRING_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Insertion of a snapshot of the present full state into the ring.
+ *
+ *  It replaces <tt>saveState</tt> and must be called within the statistics critical region. The caller is only
+ *  blocked if the ring is full. Nothing is done if the state is not selected by the logging control (see
+ *  <tt>logging.h</tt>).
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param k flight number
+ *  \param who entity saving the state (passenger identification, <tt>LOGPORTER</tt>, <tt>LOGDRIVER</tt> or
+ *         <tt>LOGSUMMARY</tt>)
+ */
+
+extern void logRingPut (int semgid, SHARED_DATA *sh, unsigned int k, unsigned int who);
+
+/**
+ *  \brief Insertion of the end of logging mark into the ring.
+ *
+ *  It must be called once, after all the intervening entities have terminated.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ */
+
+extern void logRingEnd (int semgid, SHARED_DATA *sh);
+
+/**
+ *  \brief Retrieval of a record from the ring and writing it in the logging file.
+ *
+ *  The caller is blocked while the ring is empty.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param fic file descriptor of the logging file (opened for appending)
+ *  \param fmt format of the logging file (see <tt>logSink.h</tt>)
+ *
+ *  \return \c true, if a snapshot of the state was written
+ *  \return \c false, if the end of logging mark was retrieved
+ */
+
+extern bool logRingGet (int semgid, SHARED_DATA *sh, FILE *fic, int fmt);
+
+#endif /* LOGRING_H_ */
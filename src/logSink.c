@@ -0,0 +1,268 @@
+/**
+ *  \file logSink.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  \brief Destination of the logging output.
+ *
+ *  The following operations are defined:
+ *     \li reading of the overwrite policy
+ *     \li choice of the sink name
+ *     \li resolution of the sink name
+ *     \li naming the sink of one of several instances
+ *     \li checking the format of the sink
+ *     \li opening of the sink
+ *     \li closing of the sink.
+ *
+ *  A <tt>fd:</tt> sink is opened on a duplicate of the inherited file descriptor, which shares the file offset with
+ *  it: output of different processes is thus appended in the order the buffers are flushed.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "logSink.h"
+
+/** \brief size of the output buffer */
+#define  SINKBUF      (1 << 20)
+
+/** \brief prefix of the name of a sink in binary format */
+#define  BINPFX       "bin:"
+
+/** \brief prefix of the name of a sink in event format */
+#define  EVPFX        "ev:"
+
+/**
+ *  \brief Stripping the format prefix off the sink name.
+ *
+ *  \param nFic name of the logging file
+ *
+ *  \return name of the sink proper
+ */
+
+static char *sinkName (char *nFic)
+{
+  if (nFic != NULL)
+     { if (strncmp (nFic, BINPFX, strlen (BINPFX)) == 0)
+          return nFic + strlen (BINPFX);
+       if (strncmp (nFic, EVPFX, strlen (EVPFX)) == 0)
+          return nFic + strlen (EVPFX);
+     }
+  return nFic;
+}
+
+/**
+ *  \brief Reading of the overwrite policy.
+ *
+ *  \param arg name of the policy (<tt>ask</tt>, <tt>yes</tt> or <tt>no</tt>)
+ *
+ *  \return \c OVW_ASK, \c OVW_YES or \c OVW_NO, upon success
+ *  \return -1, if there is no policy under that name
+ */
+
+int sinkPolicy (char *arg)
+{
+  if (strcmp (arg, "ask") == 0)
+     return OVW_ASK;
+  if (strcmp (arg, "yes") == 0)
+     return OVW_YES;
+  if (strcmp (arg, "no") == 0)
+     return OVW_NO;
+  return -1;
+}
+
+/**
+ *  \brief Choice of the sink name.
+ *
+ *  The name is the one given on the command line or, if there is none, the one the user types in. A regular file
+ *  which is already there is overwritten, or not, as the policy says: if the user is to be asked and refuses, she is
+ *  asked for another name, unless it was given on the command line. It must be called once by the generator, before
+ *  <tt>sinkSetup</tt>.
+ *
+ *  \param nFic location where the name of the logging file is to be stored (at least 51 characters long)
+ *  \param given name given on the command line (\c NULL, if there is none; at most <tt>SINKNAME</tt> characters long)
+ *  \param policy overwrite policy
+ *
+ *  \return \c true, upon success
+ *  \return \c false, if no name could be chosen
+ */
+
+bool sinkChoose (char *nFic, char *given, int policy)
+{
+  char *fName;                                                                                   /* sink name proper */
+  FILE *fic;                                                                                      /* file descriptor */
+  int t;                                                                               /* keyboard reading test flag */
+  char opt;                                                                                                /* answer */
+
+  while (true)
+  { if (given != NULL)
+       { if (strlen (given) > SINKNAME)
+            { fprintf (stderr, "the name of the logging file is too long (at most %d characters)\n", SINKNAME);
+              return false;
+            }
+         strcpy (nFic, given);
+       }
+       else do
+            { printf ("\nLog file name? ");
+              t = scanf ("%30[^\n]", nFic);
+              scanf ("%*[^\n]");
+              scanf ("%*c");
+              if (t == EOF) return false;
+            } while (t == 0);
+    fName = sinkName (nFic);
+    if ((strcmp (fName, "null") == 0) || (strcmp (fName, "-") == 0) || (strcmp (fName, "mem:") == 0) ||
+        (strncmp (fName, "fd:", 3) == 0) || ((fic = fopen ((strcmp (fName, "") == 0) ? "log" : fName, "r")) == NULL))
+       return true;                                                                 /* there is no file to overwrite */
+    fclose (fic);
+    if (policy == OVW_YES)
+       return true;
+    if (policy == OVW_NO)
+       { fprintf (stderr, "there is already a file with this name: %s\n", nFic);
+         if (given != NULL) return false;
+         continue;
+       }
+    printf ("There is already a file with this name! ");
+    do
+    { printf ("Overwrite? ");
+      if (scanf ("%c", &opt) != 1) return false;
+      if (opt != '\n')
+         { scanf ("%*[^\n]");
+           scanf ("%*c");
+         }
+    } while ((opt == '\n') || ((opt != 'Y') && (opt != 'y') && (opt != 'N') && (opt != 'n')));
+    if ((opt == 'Y') || (opt == 'y'))
+       return true;
+    if (given != NULL)
+       return false;
+  }
+}
+
+/**
+ *  \brief Resolution of the sink name.
+ *
+ *  The in memory sink is created and it and the standard output are converted to the <tt>fd:</tt> form. It must be
+ *  called once by the generator, before the logging file is created.
+ *
+ *  \param nFic name of the logging file (it is rewritten in place, at least 21 characters long)
+ */
+
+void sinkSetup (char *nFic)
+{
+  int fd;                                                                                         /* file descriptor */
+
+  nFic = sinkName (nFic);
+  if (strcmp (nFic, "-") == 0)
+     sprintf (nFic, "fd:%d", STDOUT_FILENO);
+     else if (strcmp (nFic, "mem:") == 0)
+             { if ((fd = memfd_create ("airport.log", 0)) == -1)
+                  { perror ("error on creating the in memory logging file");
+                    exit (EXIT_FAILURE);
+                  }
+               sprintf (nFic, "fd:%d", fd);
+             }
+}
+
+/**
+ *  \brief Naming the sink of one of several instances.
+ *
+ *  When several airports are run side by side, each one has a logging file of its own: a regular file is given the
+ *  instance number as a suffix (<em>name</em><tt>.</tt><em>i</em>), while the other sinks are left as they are. It
+ *  should be called before <tt>sinkSetup</tt>, so that each instance gets an in memory file of its own.
+ *
+ *  \param nFic name of the logging file (it is rewritten in place, at least 51 characters long)
+ *  \param i instance number
+ */
+
+void sinkInstance (char *nFic, unsigned int i)
+{
+  char *fName = sinkName (nFic);                                                                 /* sink name proper */
+
+  if ((strcmp (fName, "null") == 0) || (strcmp (fName, "-") == 0) || (strcmp (fName, "mem:") == 0) ||
+      (strncmp (fName, "fd:", 3) == 0))
+     return;
+  if (strcmp (fName, "") == 0)
+     sprintf (fName, "log.%u", i);
+     else sprintf (fName + strlen (fName), ".%u", i);
+}
+
+/**
+ *  \brief Checking the format of the sink.
+ *
+ *  \param nFic name of the logging file
+ *
+ *  \return \c FMTTEXT, \c FMTBIN or \c FMTEVENT
+ */
+
+int sinkFormat (char *nFic)
+{
+  if ((nFic != NULL) && (strncmp (nFic, BINPFX, strlen (BINPFX)) == 0))
+     return FMTBIN;
+  if ((nFic != NULL) && (strncmp (nFic, EVPFX, strlen (EVPFX)) == 0))
+     return FMTEVENT;
+  return FMTTEXT;
+}
+
+/**
+ *  \brief Opening of the sink.
+ *
+ *  \param nFic name of the logging file
+ *  \param create \c true, if the sink is being created (a regular file is truncated); \c false, if output is to be
+ *         appended
+ *
+ *  \return file descriptor, upon success
+ *  \return \c NULL, if it is the null sink
+ */
+
+FILE *sinkOpen (char *nFic, bool create)
+{
+  FILE *fic;                                                                                      /* file descriptor */
+  char *fName;                                                                                      /* log file name */
+  int fd;                                                                               /* inherited file descriptor */
+
+  nFic = sinkName (nFic);
+  fName = ((nFic == NULL) || (strcmp (nFic, "") == 0)) ? "log" : nFic;
+  if (strcmp (fName, "null") == 0)
+     return NULL;
+  if (strncmp (fName, "fd:", 3) == 0)
+     { fd = atoi (fName + 3);
+       if ((fd = dup (fd)) == -1)
+          { perror ("error on duplicating the logging file descriptor");
+            exit (EXIT_FAILURE);
+          }
+       fic = fdopen (fd, "a");
+     }
+     else fic = fopen (fName, create ? "w" : "a");
+  if (fic == NULL)
+     { perror ("error on opening the log file");
+       exit (EXIT_FAILURE);
+     }
+  setvbuf (fic, NULL, _IOFBF, SINKBUF);
+  return fic;
+}
+
+/**
+ *  \brief Closing of the sink.
+ *
+ *  The buffer is flushed. The inherited file descriptor of a <tt>fd:</tt> sink is left open.
+ *
+ *  \param fic file descriptor (\c NULL, if it is the null sink)
+ */
+
+void sinkClose (FILE *fic)
+{
+  if (fic == NULL) return;
+  if (fclose (fic) == EOF)
+     { perror ("error on closing the log file");
+       exit (EXIT_FAILURE);
+     }
+}
@@ -0,0 +1,156 @@
+/**
+ *  \file logSink.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  \brief Destination of the logging output.
+ *
+ *  The name of the logging file given to the generator selects the sink:
+ *     \li <tt>null</tt> - the output is discarded
+ *     \li <tt>-</tt> - the output is written to the standard output (which may be a pipe)
+ *     \li <tt>mem:</tt> - the output is written to an anonymous file in memory (memfd)
+ *     \li <tt>fd:</tt><em>n</em> - the output is written to the inherited file descriptor <em>n</em>
+ *     \li any other name - the output is written to a regular file under that name (<em>log</em>, if it is empty).
+ *
+ *  Any of these names may be preceded by <tt>bin:</tt>, in which case the states are written as fixed-size binary
+ *  records, or by <tt>ev:</tt>, in which case only the transitions from one state to the next are recorded (see
+ *  <tt>logging.h</tt>). Both formats are converted back to text by <tt>logdump</tt>.
+ *
+ *  The name is either given to the generator on the command line or typed in by the user, and a regular file which is
+ *  already there is overwritten as the <em>overwrite policy</em> says: the user is asked (<tt>ask</tt>), it is
+ *  overwritten (<tt>yes</tt>) or the name is refused (<tt>no</tt>).
+ *
+ *  The generator resolves the name before creating the intervening entities: sinks which are not named in the file
+ *  system are converted to the <tt>fd:</tt> form, so that the processes launched afterwards inherit them.
+ *
+ *  Every sink is opened once and written through a large buffer, so a single <tt>write</tt> is issued for many
+ *  states.
+ *
+ *  The following operations are defined:
+ *     \li reading of the overwrite policy
+ *     \li choice of the sink name
+ *     \li resolution of the sink name
+ *     \li naming the sink of one of several instances
+ *     \li checking the format of the sink
+ *     \li opening of the sink
+ *     \li closing of the sink.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#ifndef LOGSINK_H_
+#define LOGSINK_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/** \brief the states are written as text lines */
+#define  FMTTEXT      0
+
+/** \brief the states are written as fixed-size binary records */
+#define  FMTBIN       1
+
+/** \brief the transitions between states are written as binary records */
+#define  FMTEVENT     2
+
+/** \brief longest name of the logging file which may be given */
+#define  SINKNAME     30
+
+/** \brief the user is asked whether a file which is already there is to be overwritten */
+#define  OVW_ASK      0
+
+/** \brief a file which is already there is overwritten */
+#define  OVW_YES      1
+
+/** \brief a file which is already there is kept, its name being refused */
+#define  OVW_NO       2
+
+/**
+ *  \brief Reading of the overwrite policy.
+ *
+ *  \param arg name of the policy (<tt>ask</tt>, <tt>yes</tt> or <tt>no</tt>)
+ *
+ *  \return \c OVW_ASK, \c OVW_YES or \c OVW_NO, upon success
+ *  \return -1, if there is no policy under that name
+ */
+
+extern int sinkPolicy (char *arg);
+
+/**
+ *  \brief Choice of the sink name.
+ *
+ *  The name is the one given on the command line or, if there is none, the one the user types in. A regular file
+ *  which is already there is overwritten, or not, as the policy says: if the user is to be asked and refuses, she is
+ *  asked for another name, unless it was given on the command line. It must be called once by the generator, before
+ *  <tt>sinkSetup</tt>.
+ *
+ *  \param nFic location where the name of the logging file is to be stored (at least 51 characters long)
+ *  \param given name given on the command line (\c NULL, if there is none; at most <tt>SINKNAME</tt> characters long)
+ *  \param policy overwrite policy
+ *
+ *  \return \c true, upon success
+ *  \return \c false, if no name could be chosen
+ */
+
+extern bool sinkChoose (char *nFic, char *given, int policy);
+
+/**
+ *  \brief Resolution of the sink name.
+ *
+ *  The in memory sink is created and it and the standard output are converted to the <tt>fd:</tt> form. It must be
+ *  called once by the generator, before the logging file is created.
+ *
+ *  \param nFic name of the logging file (it is rewritten in place, at least 21 characters long)
+ */
+
+extern void sinkSetup (char *nFic);
+
+/**
+ *  \brief Naming the sink of one of several instances.
+ *
+ *  When several airports are run side by side, each one has a logging file of its own: a regular file is given the
+ *  instance number as a suffix (<em>name</em><tt>.</tt><em>i</em>), while the other sinks are left as they are. It
+ *  should be called before <tt>sinkSetup</tt>, so that each instance gets an in memory file of its own.
+ *
+ *  \param nFic name of the logging file (it is rewritten in place, at least 51 characters long)
+ *  \param i instance number
+ */
+
+extern void sinkInstance (char *nFic, unsigned int i);
+
+/**
+ *  \brief Checking the format of the sink.
+ *
+ *  \param nFic name of the logging file
+ *
+ *  \return \c FMTTEXT, \c FMTBIN or \c FMTEVENT
+ */
+
+extern int sinkFormat (char *nFic);
+
+/**
+ *  \brief Opening of the sink.
+ *
+ *  \param nFic name of the logging file
+ *  \param create \c true, if the sink is being created (a regular file is truncated); \c false, if output is to be
+ *         appended
+ *
+ *  \return file descriptor, upon success
+ *  \return \c NULL, if it is the null sink
+ */
+
+extern FILE *sinkOpen (char *nFic, bool create);
+
+/**
+ *  \brief Closing of the sink.
+ *
+ *  The buffer is flushed. The inherited file descriptor of a <tt>fd:</tt> sink is left open.
+ *
+ *  \param fic file descriptor (\c NULL, if it is the null sink)
+ */
+
+extern void sinkClose (FILE *fic);
+
+#endif /* LOGSINK_H_ */
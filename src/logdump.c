@@ -0,0 +1,87 @@
+/**
+ *  \file logdump.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Conversion of a logging file in binary or event format into the text layout.
+ *
+ *  Usage: <tt>logdump</tt> <em>binary logging file</em> [<em>text logging file</em>]
+ *
+ *  The text is written to the standard output, if no text logging file is named. It is the same the simulation would
+ *  have written had the logging file been requested in text format. For a logging file in event format, the full
+ *  state is reconstructed by applying in turn the transitions which were recorded.
+ *
+ *  \author António Rui Borges - November 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "logSink.h"
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+  FILE *fin,                                                                       /* binary logging file descriptor */
+       *fout;                                                                        /* text logging file descriptor */
+  DIM dim;                                                                                     /* problem dimensions */
+  SNAPSHOT *snap;                                                                           /* snapshot of the state */
+  REPORT rep;                                                                                        /* final report */
+  int fmt,                                                                             /* format of the logging file */
+      stat;                                                                                   /* kind of record read */
+
+  /* validation of command line parameters */
+
+  if ((argc != 2) && (argc != 3))
+     { fprintf (stderr, "usage: %s binary_log [text_log]\n", argv[0]);
+       return EXIT_FAILURE;
+     }
+  if ((fin = fopen (argv[1], "r")) == NULL)
+     { perror ("error on opening the binary logging file");
+       return EXIT_FAILURE;
+     }
+  if ((fmt = readHeader (fin, &dim)) == FMTTEXT)
+     { fprintf (stderr, "%s is not a logging file in binary or event format\n", argv[1]);
+       return EXIT_FAILURE;
+     }
+  if (argc == 2)
+     fout = stdout;
+     else if ((fout = fopen (argv[2], "w")) == NULL)
+             { perror ("error on creating the text logging file");
+               return EXIT_FAILURE;
+             }
+  if ((snap = calloc (1, snapSize (&dim))) == NULL)
+     { perror ("error on allocating the snapshot of the state");
+       return EXIT_FAILURE;
+     }
+
+  /* conversion of the records */
+
+  writeHeader (fout, &dim);
+  while ((stat = (fmt == FMTBIN) ? readRecord (fin, &dim, snap, &rep) : readEvents (fin, &dim, snap, &rep)) != RECEND)
+    if (stat == RECSTATE)
+       writeSnapshot (fout, &dim, snap, FMTTEXT);
+       else if (stat == RECREPORT)
+               writeReport (fout, &rep);
+               else { fprintf (stderr, "%s is truncated or corrupted\n", argv[1]);
+                      return EXIT_FAILURE;
+                    }
+
+  free (snap);
+  fclose (fin);
+  if (fclose (fout) == EOF)
+     { perror ("error on closing the text logging file");
+       return EXIT_FAILURE;
+     }
+
+  return EXIT_SUCCESS;
+}
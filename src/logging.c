@@ -10,18 +10,206 @@
  *  Defined operations:
  *     \li file initialization
  *     \li writing the present state as a single line at the end of the file
- *     \li writing final report.
+ *     \li taking a snapshot of the present state and writing it later on
+ *     \li writing final report
+ *     \li reading back a logging file in binary format
+ *     \li selection of the states to be saved.
+ *
+ *  The output goes to the sink selected by the name of the logging file (see <tt>logSink.h</tt>). The sink used by
+ *  <tt>saveState</tt> is opened on the first call and kept open until the final report is written.
+ *
+ *  In binary and event formats, the text lines are replaced by the records described in <tt>logging.h</tt>, which
+ *  are assembled in a buffer and written in a single operation. In event format, the state last written by the
+ *  process is kept so that only the fields which have changed since are recorded.
  *
  *  \author António Rui Borges - November 2013
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "queue.h"
+#include "logging.h"
+#include "logSink.h"
+
+/** \brief transition record: end of the transitions to the next state */
+#define  EVEND        0
+
+/** \brief transition record: plane landing number (16 bits) */
+#define  EVFLIGHT     1
+
+/** \brief transition record: number of pieces of luggage in the plane's hold (16 bits) */
+#define  EVHOLD       2
+
+/** \brief transition record: state of the porter (8 bits) */
+#define  EVPORTER     3
+
+/** \brief transition record: conveyor belt and the number of pieces of luggage on it (8 + 16 bits) */
+#define  EVBELT       4
+
+/** \brief transition record: number of pieces of luggage in the storeroom (16 bits) */
+#define  EVSTORE      5
+
+/** \brief transition record: bus and the state of its driver (8 + 8 bits) */
+#define  EVDRIVER     6
+
+/** \brief transition record: number of identifications retrieved from the head of the queue (16 bits) */
+#define  EVQOUT       7
+
+/** \brief transition record: identification inserted at the tail of the queue (16 bits) */
+#define  EVQIN        8
+
+/** \brief transition record: seat, counted over the buses in turn, and the identification of its occupant (16 + 16
+ *  bits) */
+#define  EVSEAT       9
+
+/** \brief transition record: passenger, her state and situation and her pieces of luggage (16 + 8 + 8 + 8 bits) */
+#define  EVPASS       10
+
+/** \brief transition record: final report (5 x 32 bits) */
+#define  EVREPORT     11
+
+/** \brief size of the fields of the transition records */
+static const unsigned int evSize[] = { 0, 2, 2, 1, 3, 2, 2, 2, 2, 4, 5, 20 };
+
+/** \brief abbreviations of the states of the bus driver */
+static const char *driverName[] = { "PAAT", "DRFW", "PADT", "DRBW" };
+
+/** \brief size of the header of a logging file in binary format */
+#define  HEADSIZE     (4 + 6 * 4)
+
+/** \brief size of the final report record of a logging file in binary format */
+#define  REPSIZE      (2 + 5 * 4)
+
+/** \brief empty queue position or seat in a logging file in binary format */
+#define  RECEMPTY     0xFFFF
+
+/** \brief sink of the states saved by this process (it is open if stateSnap is not a null pointer) */
+static FILE *stateFic = NULL;
+
+/** \brief snapshot buffer of the states saved by this process */
+static SNAPSHOT *stateSnap = NULL;
+
+/** \brief format of the states saved by this process */
+static int stateFmt;
+
+/** \brief last state written in event format by this process (a null pointer, if none was written yet) */
+static SNAPSHOT *evPrev = NULL;
+
+/** \brief record buffer of a logging file in binary format */
+static unsigned char *recBuf = NULL;
+
+/** \brief size of the record buffer */
+static size_t recBufSize = 0;
+
+/**
+ *  \brief Getting a record buffer of at least a given size.
+ *
+ *  \param size required size (in bytes)
+ *
+ *  \return pointer to the buffer
+ */
+
+static unsigned char *recBuffer (size_t size)
+{
+  if (size > recBufSize)
+     { if ((recBuf = realloc (recBuf, size)) == NULL)
+          { perror ("error on allocating the record buffer");
+            exit (EXIT_FAILURE);
+          }
+       recBufSize = size;
+     }
+  return recBuf;
+}
+
+/**
+ *  \brief Storing a 16 bits field of a binary record.
+ *
+ *  \param q pointer to the location of the field
+ *  \param val field value
+ *
+ *  \return pointer to the location of the next field
+ */
+
+static unsigned char *put16 (unsigned char *q, unsigned int val)
+{
+  q[0] = val & 0xFF;
+  q[1] = (val >> 8) & 0xFF;
+  return q + 2;
+}
+
+/**
+ *  \brief Storing a 32 bits field of a binary record.
+ *
+ *  \param q pointer to the location of the field
+ *  \param val field value
+ *
+ *  \return pointer to the location of the next field
+ */
+
+static unsigned char *put32 (unsigned char *q, unsigned int val)
+{
+  return put16 (put16 (q, val & 0xFFFF), val >> 16);
+}
+
+/**
+ *  \brief Fetching a 16 bits field of a binary record.
+ *
+ *  \param p_q pointer to the location of the field pointer (it is moved to the next field)
+ *
+ *  \return field value
+ */
+
+static unsigned int get16 (unsigned char **p_q)
+{
+  unsigned int val;                                                                                   /* field value */
+
+  val = (*p_q)[0] | ((*p_q)[1] << 8);
+  *p_q += 2;
+  return val;
+}
+
+/**
+ *  \brief Fetching a 32 bits field of a binary record.
+ *
+ *  \param p_q pointer to the location of the field pointer (it is moved to the next field)
+ *
+ *  \return field value
+ */
+
+static unsigned int get32 (unsigned char **p_q)
+{
+  unsigned int val;                                                                                   /* field value */
+
+  val = get16 (p_q);
+  return val | (get16 (p_q) << 16);
+}
+
+/**
+ *  \brief Number of decimal digits of a value.
+ *
+ *  It sets the width of the columns of the text format which are labelled by an index, so that they line up with the
+ *  labels once the index has more than one digit.
+ *
+ *  \param val value
+ *
+ *  \return number of digits
+ */
+
+static unsigned int digits (unsigned int val)
+{
+  unsigned int n = 1;                                                                            /* number of digits */
+
+  while (val >= 10)
+  { val /= 10;
+    n += 1;
+  }
+  return n;
+}
 
 /**
  *  \brief File initialization.
@@ -29,70 +217,307 @@
  *  The function creates the logging file and writes its header.
  *  If <tt>nFic</tt> is a null pointer or a null string, the file is created under a predefined name <em>log</em>.
  *
+ *  In binary and event formats, the binary header is written instead. The program terminates if the problem dimensions
+ *  do not fit in the fields of the records.
+ *
  *  The header consists of
  *       \li a line title
  *       \li a blank line
  *       \li a quad line describing the meaning of the different fields of the state lines.
  *
  *  \param nFic name of the logging file
+ *  \param p_dim pointer to the location where the problem dimensions are stored
  */
 
-void createLog (char *nFic)
+void createLog (char *nFic, DIM *p_dim)
 {
   FILE *fic;                                                                                      /* file descriptor */
-  char *dName = "log",                                                                      /* default log file name */
-       *fName;                                                                                      /* log file name */
-
-  if ((nFic == NULL) || (strcmp (nFic, "") == 0))
-     fName = dName;
-     else fName = nFic;
-  if ((fic = fopen (fName, "w")) == NULL)
-     { perror ("error on the creation of log file");
+  unsigned char head[HEADSIZE];                                                                     /* binary header */
+
+  if ((sinkFormat (nFic) != FMTTEXT) &&
+      ((p_dim->m > 0xFF) || ((unsigned long long) p_dim->k * p_dim->n * p_dim->m >= RECEMPTY) ||
+       (p_dim->b > 0xFF) || ((unsigned long long) p_dim->b * p_dim->t >= RECEMPTY) || (p_dim->c > 0xFF)))
+     { fprintf (stderr, "the problem dimensions are too large for the binary logging format\n");
        exit (EXIT_FAILURE);
      }
+  if ((fic = sinkOpen (nFic, true)) == NULL) return;
+  if (sinkFormat (nFic) != FMTTEXT)
+     { memcpy (head, (sinkFormat (nFic) == FMTBIN) ? LOGMAGIC : EVMAGIC, 4);
+       put32 (put32 (put32 (put32 (put32 (put32 (head + 4, p_dim->k), p_dim->n), p_dim->m), p_dim->t), p_dim->b),
+              p_dim->c);
+       fwrite (head, HEADSIZE, 1, fic);
+     }
+     else writeHeader (fic, p_dim);
+  sinkClose (fic);
+}
+
+/**
+ *  \brief Writing the text header of the logging file.
+ *
+ *  With a single bus and a single conveyor belt, the original layout is kept: the driver state comes before the bus
+ *  queue. Otherwise, every conveyor belt has a column of its own and every bus a group, its driver state followed by
+ *  its seats, after the bus queue.
+ *
+ *  \param fic file descriptor of the logging file
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ */
+
+void writeHeader (FILE *fic, DIM *p_dim)
+{
+  unsigned int b, c, i;                                                                        /* counting variables */
+  unsigned int dc = digits (p_dim->c),                                           /* widest index of a conveyor belt */
+               dq = digits (p_dim->n),                                   /* widest index of a place in the bus queue */
+               ds = digits (p_dim->t) + 1,                                       /* widest label of a seat in the bus */
+               wq = dq + 2,                                                     /* width of a column of the bus queue */
+               ws = (ds + 1 > wq - 1) ? ds + 1 : wq - 1;                     /* width of a column of the bus seats */
+
   fprintf (fic, "%15cAIRPORT RHAPSODY - Description of the internal state of the problem\n\n", ' ');
-  fprintf (fic, "PLANE    PORTER                  DRIVER\n");
-  fprintf (fic, "FN BN  Stat CB SR   Stat  Q1 Q2 Q3 Q4 Q5 Q6  S1 S2 S3\n");
-  fprintf (fic, "%43c              PASSENGERS\n", ' ');
-  fprintf (fic, "St1 Si1 NR1 NA1 St2 Si2 NR2 NA2 St3 Si3 NR3 NA3 St4 Si4 NR4 NA4 St5 Si5 NR5 NA5 ");
-  fprintf (fic, "St6 Si6 NR6 NA6\n");
-  if (fclose (fic) == EOF)
-     { perror ("error on closing the log file");
-       exit (EXIT_FAILURE);
+  if ((p_dim->b == 1) && (p_dim->c == 1))
+     { fprintf (fic, "PLANE    PORTER                  DRIVER\n");
+       fprintf (fic, "FN BN  Stat CB SR   Stat ");
+       for (i = 0; i < p_dim->n; i++)
+         fprintf (fic, " Q%-*u", dq, i + 1);
+       fprintf (fic, " ");
+       for (i = 0; i < p_dim->t; i++)
+         fprintf (fic, "%*cS%-*u", ws - ds, ' ', ds - 1, i + 1);
      }
+     else { fprintf (fic, "PLANE    PORTER%*c", (dc + 2) * p_dim->c + wq * p_dim->n, ' ');
+            for (b = 0; b < p_dim->b; b++)
+              fprintf (fic, "  BUS %-*u", (b + 1 < p_dim->b) ? ws * p_dim->t : 1, b + 1);
+            fprintf (fic, "\n");
+            fprintf (fic, "FN BN  Stat ");
+            for (c = 0; c < p_dim->c; c++)
+              if (p_dim->c == 1)
+                 fprintf (fic, "CB ");
+                 else fprintf (fic, "C%-*u ", dc, c + 1);
+            fprintf (fic, "SR ");
+            for (i = 0; i < p_dim->n; i++)
+              fprintf (fic, " Q%-*u", dq, i + 1);
+            for (b = 0; b < p_dim->b; b++)
+            { fprintf (fic, "  Stat");
+              for (i = 0; i < p_dim->t; i++)
+                fprintf (fic, "%*cS%-*u", ws - ds, ' ', ds - 1, i + 1);
+            }
+          }
+  fprintf (fic, "\n");
+  fprintf (fic, "%43c              PASSENGERS\n", ' ');
+  for (i = 0; i < p_dim->n; i++)
+    fprintf (fic, "%sSt%-*u Si%-*u NR%-*u NA%-*u", (i == 0) ? "" : " ", dq, i + 1, dq, i + 1, dq, i + 1, dq, i + 1);
+  fprintf (fic, "\n");
 }
 
 /**
- *  \brief Writing the present full state as a double line at the end of the file.
+ *  \brief Size of a snapshot of the state.
  *
- *  If <tt>nFic</tt> is a null pointer or a null string, the lines are appended to a file under the predefined
- *  name <em>log</em>.
+ *  \param p_dim pointer to the location where the problem dimensions are stored
  *
- *  The following layout is obeyed for the full state in a double line
- *      \li plane, porter, driver, queue and bus state
- *      \li passengers state (p = 0,..., N-1).
+ *  \return size of a snapshot (in bytes)
+ */
+
+size_t snapSize (DIM *p_dim)
+{
+  return sizeof (SNAPSHOT) + ((size_t) p_dim->n + (size_t) p_dim->b * (p_dim->t + 1) + p_dim->c) * sizeof (int)
+         + (size_t) p_dim->n * sizeof (STAT_PASSENGER);
+}
+
+/**
+ *  \brief Size of a state record of a logging file in binary format.
+ *
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *
+ *  \return size of a record (in bytes)
+ */
+
+size_t binRecSize (DIM *p_dim)
+{
+  return 7 + p_dim->b + 2 * (p_dim->c + p_dim->n + p_dim->b * p_dim->t) + 3 * p_dim->n;
+}
+
+/**
+ *  \brief Taking a snapshot of the present full state.
  *
- *  \param nFic name of the logging file
  *  \param k flight number
  *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param p_snap pointer to the location where the snapshot is to be stored (at least <tt>snapSize</tt> bytes long)
  */
 
-void saveState (char *nFic, unsigned int k, FULL_STAT* p_fSt)
+void takeSnapshot (unsigned int k, FULL_STAT* p_fSt, SNAPSHOT *p_snap)
 {
-  FILE *fic;                                                                          /* file descriptor */
-  char *dName = "log",                                                          /* default log file name */
-       *fName;                                                                          /* log file name */
-  unsigned int p, i;                                                               /* counting variables */
-
-  if ((nFic == NULL) || (strcmp (nFic, "") == 0))
-     fName = dName;
-     else fName = nFic;
-  if ((fic = fopen (fName, "a")) == NULL)
-     { perror ("error on opening for appending the log file");
+  unsigned int p, b, c, i, id;                                             /* counting variables and passenger id */
+  QUEUEIT it;                                                                               /* bus queue iterator */
+
+  p_snap->k = k;
+  p_snap->nBags = PLHOLD (p_fSt, k).nBags;
+  p_snap->porterStat = p_fSt->st.porterStat;
+  for (c = 0; c < p_fSt->dim.c; c++)
+    SNAPBELT (p_snap, &(p_fSt->dim), c) = BELT (p_fSt, c).n;
+  p_snap->nSR = p_fSt->nToTBagsPSR;
+  queueIterInit (&(p_fSt->busQueue), &it);                                     /* one pass over the queued ids */
+  for (i = 0; (i < p_fSt->dim.n) && queueIterNext (&it, &id); i++)
+    SNAPQUEUE (p_snap, i) = (int) id;
+  for (; i < p_fSt->dim.n; i++)
+    SNAPQUEUE (p_snap, i) = EMPTYPOS;
+  for (b = 0; b < p_fSt->dim.b; b++)
+  { for (i = 0; i < p_fSt->dim.t; i++)
+      SNAPSEAT (p_snap, &(p_fSt->dim), b, i) = SEAT (&BUS (p_fSt, b), i);
+    SNAPDRIVER (p_snap, &(p_fSt->dim), b) = BUS (p_fSt, b).driverStat;
+  }
+  for (p = 0; p < p_fSt->dim.n; p++)
+    SNAPPASS (p_snap, &(p_fSt->dim), p) = PASSSTAT (p_fSt, k, p);
+}
+
+/**
+ *  \brief Writing a snapshot of the state as a state record of a logging file in binary format.
+ *
+ *  \param fic file descriptor of the logging file (opened for appending)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where the snapshot is stored
+ */
+
+static void writeRecord (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap)
+{
+  unsigned int p, b, c, i;                                                                     /* counting variables */
+  unsigned char *rec, *q;                                                            /* binary record and its fields */
+
+  q = rec = recBuffer (binRecSize (p_dim));
+  q = put16 (put16 (q, p_snap->k), p_snap->nBags);
+  *q++ = p_snap->porterStat;
+  for (b = 0; b < p_dim->b; b++)
+    *q++ = SNAPDRIVER (p_snap, p_dim, b);
+  for (c = 0; c < p_dim->c; c++)
+    q = put16 (q, SNAPBELT (p_snap, p_dim, c));
+  q = put16 (q, p_snap->nSR);
+  for (i = 0; i < p_dim->n; i++)
+    q = put16 (q, (SNAPQUEUE (p_snap, i) != EMPTYPOS) ? SNAPQUEUE (p_snap, i) : RECEMPTY);
+  for (b = 0; b < p_dim->b; b++)
+    for (i = 0; i < p_dim->t; i++)
+      q = put16 (q, (SNAPSEAT (p_snap, p_dim, b, i) != EMPTYST) ? SNAPSEAT (p_snap, p_dim, b, i) : RECEMPTY);
+  for (p = 0; p < p_dim->n; p++)
+  { *q++ = SNAPPASS (p_snap, p_dim, p).stat | (SNAPPASS (p_snap, p_dim, p).sit << 4);
+    *q++ = SNAPPASS (p_snap, p_dim, p).nBagsReal;
+    *q++ = SNAPPASS (p_snap, p_dim, p).nBagsAct;
+  }
+  fwrite (rec, q - rec, 1, fic);
+}
+
+/**
+ *  \brief Writing the transitions from the last state written to a snapshot of the state.
+ *
+ *  All the fields are recorded the first time. The queue is assumed to evolve in FIFO order: the number of
+ *  identifications retrieved from its head is recorded, followed by the identifications inserted at its tail. If that
+ *  is not the case, it is emptied and filled anew.
+ *
+ *  \param fic file descriptor of the logging file (opened for appending)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where the snapshot is stored
+ */
+
+static void writeEvents (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap)
+{
+  unsigned int p, b, c, i;                                                                     /* counting variables */
+  unsigned int lp, lc, nOut;                        /* previous and present queue length and number of retrieved ids */
+  unsigned char *rec, *q;                                                     /* transition records and their fields */
+  bool all;                                                                               /* all fields are recorded */
+
+  if ((all = (evPrev == NULL)) && ((evPrev = malloc (snapSize (p_dim))) == NULL))
+     { perror ("error on allocating the last state written");
        exit (EXIT_FAILURE);
      }
-  fprintf (fic, "%2u %2u", k, p_fSt->plHold[k].nBags);
-  switch (p_fSt->st.porterStat)
+  q = rec = recBuffer (21 + 3 * p_dim->b + 4 * p_dim->c + 9 * p_dim->n + 5 * p_dim->b * p_dim->t);
+  if (all || (p_snap->k != evPrev->k))
+     { *q++ = EVFLIGHT;
+       q = put16 (q, p_snap->k);
+     }
+  if (all || (p_snap->nBags != evPrev->nBags))
+     { *q++ = EVHOLD;
+       q = put16 (q, p_snap->nBags);
+     }
+  if (all || (p_snap->porterStat != evPrev->porterStat))
+     { *q++ = EVPORTER;
+       *q++ = p_snap->porterStat;
+     }
+  for (c = 0; c < p_dim->c; c++)
+    if (all || (SNAPBELT (p_snap, p_dim, c) != SNAPBELT (evPrev, p_dim, c)))
+       { *q++ = EVBELT;
+         *q++ = c;
+         q = put16 (q, SNAPBELT (p_snap, p_dim, c));
+       }
+  if (all || (p_snap->nSR != evPrev->nSR))
+     { *q++ = EVSTORE;
+       q = put16 (q, p_snap->nSR);
+     }
+  for (b = 0; b < p_dim->b; b++)
+    if (all || (SNAPDRIVER (p_snap, p_dim, b) != SNAPDRIVER (evPrev, p_dim, b)))
+       { *q++ = EVDRIVER;
+         *q++ = b;
+         *q++ = SNAPDRIVER (p_snap, p_dim, b);
+       }
+  for (lp = 0; !all && (lp < p_dim->n) && (SNAPQUEUE (evPrev, lp) != EMPTYPOS); lp++);
+  for (lc = 0; (lc < p_dim->n) && (SNAPQUEUE (p_snap, lc) != EMPTYPOS); lc++);
+  for (nOut = 0; (nOut < lp) && ((lc == 0) || (SNAPQUEUE (evPrev, nOut) != SNAPQUEUE (p_snap, 0))); nOut++);
+  for (i = nOut; (i < lp) && (i - nOut < lc) && (SNAPQUEUE (evPrev, i) == SNAPQUEUE (p_snap, i - nOut)); i++);
+  if (all || (i < lp))                                                               /* the queue is filled anew */
+     nOut = all ? p_dim->n : lp;
+  if (nOut != 0)
+     { *q++ = EVQOUT;
+       q = put16 (q, nOut);
+     }
+  for (i = (nOut < lp) ? lp - nOut : 0; i < lc; i++)
+  { *q++ = EVQIN;
+    q = put16 (q, SNAPQUEUE (p_snap, i));
+  }
+  for (b = 0; b < p_dim->b; b++)
+    for (i = 0; i < p_dim->t; i++)
+      if (all || (SNAPSEAT (p_snap, p_dim, b, i) != SNAPSEAT (evPrev, p_dim, b, i)))
+         { *q++ = EVSEAT;
+           q = put16 (put16 (q, b * p_dim->t + i),
+                      (SNAPSEAT (p_snap, p_dim, b, i) != EMPTYST) ? SNAPSEAT (p_snap, p_dim, b, i) : RECEMPTY);
+         }
+  for (p = 0; p < p_dim->n; p++)
+    if (all || (memcmp (&SNAPPASS (p_snap, p_dim, p), &SNAPPASS (evPrev, p_dim, p), sizeof (STAT_PASSENGER)) != 0))
+       { *q++ = EVPASS;
+         q = put16 (q, p);
+         *q++ = SNAPPASS (p_snap, p_dim, p).stat | (SNAPPASS (p_snap, p_dim, p).sit << 4);
+         *q++ = SNAPPASS (p_snap, p_dim, p).nBagsReal;
+         *q++ = SNAPPASS (p_snap, p_dim, p).nBagsAct;
+       }
+  *q++ = EVEND;
+  fwrite (rec, q - rec, 1, fic);
+  memcpy (evPrev, p_snap, snapSize (p_dim));
+}
+
+/**
+ *  \brief Writing a snapshot of the state as a double line of the logging file.
+ *
+ *  The layout is the same of <tt>saveState</tt>. In binary format, a state record is written instead and, in event
+ *  format, the transitions from the state last written by the process.
+ *
+ *  \param fic file descriptor of the logging file (opened for appending)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where the snapshot is stored
+ *  \param fmt format of the logging file (see <tt>logSink.h</tt>)
+ */
+
+void writeSnapshot (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap, int fmt)
+{
+  unsigned int p, b, c, i;                                                         /* counting variables */
+  unsigned int dc, dq, wq, ws;                                       /* widths of the columns labelled by an index */
+
+  if (fic == NULL) return;                                                                  /* null sink */
+  if (fmt == FMTBIN)
+     { writeRecord (fic, p_dim, p_snap);
+       return;
+     }
+  if (fmt == FMTEVENT)
+     { writeEvents (fic, p_dim, p_snap);
+       return;
+     }
+  dc = digits (p_dim->c);
+  dq = digits (p_dim->n);
+  wq = dq + 2;
+  ws = (digits (p_dim->t) + 2 > wq - 1) ? digits (p_dim->t) + 2 : wq - 1;
+  fprintf (fic, "%2u %2u", p_snap->k, p_snap->nBags);
+  switch (p_snap->porterStat)
   { case WAITING_FOR_A_PLANE_TO_LAND:  fprintf (fic, "  WPTL ");
                                        break;
     case AT_THE_PLANES_HOLD:           fprintf (fic, "  APHL ");
@@ -102,30 +527,28 @@ void saveState (char *nFic, unsigned int k, FULL_STAT* p_fSt)
     case AT_THE_STOREROOM:             fprintf (fic, "  ASTR ");
                                        break;
   }
-  fprintf (fic, "%2u %2u", p_fSt->convBelt.n, p_fSt->nToTBagsPSR);
-  switch (p_fSt->st.driverStat)
-  { case PARKING_AT_THE_ARRIVAL_TERMINAL:   fprintf (fic, "   PAAT ");
-                                            break;
-    case DRIVING_FORWARD:                   fprintf (fic, "   DRFW ");
-                                            break;
-    case PARKING_AT_THE_DEPARTURE_TERMINAL: fprintf (fic, "   PADT ");
-                                            break;
-    case DRIVING_BACKWARD:                  fprintf (fic, "   DRBW ");
-                                            break;
+  for (c = 0; c < p_dim->c; c++)
+    fprintf (fic, "%*u ", dc + 1, SNAPBELT (p_snap, p_dim, c));
+  fprintf (fic, "%2u", p_snap->nSR);
+  if ((p_dim->b == 1) && (p_dim->c == 1))                                                     /* the original layout */
+     fprintf (fic, "   %s ", driverName[SNAPDRIVER (p_snap, p_dim, 0)]);
+     else fprintf (fic, " ");
+  for (i = 0; i < p_dim->n; i++)
+	if (SNAPQUEUE (p_snap, i) != EMPTYPOS)
+	   fprintf (fic, "%*d", wq, SNAPQUEUE (p_snap, i));
+	   else fprintf (fic, "%*s", wq, "-");
+  for (b = 0; b < p_dim->b; b++)
+  { if ((p_dim->b == 1) && (p_dim->c == 1))
+       fprintf (fic, " ");
+       else fprintf (fic, "  %s", driverName[SNAPDRIVER (p_snap, p_dim, b)]);
+    for (i = 0; i < p_dim->t; i++)
+      if (SNAPSEAT (p_snap, p_dim, b, i) != EMPTYST)
+         fprintf (fic, "%*u", ws, SNAPSEAT (p_snap, p_dim, b, i));
+         else fprintf (fic, "%*s", ws, "-");
   }
-  for (i = 0; i < N; i++)
-	if (queuePeek (&(p_fSt->busQueue), i) != EMPTYPOS)
-	   fprintf (fic, "%3d", queuePeek (&(p_fSt->busQueue), i));
-	   else fprintf (fic, "  -");
-  fprintf (fic, " ");
-  for (i = 0; i < T; i++)
-	//if (i < p_fSt->bus.nOccup)
-	  if (p_fSt->bus.seat[i] != EMPTYST)
-	   fprintf (fic, "%3u", p_fSt->bus.seat[i]);
-       else fprintf (fic, "  -");
   fprintf (fic, "\n");
-  for (p = 0; p < N; p++)
-  { switch (p_fSt->st.passStat[k][p].stat)
+  for (p = 0; p < p_dim->n; p++)
+  { switch (SNAPPASS (p_snap, p_dim, p).stat)
     { case AT_THE_DISEMBARKING_ZONE:           fprintf (fic, "ADZ");
                                                break;
       case AT_THE_LUGGAGE_COLLECTION_POINT:    fprintf (fic, "LCP");
@@ -143,23 +566,52 @@ void saveState (char *nFic, unsigned int k, FULL_STAT* p_fSt)
       case ENTERING_THE_DEPARTURE_TERMINAL:    fprintf (fic, "EDT");
                                                break;
     }
-    if (p_fSt->st.passStat[k][p].sit == FD)
-       fprintf (fic, " FDT");
-       else fprintf (fic, " TRT");
-    fprintf (fic, "%3u %3u  ", p_fSt->st.passStat[k][p].nBagsReal, p_fSt->st.passStat[k][p].nBagsAct);
+    if (SNAPPASS (p_snap, p_dim, p).sit == FD)
+       fprintf (fic, "%*s FDT", dq - 1, "");
+       else fprintf (fic, "%*s TRT", dq - 1, "");
+    fprintf (fic, "%*s%*u %*u  ", dq - 1, "", dq + 2, SNAPPASS (p_snap, p_dim, p).nBagsReal, dq + 2,
+             SNAPPASS (p_snap, p_dim, p).nBagsAct);
   }
   fprintf (fic, "\n");
-  if (fclose (fic) == EOF)
-     { perror ("error on closing the log file");
-       exit (EXIT_FAILURE);
+}
+
+/**
+ *  \brief Writing the present full state as a double line at the end of the file.
+ *
+ *  If <tt>nFic</tt> is a null pointer or a null string, the lines are appended to a file under the predefined
+ *  name <em>log</em>.
+ *
+ *  The following layout is obeyed for the full state in a double line
+ *      \li plane, porter and queue state, followed by the state of every bus (driver and seats)
+ *      \li passengers state (p = 0,..., N-1).
+ *
+ *  The sink is opened on the first call and kept open, so it must not be written by any other means until the final
+ *  report.
+ *
+ *  \param nFic name of the logging file
+ *  \param k flight number
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ */
+
+void saveState (char *nFic, unsigned int k, FULL_STAT* p_fSt)
+{
+  if (stateSnap == NULL)
+     { if ((stateSnap = malloc (snapSize (&(p_fSt->dim)))) == NULL)
+          { perror ("error on allocating the snapshot of the state");
+            exit (EXIT_FAILURE);
+          }
+       stateFic = sinkOpen (nFic, false);
+       stateFmt = sinkFormat (nFic);
      }
+  takeSnapshot (k, p_fSt, stateSnap);
+  writeSnapshot (stateFic, &(p_fSt->dim), stateSnap, stateFmt);
 }
 
 /**
  *  \brief Writing the final report.
  *
  *  If <tt>nFic</tt> is a null pointer or a null string, the lines are appended to a file under the predefined
- *  name <em>log</em>.
+ *  name <em>log</em>. In binary and event formats, the final report record is appended instead.
  *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state is stored
@@ -168,27 +620,314 @@ void saveState (char *nFic, unsigned int k, FULL_STAT* p_fSt)
 void finalReport (char *nFic, FULL_STAT* p_fSt)
 {
   FILE *fic;                                                                          /* file descriptor */
-  char *dName = "log",                                                          /* default log file name */
-       *fName;                                                                          /* log file name */
-
-  if ((nFic == NULL) || (strcmp (nFic, "") == 0))
-     fName = dName;
-     else fName = nFic;
-  if ((fic = fopen (fName, "a")) == NULL)
-     { perror ("error on opening for appending the log file");
-       exit (EXIT_FAILURE);
+  REPORT rep;                                                                            /* final report */
+  unsigned char rec[REPSIZE];                                              /* final report binary record */
+  unsigned char *q;                                                             /* present field pointer */
+
+  if (stateSnap != NULL)                                           /* close the sink of the saved states */
+     { sinkClose (stateFic);
+       free (stateSnap);
+       stateSnap = NULL;
      }
+  if ((fic = sinkOpen (nFic, false)) == NULL) return;
+  rep.nLand = p_fSt->nLand + 1;
+  rep.nBags = p_fSt->nToTBagsPCB + p_fSt->nToTBagsPSR + p_fSt->nToTMBags;
+  rep.nBagsAct = p_fSt->nToTBagsPCB + p_fSt->nToTBagsPSR;
+  rep.nPassFD = p_fSt->nToTPassFD;
+  rep.nPassTST = p_fSt->nToTPassTST;
+  if (sinkFormat (nFic) != FMTTEXT)
+     { if (sinkFormat (nFic) == FMTBIN)
+          q = put16 (rec, RECMARK);
+          else { rec[0] = EVREPORT;
+                 q = rec + 1;
+               }
+       q = put32 (put32 (put32 (put32 (put32 (q, rep.nLand), rep.nBags), rep.nBagsAct), rep.nPassFD), rep.nPassTST);
+       fwrite (rec, q - rec, 1, fic);
+     }
+     else writeReport (fic, &rep);
+  sinkClose (fic);
+}
+
+/**
+ *  \brief Writing the text of the final report.
+ *
+ *  \param fic file descriptor of the logging file
+ *  \param p_rep pointer to the location where the final report is stored
+ */
+
+void writeReport (FILE *fic, REPORT *p_rep)
+{
   fprintf (fic, "Final Report\n");
-  fprintf (fic, "Number of plane landings: %1u.\n", p_fSt->nLand + 1);
-  fprintf (fic, "Total number of pieces of luggage that should have been processed: %2u.\n",
-           p_fSt->nToTBagsPCB + p_fSt->nToTBagsPSR + p_fSt->nToTMBags);
-  fprintf (fic, "Total number of pieces of luggage that were actually processed: %2u.\n",
-           p_fSt->nToTBagsPCB + p_fSt->nToTBagsPSR);
+  fprintf (fic, "Number of plane landings: %1u.\n", p_rep->nLand);
+  fprintf (fic, "Total number of pieces of luggage that should have been processed: %2u.\n", p_rep->nBags);
+  fprintf (fic, "Total number of pieces of luggage that were actually processed: %2u.\n", p_rep->nBagsAct);
   fprintf (fic, "Total number of passengers that has this airport as their final destination: %2u.\n",
-           p_fSt->nToTPassFD);
-  fprintf (fic, "Total number of passengers in transit: %2u.\n", p_fSt->nToTPassTST);
-  if (fclose (fic) == EOF)
-     { perror ("error on closing the log file");
-       exit (EXIT_FAILURE);
+           p_rep->nPassFD);
+  fprintf (fic, "Total number of passengers in transit: %2u.\n", p_rep->nPassTST);
+}
+
+/**
+ *  \brief Reading the header of a logging file in binary or event format.
+ *
+ *  \param fic file descriptor of the logging file (opened for reading)
+ *  \param p_dim pointer to the location where the problem dimensions are to be stored
+ *
+ *  \return \c FMTBIN or \c FMTEVENT, upon success
+ *  \return \c FMTTEXT, if it is not a logging file in binary or event format
+ */
+
+int readHeader (FILE *fic, DIM *p_dim)
+{
+  unsigned char head[HEADSIZE],                                                                     /* binary header */
+                *q = head + 4;                                                              /* present field pointer */
+  int fmt;                                                                             /* format of the logging file */
+
+  if (fread (head, HEADSIZE, 1, fic) != 1)
+     return FMTTEXT;
+  if (memcmp (head, LOGMAGIC, 4) == 0)
+     fmt = FMTBIN;
+     else if (memcmp (head, EVMAGIC, 4) == 0)
+             fmt = FMTEVENT;
+             else return FMTTEXT;
+  p_dim->k = get32 (&q);
+  p_dim->n = get32 (&q);
+  p_dim->m = get32 (&q);
+  p_dim->t = get32 (&q);
+  p_dim->b = get32 (&q);
+  p_dim->c = get32 (&q);
+  return fmt;
+}
+
+/**
+ *  \brief Reading the next record of a logging file in binary format.
+ *
+ *  \param fic file descriptor of the logging file (opened for reading, past the header)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where a state record is to be stored (at least <tt>snapSize</tt> bytes long)
+ *  \param p_rep pointer to the location where the final report record is to be stored
+ *
+ *  \return \c RECSTATE, if a state record was read
+ *  \return \c RECREPORT, if the final report record was read
+ *  \return \c RECEND, if the end of the file was reached
+ *  \return -\c 1, if the file is truncated
+ */
+
+int readRecord (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap, REPORT *p_rep)
+{
+  unsigned char *rec, *q;                                                            /* binary record and its fields */
+  size_t size;                                                                                 /* size of the record */
+  unsigned int p, b, c, i, val;                                                      /* counting variables and value */
+
+  size = binRecSize (p_dim);
+  q = rec = recBuffer ((size > REPSIZE) ? size : REPSIZE);
+  if ((size = fread (rec, 1, 2, fic)) != 2)
+     return (size == 0) ? RECEND : -1;
+  if (get16 (&q) == RECMARK)
+     { if (fread (rec + 2, REPSIZE - 2, 1, fic) != 1)
+          return -1;
+       p_rep->nLand = get32 (&q);
+       p_rep->nBags = get32 (&q);
+       p_rep->nBagsAct = get32 (&q);
+       p_rep->nPassFD = get32 (&q);
+       p_rep->nPassTST = get32 (&q);
+       return RECREPORT;
+     }
+  if (fread (rec + 2, binRecSize (p_dim) - 2, 1, fic) != 1)
+     return -1;
+  q = rec;
+  p_snap->k = get16 (&q);
+  p_snap->nBags = get16 (&q);
+  p_snap->porterStat = *q++;
+  for (b = 0; b < p_dim->b; b++)
+    SNAPDRIVER (p_snap, p_dim, b) = *q++;
+  for (c = 0; c < p_dim->c; c++)
+    SNAPBELT (p_snap, p_dim, c) = get16 (&q);
+  p_snap->nSR = get16 (&q);
+  for (i = 0; i < p_dim->n; i++)
+    SNAPQUEUE (p_snap, i) = ((val = get16 (&q)) != RECEMPTY) ? (int) val : EMPTYPOS;
+  for (b = 0; b < p_dim->b; b++)
+    for (i = 0; i < p_dim->t; i++)
+      SNAPSEAT (p_snap, p_dim, b, i) = ((val = get16 (&q)) != RECEMPTY) ? (int) val : EMPTYST;
+  for (p = 0; p < p_dim->n; p++)
+  { SNAPPASS (p_snap, p_dim, p).stat = *q & 0x0F;
+    SNAPPASS (p_snap, p_dim, p).sit = *q++ >> 4;
+    SNAPPASS (p_snap, p_dim, p).nBagsReal = *q++;
+    SNAPPASS (p_snap, p_dim, p).nBagsAct = *q++;
+  }
+  return RECSTATE;
+}
+
+/**
+ *  \brief Reading the transitions to the next state of a logging file in event format.
+ *
+ *  \param fic file descriptor of the logging file (opened for reading, past the header)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where the state reconstructed so far is stored (at least <tt>snapSize</tt>
+ *         bytes long and zero filled before the first call); the transitions are applied to it
+ *  \param p_rep pointer to the location where the final report record is to be stored
+ *
+ *  \return \c RECSTATE, if the transitions to the next state were applied
+ *  \return \c RECREPORT, if the final report record was read
+ *  \return \c RECEND, if the end of the file was reached
+ *  \return -\c 1, if the file is truncated or corrupted
+ */
+
+int readEvents (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap, REPORT *p_rep)
+{
+  unsigned char fld[20],                                                                     /* fields of the record */
+                *q;                                                                         /* present field pointer */
+  int tag;                                                                                         /* kind of record */
+  unsigned int i, val;                                                                /* counting variable and value */
+
+  if ((tag = getc (fic)) == EOF)
+     return RECEND;
+  while (tag != EVEND)
+  { if ((tag == EOF) || (tag > EVREPORT) || ((evSize[tag] != 0) && (fread (fld, evSize[tag], 1, fic) != 1)))
+       return -1;
+    q = fld;
+    switch (tag)
+    { case EVFLIGHT: p_snap->k = get16 (&q);
+                     break;
+      case EVHOLD:   p_snap->nBags = get16 (&q);
+                     break;
+      case EVPORTER: p_snap->porterStat = *q;
+                     break;
+      case EVBELT:   if (q[0] >= p_dim->c) return -1;
+                     SNAPBELT (p_snap, p_dim, q[0]) = q[1] | (q[2] << 8);
+                     break;
+      case EVSTORE:  p_snap->nSR = get16 (&q);
+                     break;
+      case EVDRIVER: if (q[0] >= p_dim->b) return -1;
+                     SNAPDRIVER (p_snap, p_dim, q[0]) = q[1];
+                     break;
+      case EVQOUT:   val = get16 (&q);
+                     for (i = 0; i < p_dim->n; i++)
+                       SNAPQUEUE (p_snap, i) = (i + val < p_dim->n) ? SNAPQUEUE (p_snap, i + val) : EMPTYPOS;
+                     break;
+      case EVQIN:    i = 0;
+                     while ((i < p_dim->n) && (SNAPQUEUE (p_snap, i) != EMPTYPOS))
+                       i++;
+                     if (i == p_dim->n) return -1;
+                     SNAPQUEUE (p_snap, i) = get16 (&q);
+                     break;
+      case EVSEAT:   if ((i = get16 (&q)) >= p_dim->b * p_dim->t) return -1;
+                     SNAPSEAT (p_snap, p_dim, i / p_dim->t, i % p_dim->t) =
+                       ((val = get16 (&q)) != RECEMPTY) ? (int) val : EMPTYST;
+                     break;
+      case EVPASS:   if ((i = get16 (&q)) >= p_dim->n) return -1;
+                     SNAPPASS (p_snap, p_dim, i).stat = *q & 0x0F;
+                     SNAPPASS (p_snap, p_dim, i).sit = *q++ >> 4;
+                     SNAPPASS (p_snap, p_dim, i).nBagsReal = *q++;
+                     SNAPPASS (p_snap, p_dim, i).nBagsAct = *q;
+                     break;
+      case EVREPORT: p_rep->nLand = get32 (&q);
+                     p_rep->nBags = get32 (&q);
+                     p_rep->nBagsAct = get32 (&q);
+                     p_rep->nPassFD = get32 (&q);
+                     p_rep->nPassTST = get32 (&q);
+                     return RECREPORT;
+    }
+    tag = getc (fic);
+  }
+  return RECSTATE;
+}
+
+
+/**
+ *  \brief Selection of the states to be saved.
+ *
+ *  The level is one of <tt>off</tt>, <tt>flight</tt>, <tt>entity</tt> and <tt>full</tt>, or its number (0 to 3).
+ *  The entities are given as a comma separated list of <tt>po</tt> (porter), <tt>dr</tt> (bus drivers), passenger
+ *  identifications and ranges of them (<tt>a-b</tt>). It must be called after the shared region is laid out.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param level logging level (\c NULL, for <tt>full</tt>)
+ *  \param sel list of the selected entities (\c NULL, for all of them)
+ *  \param period one in every period states passing the level is saved (>= 1)
+ *
+ *  \return \c true, upon success
+ *  \return \c false, if the level or the list of entities is invalid
+ */
+
+bool logSetup (FULL_STAT *p_fSt, char *level, char *sel, unsigned int period)
+{
+  static const char *name[] = { "off", "flight", "entity", "full" };                           /* names of the levels */
+  LOGCTL *p_c = &(p_fSt->logCtl);                                                   /* pointer to the logging control */
+  unsigned int lv, p, first, last;                                          /* counting variables and passenger range */
+  char *q;                                                                                    /* present list pointer */
+
+  if (period == 0) return false;
+  lv = LOGLVFULL;
+  if (level != NULL)
+     { lv = LOGLVOFF;
+       while ((lv <= LOGLVFULL) && (strcmp (level, name[lv]) != 0))
+         lv += 1;
+       if ((lv > LOGLVFULL) && ((strlen (level) != 1) || (level[0] < '0') || (level[0] > '3')))
+          return false;
+       if (lv > LOGLVFULL) lv = level[0] - '0';
      }
+  p_c->level = lv;
+  p_c->period = period;
+  p_c->nSel = 0;
+  p_c->porter = p_c->driver = (sel == NULL);
+  for (p = 0; p < p_fSt->dim.n; p++)
+    LOGSEL (p_c, p) = (sel == NULL);
+  if (sel == NULL) return true;
+  q = sel;
+  while (*q != '\0')
+  { if ((strncmp (q, "po", 2) == 0) && ((q[2] == ',') || (q[2] == '\0')))
+       { p_c->porter = true;
+         q += 2;
+       }
+       else if ((strncmp (q, "dr", 2) == 0) && ((q[2] == ',') || (q[2] == '\0')))
+               { p_c->driver = true;
+                 q += 2;
+               }
+               else { if ((*q < '0') || (*q > '9')) return false;
+                      first = last = (unsigned int) strtoul (q, &q, 10);
+                      if ((*q == '-') && (q[1] >= '0') && (q[1] <= '9'))
+                         last = (unsigned int) strtoul (q + 1, &q, 10);
+                      if ((first > last) || (last >= p_fSt->dim.n) || ((*q != ',') && (*q != '\0')))
+                         return false;
+                      for (p = first; p <= last; p++)
+                        LOGSEL (p_c, p) = true;
+                    }
+    if (*q == ',') q += 1;
+  }
+  return true;
+}
+
+/**
+ *  \brief Checking whether a state is to be saved.
+ *
+ *  The states passing the level are counted, so it must be called exactly once per state, within the statistics
+ *  critical region, and the state must be saved if it returns \c true.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param who entity saving the state (passenger identification, <tt>LOGPORTER</tt>, <tt>LOGDRIVER</tt> or
+ *         <tt>LOGSUMMARY</tt>)
+ *
+ *  \return \c true, if the state is to be saved
+ *  \return \c false, otherwise
+ */
+
+bool logSample (FULL_STAT *p_fSt, unsigned int who)
+{
+  LOGCTL *p_c = &(p_fSt->logCtl);                                                   /* pointer to the logging control */
+  bool pass;                                                                          /* the state passes the level */
+
+  switch (p_c->level)
+  { case LOGLVFLIGHT: pass = (who == LOGSUMMARY);
+                    break;
+    case LOGLVENTITY: if ((who == LOGPORTER) || (who == LOGSUMMARY))
+                       pass = p_c->porter;
+                       else if (who == LOGDRIVER)
+                               pass = p_c->driver;
+                               else pass = (who < p_fSt->dim.n) && LOGSEL (p_c, who);
+                    break;
+    case LOGLVFULL:   pass = true;
+                    break;
+    default:        pass = false;
+  }
+  return pass && ((p_c->nSel++ % p_c->period) == 0);
 }
@@ -10,7 +10,38 @@
  *  Defined operations:
  *     \li file initialization
  *     \li writing the present state as a single line at the end of the file
- *     \li writing final report.
+ *     \li taking a snapshot of the present state and writing it later on
+ *     \li writing final report
+ *     \li reading back a logging file in binary or event format
+ *     \li selection of the states to be saved.
+ *
+ *  A logging file in binary format (see <tt>logSink.h</tt>) starts with a header made of the magic number
+ *  <tt>LOGMAGIC</tt> and the problem dimensions K, N, M, T, B and C (6 x 32 bits). It is followed by a fixed-size
+ *  record per state (<tt>binRecSize</tt> bytes) and closed by the final report record. All fields are little-endian
+ *  unsigned integers:
+ *     \li state record - plane landing number (16 bits), number of pieces of luggage in the plane's hold (16), state
+ *         of the porter (8), state of the bus drivers (B x 8), number of pieces of luggage on every conveyor belt
+ *         (C x 16) and in the storeroom (16), queue positions (N x 16) and seats of every bus in turn (B x T x 16),
+ *         where <tt>0xFFFF</tt> means empty, and, for every passenger, her state and situation (8, the latter in the
+ *         high nibble), the number of pieces of luggage she should be carrying (8) and that she is really carrying (8)
+ *     \li final report record - <tt>RECMARK</tt> (16 bits), followed by the five figures of the report (5 x 32).
+ *
+ *  A logging file in event format has the same header, with the magic number <tt>EVMAGIC</tt>. Each state is
+ *  recorded as the sequence of transitions which lead to it from the previous one: plane landing, counts of pieces
+ *  of luggage (one per conveyor belt), state of the porter or of a bus driver, identifications retrieved from and
+ *  inserted into the queue, seats and passengers which have changed, closed by an end mark. A state change of an
+ *  entity thus takes a few bytes, whatever the number of passengers. The final report record closes the file as well.
+ *
+ *  Not every state an intervening entity is asked to save need be saved. The logging level selects them:
+ *     \li <tt>off</tt> - none
+ *     \li <tt>flight</tt> - a summary per flight, the state in which the porter has emptied the plane's hold
+ *     \li <tt>entity</tt> - the transitions of the selected entities (porter, bus drivers and a set of passengers)
+ *     \li <tt>full</tt> - all of them.
+ *
+ *  Of the states passing the level, only one in every <em>period</em> is saved, counted in the order they are
+ *  passed, so that the same run always yields the same lines. The entities ask whether a state is to be saved before
+ *  taking the snapshot; when logging is off, they skip the statistics critical region whenever it would only be
+ *  entered for that.
  *
  *  \author António Rui Borges - November 2013
  */
@@ -18,7 +49,106 @@
 #ifndef LOGGING_H_
 #define LOGGING_H_
 
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "probConst.h"
+#include "probDataStruct.h"
+
+/**
+ *  \brief Definition of <em>snapshot of the state</em> data type.
+ *
+ *  It keeps, in a compact form, the fields of the full state of the problem which are written in a double line of
+ *  the logging file. The fixed part is followed by a variable part whose size depends on the problem dimensions.
+ */
+typedef struct
+        { /** \brief plane landing number */
+          unsigned int k;
+          /** \brief number of pieces of luggage in the plane's hold */
+          unsigned int nBags;
+          /** \brief state of the porter */
+          unsigned int porterStat;
+          /** \brief total number of pieces of luggage placed in the storeroom */
+          unsigned int nSR;
+          /** \brief contents of the queue (N), occupation of the seats of every bus (B x T), state of the bus drivers
+           *  (B), number of pieces of luggage on every conveyor belt (C) and state of the passengers (N) */
+          int var[];
+        } SNAPSHOT;
+
+/**
+ *  \brief Definition of <em>final report</em> data type.
+ */
+typedef struct
+        { /** \brief number of plane landings */
+          unsigned int nLand;
+          /** \brief total number of pieces of luggage that should have been processed */
+          unsigned int nBags;
+          /** \brief total number of pieces of luggage that were actually processed */
+          unsigned int nBagsAct;
+          /** \brief total number of passengers that have this airport as their final destination */
+          unsigned int nPassFD;
+          /** \brief total number of passengers in transit */
+          unsigned int nPassTST;
+        } REPORT;
+
+/** \brief magic number of a logging file in binary format */
+#define  LOGMAGIC                 "ARL3"
+
+/** \brief magic number of a logging file in event format */
+#define  EVMAGIC                  "ARE3"
+
+/** \brief mark of the final report record in a logging file in binary format */
+#define  RECMARK                  0xFFFF
+
+/** \brief no more records in a logging file in binary format */
+#define  RECEND                   0
+
+/** \brief a state record was read from a logging file in binary format */
+#define  RECSTATE                 1
+
+/** \brief the final report record was read from a logging file in binary format */
+#define  RECREPORT                2
+
+/** \brief logging level: no state is saved */
+#define  LOGLVOFF                 0
+
+/** \brief logging level: a summary per flight is saved */
+#define  LOGLVFLIGHT              1
+
+/** \brief logging level: the transitions of the selected entities are saved */
+#define  LOGLVENTITY              2
+
+/** \brief logging level: every state is saved */
+#define  LOGLVFULL                3
+
+/** \brief entity saving the state: the porter */
+#define  LOGPORTER                ((unsigned int) -1)
+
+/** \brief entity saving the state: a bus driver */
+#define  LOGDRIVER                ((unsigned int) -2)
+
+/** \brief entity saving the state: the porter, in the state which closes a flight */
+#define  LOGSUMMARY               ((unsigned int) -3)
+
+/** \brief logging is not off (it may be checked outside any critical region) */
+#define  LOGACTIVE(p_fSt)         ((p_fSt)->logCtl.level != LOGLVOFF)
+
+/** \brief position i of the queue for the transfer ride in a snapshot */
+#define  SNAPQUEUE(p_s,i)         ((p_s)->var[i])
+
+/** \brief state of occupation of seat i in bus j in a snapshot */
+#define  SNAPSEAT(p_s,p_dim,j,i)  ((p_s)->var[(p_dim)->n+(j)*(p_dim)->t+(i)])
+
+/** \brief state of the driver of bus j in a snapshot */
+#define  SNAPDRIVER(p_s,p_dim,j)  ((p_s)->var[(p_dim)->n+(p_dim)->b*(p_dim)->t+(j)])
+
+/** \brief number of pieces of luggage on conveyor belt j in a snapshot */
+#define  SNAPBELT(p_s,p_dim,j)    ((p_s)->var[(p_dim)->n+(p_dim)->b*((p_dim)->t+1)+(j)])
+
+/** \brief state of passenger p in a snapshot */
+#define  SNAPPASS(p_s,p_dim,p)    \
+         (((STAT_PASSENGER *) &((p_s)->var[(p_dim)->n+(p_dim)->b*((p_dim)->t+1)+(p_dim)->c]))[p])
 
 /**
  *  \brief File initialization.
@@ -26,15 +156,28 @@
  *  The function creates the logging file and writes its header.
  *  If <tt>nFic</tt> is a null pointer or a null string, the file is created under a predefined name <em>log</em>.
  *
+ *  In binary and event formats, the binary header is written instead. The program terminates if the problem dimensions
+ *  do not fit in the fields of the records.
+ *
  *  The header consists of
  *       \li a line title
  *       \li a blank line
  *       \li a quad line describing the meaning of the different fields of the state lines.
  *
  *  \param nFic name of the logging file
+ *  \param p_dim pointer to the location where the problem dimensions are stored
  */
 
-extern void createLog (char *nFic);
+extern void createLog (char *nFic, DIM *p_dim);
+
+/**
+ *  \brief Writing the text header of the logging file.
+ *
+ *  \param fic file descriptor of the logging file
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ */
+
+extern void writeHeader (FILE *fic, DIM *p_dim);
 
 /**
  *  \brief Writing the present full state as a double line at the end of the file.
@@ -43,7 +186,7 @@ extern void createLog (char *nFic);
  *  name <em>log</em>.
  *
  *  The following layout is obeyed for the full state in a double line
- *      \li plane, porter, driver, queue and bus state
+ *      \li plane, porter and queue state, followed by the state of every bus (driver and seats)
  *      \li passengers state (p = 0,..., N-1).
  *
  *  \param nFic name of the logging file
@@ -53,11 +196,55 @@ extern void createLog (char *nFic);
 
 extern void saveState (char *nFic, unsigned int k, FULL_STAT* p_fSt);
 
+/**
+ *  \brief Size of a snapshot of the state.
+ *
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *
+ *  \return size of a snapshot (in bytes)
+ */
+
+extern size_t snapSize (DIM *p_dim);
+
+/**
+ *  \brief Size of a state record of a logging file in binary format.
+ *
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *
+ *  \return size of a record (in bytes)
+ */
+
+extern size_t binRecSize (DIM *p_dim);
+
+/**
+ *  \brief Taking a snapshot of the present full state.
+ *
+ *  \param k flight number
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param p_snap pointer to the location where the snapshot is to be stored (at least <tt>snapSize</tt> bytes long)
+ */
+
+extern void takeSnapshot (unsigned int k, FULL_STAT* p_fSt, SNAPSHOT *p_snap);
+
+/**
+ *  \brief Writing a snapshot of the state as a double line of the logging file.
+ *
+ *  The layout is the same of <tt>saveState</tt>. In binary format, a state record is written instead and, in event
+ *  format, the transitions from the state last written by the process.
+ *
+ *  \param fic file descriptor of the logging file (opened for appending)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where the snapshot is stored
+ *  \param fmt format of the logging file (see <tt>logSink.h</tt>)
+ */
+
+extern void writeSnapshot (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap, int fmt);
+
 /**
  *  \brief Writing the final report.
  *
  *  If <tt>nFic</tt> is a null pointer or a null string, the lines are appended to a file under the predefined
- *  name <em>log</em>.
+ *  name <em>log</em>. In binary and event formats, the final report record is appended instead.
  *
  *  \param nFic name of the logging file
  *  \param p_fSt pointer to the location where the full internal state is stored
@@ -65,4 +252,92 @@ extern void saveState (char *nFic, unsigned int k, FULL_STAT* p_fSt);
 
 extern void finalReport (char *nFic, FULL_STAT* p_fSt);
 
+/**
+ *  \brief Writing the text of the final report.
+ *
+ *  \param fic file descriptor of the logging file
+ *  \param p_rep pointer to the location where the final report is stored
+ */
+
+extern void writeReport (FILE *fic, REPORT *p_rep);
+
+/**
+ *  \brief Reading the header of a logging file in binary or event format.
+ *
+ *  \param fic file descriptor of the logging file (opened for reading)
+ *  \param p_dim pointer to the location where the problem dimensions are to be stored
+ *
+ *  \return \c FMTBIN or \c FMTEVENT, upon success
+ *  \return \c FMTTEXT, if it is not a logging file in binary or event format
+ */
+
+extern int readHeader (FILE *fic, DIM *p_dim);
+
+/**
+ *  \brief Reading the next record of a logging file in binary format.
+ *
+ *  \param fic file descriptor of the logging file (opened for reading, past the header)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where a state record is to be stored (at least <tt>snapSize</tt> bytes long)
+ *  \param p_rep pointer to the location where the final report record is to be stored
+ *
+ *  \return \c RECSTATE, if a state record was read
+ *  \return \c RECREPORT, if the final report record was read
+ *  \return \c RECEND, if the end of the file was reached
+ *  \return -\c 1, if the file is truncated
+ */
+
+extern int readRecord (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap, REPORT *p_rep);
+
+/**
+ *  \brief Reading the transitions to the next state of a logging file in event format.
+ *
+ *  \param fic file descriptor of the logging file (opened for reading, past the header)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *  \param p_snap pointer to the location where the state reconstructed so far is stored (at least <tt>snapSize</tt>
+ *         bytes long and zero filled before the first call); the transitions are applied to it
+ *  \param p_rep pointer to the location where the final report record is to be stored
+ *
+ *  \return \c RECSTATE, if the transitions to the next state were applied
+ *  \return \c RECREPORT, if the final report record was read
+ *  \return \c RECEND, if the end of the file was reached
+ *  \return -\c 1, if the file is truncated or corrupted
+ */
+
+extern int readEvents (FILE *fic, DIM *p_dim, SNAPSHOT *p_snap, REPORT *p_rep);
+
+/**
+ *  \brief Selection of the states to be saved.
+ *
+ *  The level is one of <tt>off</tt>, <tt>flight</tt>, <tt>entity</tt> and <tt>full</tt>, or its number (0 to 3).
+ *  The entities are given as a comma separated list of <tt>po</tt> (porter), <tt>dr</tt> (bus drivers), passenger
+ *  identifications and ranges of them (<tt>a-b</tt>). It must be called after the shared region is laid out.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param level logging level (\c NULL, for <tt>full</tt>)
+ *  \param sel list of the selected entities (\c NULL, for all of them)
+ *  \param period one in every period states passing the level is saved (>= 1)
+ *
+ *  \return \c true, upon success
+ *  \return \c false, if the level or the list of entities is invalid
+ */
+
+extern bool logSetup (FULL_STAT *p_fSt, char *level, char *sel, unsigned int period);
+
+/**
+ *  \brief Checking whether a state is to be saved.
+ *
+ *  The states passing the level are counted, so it must be called exactly once per state, within the statistics
+ *  critical region, and the state must be saved if it returns \c true.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param who entity saving the state (passenger identification, <tt>LOGPORTER</tt>, <tt>LOGDRIVER</tt> or
+ *         <tt>LOGSUMMARY</tt>)
+ *
+ *  \return \c true, if the state is to be saved
+ *  \return \c false, otherwise
+ */
+
+extern bool logSample (FULL_STAT *p_fSt, unsigned int who);
+
 #endif /* LOGGING_H_ */
@@ -0,0 +1,473 @@
+/**
+ *  \file monteCarlo.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Batch runner: a number of independent simulations, each one with a seed of its own, are carried out side by side
+ *  and the figures of their final reports are summed up.
+ *
+ *  Usage: <tt>monteCarlo</tt> [<tt>-r</tt> <em>runs</em>] [<tt>-j</tt> <em>jobs</em>] [<tt>-s</tt> <em>seed</em>]
+ *  [<tt>-g</tt> <em>generator</em>] [<tt>--</tt> <em>generator options</em>]
+ *    \li <tt>-r</tt> number of simulations (<tt>R_DEF</tt>, by default)
+ *    \li <tt>-j</tt> number of simulations under way at once (the number of processors online, by default)
+ *    \li <tt>-s</tt> seed of the first simulation, the next ones being given the following seeds (1, by default; the
+ *        last one may not go beyond 2147483647)
+ *    \li <tt>-g</tt> generator (<tt>./probSemSharedMemAirportRhapsody</tt>, by default; the thread and the
+ *        discrete event ones may be named as well).
+ *
+ *  The options following <tt>--</tt> are handed to every generator (for instance, <tt>-k 10 -n 6 -a 2</tt>). It is
+ *  run with the logging level <tt>off</tt>, unless the options say otherwise, and its logging file, in event format,
+ *  is kept in a directory of its own under <tt>/tmp</tt> until the final report has been read. The generators give
+ *  their shared regions and semaphore sets keys of their own, so that they do not collide, and destroy them as they
+ *  terminate; upon an interrupt, the runner terminates the generators under way. Every generator is started in a
+ *  process group of its own: should it not exit normally, having been killed outright or having crashed, the
+ *  objects under all its possible keys are removed and whatever is left of its group is killed.
+ *
+ *  For every figure of the final report (summed over the airports, if there are several) and for the time taken by
+ *  a simulation, the mean, the standard deviation and a 95% confidence interval of the mean (Student's t) are
+ *  printed. The simulations which fail are counted, but left out.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <time.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
+#include <sys/shm.h>
+#include <sys/mman.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "logSink.h"
+
+/** \brief default number of simulations */
+#define  R_DEF         10
+
+/** \brief largest number of simulations under way at once (the logging file name must fit the generator's) */
+#define  J_MAX         999
+
+/** \brief default generator */
+#define  GENERATOR     "./probSemSharedMemAirportRhapsody"
+
+/** \brief number of figures summed up */
+#define  NFIG          6
+
+/** \brief nanoseconds in a millisecond */
+#define  MSEC          1000000.0
+
+/** \brief name of a semaphore set of the implementation based on futexes (see <tt>semaphoreFutex.c</tt>) */
+#define  SEMNAME       "/airport.sem.%08x"
+
+/** \brief name of a shared region of the implementation based on shm_open (see <tt>sharedMemoryPosix.c</tt>) */
+#define  SHMNAME       "/airport.%08x"
+
+#ifndef SHMEM_HUGEDIR
+/** \brief hugetlbfs mount point the shared regions may be created in (see <tt>sharedMemoryPosix.c</tt>) */
+#define  SHMEM_HUGEDIR "/dev/hugepages"
+#endif
+
+/** \brief names of the figures summed up */
+static const char *figName[NFIG] = { "pieces of luggage that should have been processed",
+                                     "pieces of luggage that were actually processed",
+                                     "pieces of luggage that went missing",
+                                     "passengers that have the airport as their final destination",
+                                     "passengers in transit",
+                                     "time taken by a simulation (ms)" };
+
+/** \brief two-sided 95% quantiles of Student's t distribution, for 1 up to 30 degrees of freedom */
+static const double tQuant[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                   2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                   2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+/** \brief directory where the logging files are kept */
+static char dir[] = "/tmp/mcXXXXXX";
+
+/** \brief process identifier of the generator running in every slot (0, if the slot is free) */
+static pid_t *slotPid;
+
+/** \brief number of slots */
+static unsigned int nSlots;
+
+/** \brief an interrupt has been caught */
+static volatile sig_atomic_t stop = 0;
+
+/**
+ *  \brief Reading of a positive integer from the command line.
+ *
+ *  The program terminates if the value is not a positive integer.
+ *
+ *  \param opt option letter
+ *  \param arg option argument
+ *
+ *  \return the value
+ */
+
+static unsigned int posArg (int opt, char *arg)
+{
+  char *tinp;                                                                      /* numerical parameters test flag */
+  long val;                                                                                       /* converted value */
+
+  val = strtol (arg, &tinp, 0);
+  if ((*tinp != '\0') || (val <= 0) || (val > 0x7FFFFFFF))
+     { fprintf (stderr, "invalid value for option -%c: %s\n", opt, arg);
+       exit (EXIT_FAILURE);
+     }
+  return (unsigned int) val;
+}
+
+/**
+ *  \brief Reading the monotonic clock.
+ *
+ *  \return the present time (in ns)
+ */
+
+static double clockNs (void)
+{
+  struct timespec t;                                                                                 /* present time */
+
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return (double) t.tv_sec * 1.0e9 + (double) t.tv_nsec;
+}
+
+/**
+ *  \brief Terminating the generators under way upon an interrupt.
+ *
+ *  They destroy their shared regions and semaphore sets as they terminate; no more simulations are started.
+ *
+ *  \param sig signal number
+ */
+
+static void interrupt (int sig)
+{
+  unsigned int j;                                                                               /* counting variable */
+
+  (void) sig;                                                                  /* the interrupt is the only signal */
+  stop = 1;
+  for (j = 0; j < nSlots; j++)
+    if (slotPid[j] > 0)
+       kill (slotPid[j], SIGTERM);
+}
+
+/**
+ *  \brief Removing what is left of a simulation whose generator did not exit normally.
+ *
+ *  The semaphore sets and shared regions under every key the generator may have used are removed, whichever
+ *  implementation created them, and then its process group, the intervening entities and the log writer, is killed.
+ *  The group is still there while the objects are removed, so that its identifier, from which the keys are composed,
+ *  cannot have been handed to another generator.
+ *
+ *  \param pid process identifier of the generator
+ */
+
+static void purge (pid_t pid)
+{
+  char name[64];                                                                 /* name of the shared memory object */
+  int key, id;                                                                   /* access key and access identifier */
+  unsigned int s, a;                                                                           /* counting variables */
+
+  for (a = 0; a < A_MAX; a++)
+    for (s = 0; s < NSALTS; s++)
+    { key = RUNKEY (pid, s, a);
+      if ((id = semget ((key_t) key, 0, 0)) != -1)
+         semctl (id, 0, IPC_RMID);
+      if ((id = shmget ((key_t) key, 0, 0)) != -1)
+         shmctl (id, IPC_RMID, NULL);
+      sprintf (name, SEMNAME, (unsigned int) key);
+      shm_unlink (name);
+      sprintf (name, SHMNAME, (unsigned int) key);
+      shm_unlink (name);
+      sprintf (name, SHMEM_HUGEDIR SHMNAME, (unsigned int) key);
+      unlink (name);
+    }
+  kill (-pid, SIGKILL);
+}
+
+/**
+ *  \brief Starting a simulation.
+ *
+ *  The generator is handed the name of its logging file through a pipe, as it reads it from the standard input, and
+ *  its standard output is discarded. It leads a process group of its own.
+ *
+ *  \param gen generator
+ *  \param nFic name of the logging file
+ *  \param seed seed of the simulation
+ *  \param argc number of options handed to the generator
+ *  \param argv options handed to the generator
+ *
+ *  \return the process identifier of the generator, or -1 upon failure
+ */
+
+static pid_t launch (char *gen, char *nFic, unsigned int seed, int argc, char *argv[])
+{
+  int fd[2];                                                                                                 /* pipe */
+  int null;                                                                                /* null device descriptor */
+  char num[12];                                                        /* numeric value conversion (up to 10 digits) */
+  char **args;                                                                      /* command line of the generator */
+  pid_t pid;                                                                             /* generator identification */
+  int i;                                                                                        /* counting variable */
+
+  if (pipe (fd) == -1)
+     return -1;
+  if ((pid = fork ()) == -1)
+     { close (fd[0]);
+       close (fd[1]);
+       return -1;
+     }
+  if (pid == 0)
+     { setpgid (0, 0);
+       signal (SIGINT, SIG_DFL);
+       signal (SIGTERM, SIG_DFL);
+       signal (SIGPIPE, SIG_DFL);
+       if ((args = malloc ((argc + 6) * sizeof (char *))) == NULL)
+          { perror ("error on allocating the command line of the generator");
+            _exit (EXIT_FAILURE);
+          }
+       sprintf (num, "%u", seed);
+       args[0] = gen;
+       args[1] = "-l";
+       args[2] = "off";
+       for (i = 0; i < argc; i++)
+         args[3+i] = argv[i];
+       args[3+argc] = "-r";
+       args[4+argc] = num;
+       args[5+argc] = NULL;
+       close (fd[1]);
+       if (((null = open ("/dev/null", O_WRONLY)) == -1) || (dup2 (fd[0], STDIN_FILENO) == -1) ||
+           (dup2 (null, STDOUT_FILENO) == -1))
+          { perror ("error on redirecting the standard input and output of the generator");
+            _exit (EXIT_FAILURE);
+          }
+       close (fd[0]);
+       close (null);
+       execv (gen, args);
+       perror ("error on the generation of the generator process");
+       _exit (EXIT_FAILURE);
+     }
+  setpgid (pid, pid);                                                          /* whichever of both gets there first */
+  close (fd[0]);
+  if ((write (fd[1], nFic, strlen (nFic)) == -1) || (write (fd[1], "\n", 1) == -1))
+     perror ("error on handing the name of the logging file to the generator");
+  close (fd[1]);
+  return pid;
+}
+
+/**
+ *  \brief Reading the final report of a logging file in event format.
+ *
+ *  The file is removed afterwards.
+ *
+ *  \param nFic name of the logging file
+ *  \param p_rep pointer to the location where the final report is to be stored
+ *
+ *  \return \c true, if it was read
+ *  \return \c false, if the file does not exist or holds no final report
+ */
+
+static bool readReport (char *nFic, REPORT *p_rep)
+{
+  FILE *fic;                                                                                      /* file descriptor */
+  DIM dim;                                                                                     /* problem dimensions */
+  SNAPSHOT *snap;                                                                           /* snapshot of the state */
+  int stat = RECEND;                                                                          /* kind of record read */
+
+  if ((fic = fopen (nFic, "r")) == NULL)
+     return false;
+  if ((readHeader (fic, &dim) == FMTEVENT) && ((snap = calloc (1, snapSize (&dim))) != NULL))
+     { do
+       { stat = readEvents (fic, &dim, snap, p_rep);
+       } while (stat == RECSTATE);
+       free (snap);
+     }
+  fclose (fic);
+  unlink (nFic);
+  return stat == RECREPORT;
+}
+
+/**
+ *  \brief Collecting the figures of a simulation.
+ *
+ *  The final reports of the airports, if there are several, each one in a logging file of its own, are summed up.
+ *
+ *  \param nFic name of the logging file
+ *  \param fig figures of the simulation (the time taken is not filled in)
+ *
+ *  \return \c true, if the final report was read
+ *  \return \c false, otherwise
+ */
+
+static bool collect (char *nFic, double fig[])
+{
+  char nFicA[51];                                                              /* name of logging file of an airport */
+  REPORT rep,                                                                                        /* final report */
+         sum = { 0, 0, 0, 0, 0 };                                                             /* network-wide report */
+  unsigned int a,                                                                               /* counting variable */
+               nRead = 0;                                                     /* number of final reports of airports */
+  bool ok;                                                                                           /* success flag */
+
+  if (!(ok = readReport (nFic, &sum)))
+     { for (a = 0; a < A_MAX; a++)
+       { sprintf (nFicA, "%s.%u", nFic, a);
+         if (access (nFicA, F_OK) != 0) break;
+         if (readReport (nFicA, &rep))
+            { sum.nBags += rep.nBags;
+              sum.nBagsAct += rep.nBagsAct;
+              sum.nPassFD += rep.nPassFD;
+              sum.nPassTST += rep.nPassTST;
+              nRead += 1;
+            }
+       }
+       ok = (a > 0) && (nRead == a);
+     }
+  if (!ok)
+     return false;
+  fig[0] = sum.nBags;
+  fig[1] = sum.nBagsAct;
+  fig[2] = (double) sum.nBags - sum.nBagsAct;
+  fig[3] = sum.nPassFD;
+  fig[4] = sum.nPassTST;
+  return true;
+}
+
+/**
+ *  \brief Main program.
+ */
+
+int main (int argc, char *argv[])
+{
+  unsigned int nRuns = R_DEF,                                                               /* number of simulations */
+               nJobs,                                                     /* number of simulations under way at once */
+               seed = 1;                                                             /* seed of the first simulation */
+  char *gen = GENERATOR;                                                                                /* generator */
+  char (*nFic)[51];                                                        /* name of the logging file of every slot */
+  double *t0;                                                       /* start of the simulation running in every slot */
+  double fig[NFIG],                                                                       /* figures of a simulation */
+         sum[NFIG] = { 0.0 },                                                                 /* sums of the figures */
+         sum2[NFIG] = { 0.0 };                                                 /* sums of the squares of the figures */
+  double mean, sd, half;                                                      /* mean, standard deviation and margin */
+  unsigned int next = 0,                                                            /* number of simulations started */
+               nRunning = 0,                                                      /* number of simulations under way */
+               nOk = 0,                                                     /* number of simulations which succeeded */
+               nFailed = 0;                                                    /* number of simulations which failed */
+  unsigned int i, j;                                                                           /* counting variables */
+  long nCpu = sysconf (_SC_NPROCESSORS_ONLN);                                         /* number of processors online */
+  pid_t pid;                                                                             /* generator identification */
+  int status;                                                                                    /* execution status */
+  int c;                                                                                      /* command line option */
+
+  /* getting the options */
+
+  nJobs = (nCpu > 0) ? (unsigned int) nCpu : 1;
+  while ((c = getopt (argc, argv, "+r:j:s:g:")) != -1)
+    switch (c)
+    { case 'r': nRuns = posArg (c, optarg);
+                break;
+      case 'j': if ((nJobs = posArg (c, optarg)) > J_MAX)
+                   { fprintf (stderr, "invalid value for option -%c: %s (at most %d jobs)\n", c, optarg, J_MAX);
+                     return EXIT_FAILURE;
+                   }
+                break;
+      case 's': seed = posArg (c, optarg);
+                break;
+      case 'g': gen = optarg;
+                break;
+      default:  fprintf (stderr, "usage: %s [-r runs] [-j jobs] [-s seed] [-g generator] [-- generator options]\n",
+                         argv[0]);
+                return EXIT_FAILURE;
+    }
+  if ((unsigned long long) seed + nRuns - 1 > 0x7FFFFFFF)              /* the generators take the same seeds as -s */
+     { fprintf (stderr, "invalid values for options -r and -s: seeds %u to %llu go beyond %d\n", seed,
+                (unsigned long long) seed + nRuns - 1, 0x7FFFFFFF);
+       return EXIT_FAILURE;
+     }
+  if (nJobs > nRuns)
+     nJobs = nRuns;
+  nSlots = nJobs;
+  if (((slotPid = calloc (nSlots, sizeof (pid_t))) == NULL) || ((t0 = calloc (nSlots, sizeof (double))) == NULL) ||
+      ((nFic = calloc (nSlots, sizeof (*nFic))) == NULL))
+     { perror ("error on allocating the slots");
+       return EXIT_FAILURE;
+     }
+  if (mkdtemp (dir) == NULL)
+     { perror ("error on creating the directory of the logging files");
+       return EXIT_FAILURE;
+     }
+  signal (SIGINT, interrupt);
+  signal (SIGTERM, interrupt);
+  signal (SIGPIPE, SIG_IGN);                                   /* a generator may terminate before reading its input */
+
+  /* carrying out the simulations, nJobs at a time */
+
+  while ((next < nRuns) || (nRunning > 0))
+  { for (j = 0; (j < nSlots) && (next < nRuns) && !stop; j++)
+      if (slotPid[j] == 0)
+         { sprintf (nFic[j], "ev:%s/%u", dir, j);
+           t0[j] = clockNs ();
+           if ((slotPid[j] = launch (gen, nFic[j], seed + next, argc - optind, argv + optind)) == -1)
+              { perror ("error on starting a simulation");
+                slotPid[j] = 0;
+                nFailed += 1;
+              }
+              else nRunning += 1;
+           next += 1;
+         }
+    if (stop)
+       next = nRuns;
+    if (nRunning == 0)
+       continue;
+    if ((pid = wait (&status)) == -1)
+       { perror ("error on waiting for a simulation");
+         break;
+       }
+    for (j = 0; j < nSlots; j++)
+      if (slotPid[j] == pid)
+         break;
+    if (j == nSlots)
+       continue;
+    fig[NFIG-1] = (clockNs () - t0[j]) / MSEC;
+    slotPid[j] = 0;
+    nRunning -= 1;
+    if (!WIFEXITED (status))                                                   /* it could not clean up after itself */
+       purge (pid);
+    if (collect (nFic[j] + strlen ("ev:"), fig) && WIFEXITED (status) && (WEXITSTATUS (status) == EXIT_SUCCESS))
+       { for (i = 0; i < NFIG; i++)
+         { sum[i] += fig[i];
+           sum2[i] += fig[i] * fig[i];
+         }
+         nOk += 1;
+       }
+       else nFailed += 1;
+  }
+  rmdir (dir);
+
+  /* print the summary */
+
+  printf ("%u simulations of %s carried out (seeds %u to %u), %u at a time: %u succeeded, %u failed%s\n",
+          nOk + nFailed, gen, seed, seed + nRuns - 1, nJobs, nOk, nFailed, stop ? " (interrupted)" : "");
+  if (nOk == 0)
+     return EXIT_FAILURE;
+  printf ("%-62s %12s %12s   %s\n", "figure", "mean", "std dev", "95% confidence interval");
+  for (i = 0; i < NFIG; i++)
+  { mean = sum[i] / nOk;
+    sd = (nOk > 1) ? sqrt (fmax (sum2[i] - nOk * mean * mean, 0.0) / (nOk - 1)) : 0.0;
+    half = (nOk > 1) ? ((nOk <= 31) ? tQuant[nOk-2] : 1.960) * sd / sqrt (nOk) : 0.0;
+    printf ("%-62s %12.3f %12.3f   [%.3f, %.3f]\n", figName[i], mean, sd, mean - half, mean + half);
+  }
+  free (nFic);
+  free (t0);
+  free (slotPid);
+
+  return (nFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
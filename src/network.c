@@ -0,0 +1,151 @@
+/**
+ *  \file network.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Network of airports.
+ *
+ *  Defined operations:
+ *     \li linking an airport to the network
+ *     \li handing off a passenger in transit to the next airport
+ *     \li boarding the passengers handed off by the previous airport
+ *     \li writing the network report.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "queue.h"
+#include "sharedDataSync.h"
+#include "network.h"
+
+/** \brief nanoseconds in a millisecond */
+#define  MSEC           1000000ULL
+
+/**
+ *  \brief Linking an airport to the network.
+ *
+ *  It must be called by the generator, after the shared region has been initialized and before the intervening
+ *  entities are launched.
+ *
+ *  \param sh pointer to the shared region of the airport
+ *  \param airport airport number
+ *  \param nAirports number of airports in the network
+ *  \param nextKey access key to the shared memory and semaphore set of the next airport
+ *  \param seed seed of the random number generator of the plane landings generated anew at the airport
+ */
+
+void netLink (SHARED_DATA *sh, unsigned int airport, unsigned int nAirports, int nextKey, unsigned int seed)
+{
+  sh->net.airport = airport;
+  sh->net.nAirports = nAirports;
+  sh->net.nextKey = (nAirports > 1) ? nextKey : -1;
+  sh->net.seed = seed;
+}
+
+/**
+ *  \brief Handing off a passenger in transit to the next airport.
+ *
+ *  It should be called within the inbound channel critical region of the next airport.
+ *
+ *  \param shNext pointer to the shared region of the next airport
+ *  \param nBags number of pieces of luggage the passenger is carrying
+ *
+ *  \return \c true, if she was put in the inbound channel
+ *  \return \c false, if she was turned away, the channel being full
+ */
+
+bool netHandOff (SHARED_DATA *shNext, unsigned int nBags)
+{
+  shNext->net.nOffered += 1;
+  if (queueFull (&(shNext->net.inbound)))
+     { shNext->net.nRefused += 1;
+       return false;
+     }
+  queueIn (&(shNext->net.inbound), nBags);
+  return true;
+}
+
+/**
+ *  \brief Boarding the passengers handed off by the previous airport.
+ *
+ *  Those in the inbound channel, up to N, take the first seats of plane landing k, which is generated anew. It should
+ *  be called by the very first passenger descending from the plane, within the landing and the inbound channel
+ *  critical regions, before any passenger of the flight has looked at her state. The flight is drawn from the random
+ *  number generator of the airport, seeded anew from the seed kept in the shared region and the landing number, so
+ *  that it does not depend on the passenger process calling it.
+ *
+ *  \param sh pointer to the shared region
+ *  \param k plane landing number
+ *
+ *  \return the number of passengers who have boarded
+ */
+
+unsigned int netBoard (SHARED_DATA *sh, unsigned int k)
+{
+  unsigned int nIn = 0;                                                            /* number of passengers who board */
+  unsigned int nBags;                                                     /* number of pieces of luggage she carries */
+
+  while ((nIn < sh->fSt.dim.n) && !queueEmpty (&(sh->net.inbound)))
+  { queueOut (&(sh->net.inbound), &nBags);
+    PASSSTAT (&(sh->fSt), k, nIn).nBagsReal = nBags;
+    sh->net.nBagsIn += nBags;
+    nIn += 1;
+  }
+  if (nIn > 0)
+     { sh->net.nIn += nIn;
+       srandom (sh->net.seed + k);                  /* the flight is drawn from the airport's generator, seeded anew */
+       sharedDataFlight (&(sh->fSt), k, nIn);                            /* the flight is generated around them anew */
+     }
+  return nIn;
+}
+
+/**
+ *  \brief Writing the network report.
+ *
+ *  The load of every airport and the traffic over its inbound channel are listed, followed by the totals of the whole
+ *  network.
+ *
+ *  \param fic file descriptor
+ *  \param sh array of pointers to the shared regions of the airports
+ *  \param nAirports number of airports in the network
+ *  \param elapsed time the airports took to carry out their day's work (in ns)
+ */
+
+void netReport (FILE *fic, SHARED_DATA *sh[], unsigned int nAirports, unsigned long long elapsed)
+{
+  FULL_STAT *p_fSt;                                                       /* pointer to the full state of an airport */
+  NETLINK *p_n;                                                         /* pointer to the network link of an airport */
+  unsigned int a;                                                                               /* counting variable */
+  unsigned int nPass = 0, nBags = 0, nOffered = 0, nRefused = 0, nLeft = 0;                  /* network-wide figures */
+
+  fprintf (fic, "airport network: %u airports in a ring, day's work carried out in %.3f ms\n", nAirports,
+           (double) elapsed / MSEC);
+  for (a = 0; a < nAirports; a++)
+  { p_fSt = &(sh[a]->fSt);
+    p_n = &(sh[a]->net);
+    fprintf (fic, "airport %u: %u passengers (%u in transit), %u pieces of luggage (%u to the storeroom); "
+             "from airport %u, %u passengers handed off, %u turned away, %u boarded with %u pieces of luggage, "
+             "%u left waiting\n",
+             a, p_fSt->nToTPassFD + p_fSt->nToTPassTST, p_fSt->nToTPassTST,
+             p_fSt->nToTBagsPCB + p_fSt->nToTBagsPSR + p_fSt->nToTMBags, p_fSt->nToTBagsPSR,
+             (a + nAirports - 1) % nAirports, p_n->nOffered, p_n->nRefused, p_n->nIn, p_n->nBagsIn,
+             queueSize (&(p_n->inbound)));
+    nPass += p_fSt->nToTPassFD + p_fSt->nToTPassTST;
+    nBags += p_fSt->nToTBagsPCB + p_fSt->nToTBagsPSR + p_fSt->nToTMBags;
+    nOffered += p_n->nOffered;
+    nRefused += p_n->nRefused;
+    nLeft += queueSize (&(p_n->inbound));
+  }
+  fprintf (fic, "network: %u passengers, %u pieces of luggage, %u passengers handed off between airports "
+           "(%u turned away, %u left waiting)\n", nPass, nBags, nOffered, nRefused, nLeft);
+}
@@ -0,0 +1,103 @@
+/**
+ *  \file network.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Network of airports.
+ *
+ *  Defined operations:
+ *     \li linking an airport to the network
+ *     \li handing off a passenger in transit to the next airport
+ *     \li boarding the passengers handed off by the previous airport
+ *     \li writing the network report.
+ *
+ *  Several airports may be run side by side, each one with its own shared region, semaphore set and intervening
+ *  entities, so that they may be placed on different processors. They make up a ring: the passengers in transit at
+ *  airport a, as they enter the departure terminal, are handed off to airport (a+1) mod A together with their bags,
+ *  which were placed in the storeroom.
+ *
+ *  Every airport has a bounded <em>inbound channel</em>, holding the number of pieces of luggage of each passenger
+ *  handed off to it who has not boarded a plane yet, within a critical region of its own. A passenger who finds it
+ *  full is turned away and her journey ends there, so that the airports never wait for each other. As the very first
+ *  passenger of a plane landing descends from the plane, those in the channel, up to N, take the first seats of the
+ *  flight, whose passengers and plane's hold are generated anew (see <tt>sharedDataFlight</tt>): they have a new
+ *  situation, but carry the same number of pieces of luggage.
+ *
+ *  An airport which stands alone has no channel in use and works as before.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#ifndef NETWORK_H_
+#define NETWORK_H_
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Linking an airport to the network.
+ *
+ *  It must be called by the generator, after the shared region has been initialized and before the intervening
+ *  entities are launched.
+ *
+ *  \param sh pointer to the shared region of the airport
+ *  \param airport airport number
+ *  \param nAirports number of airports in the network
+ *  \param nextKey access key to the shared memory and semaphore set of the next airport
+ *  \param seed seed of the random number generator of the plane landings generated anew at the airport
+ */
+
+extern void netLink (SHARED_DATA *sh, unsigned int airport, unsigned int nAirports, int nextKey, unsigned int seed);
+
+/**
+ *  \brief Handing off a passenger in transit to the next airport.
+ *
+ *  It should be called within the inbound channel critical region of the next airport.
+ *
+ *  \param shNext pointer to the shared region of the next airport
+ *  \param nBags number of pieces of luggage the passenger is carrying
+ *
+ *  \return \c true, if she was put in the inbound channel
+ *  \return \c false, if she was turned away, the channel being full
+ */
+
+extern bool netHandOff (SHARED_DATA *shNext, unsigned int nBags);
+
+/**
+ *  \brief Boarding the passengers handed off by the previous airport.
+ *
+ *  Those in the inbound channel, up to N, take the first seats of plane landing k, which is generated anew. It should
+ *  be called by the very first passenger descending from the plane, within the landing and the inbound channel
+ *  critical regions, before any passenger of the flight has looked at her state. The flight is drawn from the random
+ *  number generator of the airport, seeded anew from the seed kept in the shared region and the landing number, so
+ *  that it does not depend on the passenger process calling it.
+ *
+ *  \param sh pointer to the shared region
+ *  \param k plane landing number
+ *
+ *  \return the number of passengers who have boarded
+ */
+
+extern unsigned int netBoard (SHARED_DATA *sh, unsigned int k);
+
+/**
+ *  \brief Writing the network report.
+ *
+ *  The load of every airport and the traffic over its inbound channel are listed, followed by the totals of the whole
+ *  network.
+ *
+ *  \param fic file descriptor
+ *  \param sh array of pointers to the shared regions of the airports
+ *  \param nAirports number of airports in the network
+ *  \param elapsed time the airports took to carry out their day's work (in ns)
+ */
+
+extern void netReport (FILE *fic, SHARED_DATA *sh[], unsigned int nAirports, unsigned long long elapsed);
+
+#endif /* NETWORK_H_ */
@@ -0,0 +1,165 @@
+/**
+ *  \file options.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  \brief Command line options of the generators.
+ *
+ *  Defined operations:
+ *     \li getting the options.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logSink.h"
+#include "sharedDataSync.h"
+#include "options.h"
+
+/**
+ *  \brief Reading of a positive integer from the command line.
+ *
+ *  The program terminates if the value is not a positive integer.
+ *
+ *  \param opt option letter
+ *  \param arg option argument
+ *
+ *  \return the value
+ */
+
+static unsigned int dimArg (int opt, char *arg)
+{
+  char *tinp;                                                                      /* numerical parameters test flag */
+  long val;                                                                                       /* converted value */
+
+  val = strtol (arg, &tinp, 0);
+  if ((*tinp != '\0') || (val <= 0) || (val > 0x7FFFFFFF))
+     { fprintf (stderr, "invalid value for option -%c: %s\n", opt, arg);
+       exit (EXIT_FAILURE);
+     }
+  return (unsigned int) val;
+}
+
+/**
+ *  \brief Getting the command line options.
+ *
+ *  The options which were not given take their default values. The program terminates, printing the usage line, if
+ *  an option is not valid, and also if an option the engine does not support was given or if the problem dimensions
+ *  are so large that the size of the shared region cannot be represented.
+ *
+ *  \param argc number of command line arguments
+ *  \param argv command line arguments
+ *  \param engine engine of the generator (<tt>process</tt>, <tt>thread</tt> or <tt>des</tt>)
+ *  \param p_opt pointer to the location where the options are to be stored
+ */
+
+void getOptions (int argc, char *argv[], char *engine, OPTIONS *p_opt)
+{
+  DIM dim = { K_DEF, N_DEF, M_DEF, T_DEF, P_DEF, B_DEF, C_DEF, W_DEF };                /* default problem dimensions */
+  int procOpt = 0;                                     /* last option given which only the process engine supports */
+  int c;                                                                                      /* command line option */
+
+  p_opt->dim = dim;
+  p_opt->nAirports = A_DEF;
+  p_opt->pin = false;
+  p_opt->resident = false;
+  p_opt->logLevel = NULL;
+  p_opt->logSel = NULL;
+  p_opt->logPeriod = 1;
+  p_opt->timetable = NULL;
+  p_opt->seed = (unsigned int) getpid ();
+  p_opt->logName = NULL;
+  p_opt->policy = OVW_ASK;
+  p_opt->engine = engine;
+
+  while ((c = getopt (argc, argv, "k:n:m:t:p:d:c:w:a:xl:e:s:b:r:o:O:g:R")) != -1)
+    switch (c)
+    { case 'k': p_opt->dim.k = dimArg (c, optarg);
+                break;
+      case 'n': p_opt->dim.n = dimArg (c, optarg);
+                break;
+      case 'm': p_opt->dim.m = dimArg (c, optarg);
+                break;
+      case 't': p_opt->dim.t = dimArg (c, optarg);
+                break;
+      case 'p': p_opt->dim.p = dimArg (c, optarg);
+                break;
+      case 'd': p_opt->dim.b = dimArg (c, optarg);
+                break;
+      case 'c': p_opt->dim.c = dimArg (c, optarg);
+                break;
+      case 'w': p_opt->dim.w = dimArg (c, optarg);
+                break;
+      case 'a': if ((p_opt->nAirports = dimArg (c, optarg)) > A_MAX)
+                   { fprintf (stderr, "invalid value for option -%c: %s (at most %d airports)\n", c, optarg, A_MAX);
+                     exit (EXIT_FAILURE);
+                   }
+                procOpt = c;
+                break;
+      case 'x': p_opt->pin = true;
+                procOpt = c;
+                break;
+      case 'l': p_opt->logLevel = optarg;
+                break;
+      case 'e': p_opt->logSel = optarg;
+                break;
+      case 's': p_opt->logPeriod = dimArg (c, optarg);
+                break;
+      case 'b': p_opt->timetable = optarg;
+                break;
+      case 'r': p_opt->seed = dimArg (c, optarg);
+                break;
+      case 'o': p_opt->logName = optarg;
+                break;
+      case 'O': if ((p_opt->policy = sinkPolicy (optarg)) == -1)
+                   { fprintf (stderr, "invalid value for option -%c: %s (ask, yes or no)\n", c, optarg);
+                     exit (EXIT_FAILURE);
+                   }
+                break;
+      case 'g': if ((strcmp (optarg, "process") != 0) && (strcmp (optarg, "thread") != 0) &&
+                    (strcmp (optarg, "des") != 0))
+                   { fprintf (stderr, "invalid value for option -%c: %s (process, thread or des)\n", c, optarg);
+                     exit (EXIT_FAILURE);
+                   }
+                if ((strcmp (engine, "process") != 0) && (strcmp (optarg, engine) != 0))
+                   { fprintf (stderr, "invalid value for option -%c: %s (only %s)\n", c, optarg, engine);
+                     exit (EXIT_FAILURE);
+                   }
+                p_opt->engine = optarg;
+                break;
+      case 'R': p_opt->resident = true;
+                procOpt = c;
+                break;
+      default:  fprintf (stderr, "usage: %s [-k landings] [-n passengers] [-m bags] [-t seats] [-p porters] "
+                                 "[-d buses] [-c belts] [-w window] [-l level] [-e entities] [-s period] "
+                                 "[-b timetable] [-r seed] [-o log] [-O ask|yes|no] [-g process|thread|des] "
+                                 "[-a airports] [-x] [-R]\n", argv[0]);
+                exit (EXIT_FAILURE);
+    }
+  if ((procOpt != 0) && (strcmp (p_opt->engine, "process") != 0))
+     { fprintf (stderr, "option -%c needs -g process: the %s engine runs a single airport, not resident and not "
+                "pinned to processors\n", procOpt, p_opt->engine);
+       exit (EXIT_FAILURE);
+     }
+  if (((unsigned long long) p_opt->dim.p + p_opt->dim.b + p_opt->dim.n) * p_opt->nAirports > INT_MAX)
+     { fprintf (stderr, "too many intervening entities: %u porters, %u drivers and %u passengers in %u airports\n",
+                p_opt->dim.p, p_opt->dim.b, p_opt->dim.n, p_opt->nAirports);
+       exit (EXIT_FAILURE);
+     }
+  if (sharedDataSize (&p_opt->dim) == 0)
+     { fprintf (stderr, "problem dimensions too large: the shared region cannot be represented\n");
+       exit (EXIT_FAILURE);
+     }
+  if ((p_opt->logLevel == NULL) && (p_opt->logSel != NULL))
+     p_opt->logLevel = "entity";
+}
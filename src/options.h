@@ -0,0 +1,80 @@
+/**
+ *  \file options.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  \brief Command line options of the generators.
+ *
+ *  Defined operations:
+ *     \li getting the options.
+ *
+ *  The generators of the three engines take the same options, so that the generator of the engine based on
+ *  processes can run any other one in its place with the command line it was given
+ *    \li <tt>-k</tt>, <tt>-n</tt>, <tt>-m</tt>, <tt>-t</tt>, <tt>-p</tt>, <tt>-d</tt>, <tt>-c</tt>, <tt>-w</tt> -
+ *        problem dimensions
+ *    \li <tt>-l</tt>, <tt>-e</tt>, <tt>-s</tt> - states to be saved in the logging file
+ *    \li <tt>-b</tt> - bus timetable
+ *    \li <tt>-r</tt> - random number generator seed
+ *    \li <tt>-o</tt>, <tt>-O</tt> - logging file name and overwrite policy
+ *    \li <tt>-g</tt> - engine (<tt>process</tt>, <tt>thread</tt> or <tt>des</tt>)
+ *    \li <tt>-a</tt>, <tt>-x</tt>, <tt>-R</tt> - network of airports, their placement on processors of their own and
+ *        resident mode, which only the engine based on processes supports.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#ifndef OPTIONS_H_
+#define OPTIONS_H_
+
+#include <stdbool.h>
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Definition of <em>command line options</em> data type.
+ */
+typedef struct
+        { /** \brief problem dimensions */
+          DIM dim;
+          /** \brief number of airports in the network */
+          unsigned int nAirports;
+          /** \brief the airports are placed on processors of their own */
+          bool pin;
+          /** \brief the airport is resident */
+          bool resident;
+          /** \brief logging level (a null pointer, for the default one) */
+          char *logLevel;
+          /** \brief selected entities (a null pointer, if none was selected) */
+          char *logSel;
+          /** \brief logging sample period */
+          unsigned int logPeriod;
+          /** \brief bus timetable (a null pointer, for the default one) */
+          char *timetable;
+          /** \brief random number generator seed */
+          unsigned int seed;
+          /** \brief name of the logging file (a null pointer, if it is to be asked for) */
+          char *logName;
+          /** \brief overwrite policy of the logging file */
+          int policy;
+          /** \brief engine */
+          char *engine;
+        } OPTIONS;
+
+/**
+ *  \brief Getting the command line options.
+ *
+ *  The options which were not given take their default values. The program terminates, printing the usage line, if
+ *  an option is not valid, and also if an option the engine does not support was given or if the problem dimensions
+ *  are so large that the size of the shared region cannot be represented.
+ *
+ *  \param argc number of command line arguments
+ *  \param argv command line arguments
+ *  \param engine engine of the generator (<tt>process</tt>, <tt>thread</tt> or <tt>des</tt>)
+ *  \param p_opt pointer to the location where the options are to be stored
+ */
+
+extern void getOptions (int argc, char *argv[], char *engine, OPTIONS *p_opt);
+
+#endif /* OPTIONS_H_ */
@@ -13,16 +13,44 @@
 #ifndef PROBCONST_H_
 #define PROBCONST_H_
 
-/* Generic parameters */
+/* Generic parameters (default values, they may be overridden on the command line of the generator) */
 
-/** \brief number of plane landings */
-#define  K           5
-/** \brief number of passengers per flight */
-#define  N           6
-/** \brief maximum number of pieces of luggage per passenger */
-#define  M           2
-/** \brief number of seats in the bus */
-#define  T           3
+/** \brief default number of plane landings */
+#define  K_DEF       5
+/** \brief default number of passengers per flight */
+#define  N_DEF       6
+/** \brief default maximum number of pieces of luggage per passenger */
+#define  M_DEF       2
+/** \brief default number of seats in the bus */
+#define  T_DEF       3
+/** \brief default number of porters */
+#define  P_DEF       1
+/** \brief default number of buses (one bus driver each) */
+#define  B_DEF       1
+/** \brief default number of luggage conveyor belts */
+#define  C_DEF       1
+/** \brief default number of flights which may be under way at once (one after the other) */
+#define  W_DEF       1
+/** \brief default number of airports in the network (a single one) */
+#define  A_DEF       1
+/** \brief largest number of airports in the network (each one has its own shared region and semaphore set) */
+#define  A_MAX      16
+/** \brief access key of airport a of a simulation, composed from the generator process identifier and a salt s */
+#define  RUNKEY(pid,s,a) ((int) ((((unsigned int) (pid) & 0x3FFFFF) << 8) | ((s) << 4) | (a)))
+/** \brief number of salts tried before giving up on a key already in use */
+#define  NSALTS     16
+
+/* Bus departure constants */
+
+/** \brief longest time the bus driver waits for the queue to fill up, once someone is queueing (in milliseconds) */
+#define  DEPART_WAIT 100
+
+/** \brief delay past the scheduled time within which a departure still counts as on time, the wake-up of the bus
+ *  driver being never exact (in milliseconds) */
+#define  DEPART_SLACK 1
+
+/** \brief longest headway, wait or slack a timetable may set (one hour, in milliseconds) */
+#define  DEPART_MAX 3600000
 
 /* Porter state constants */
 
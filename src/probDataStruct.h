@@ -16,9 +16,41 @@
 #define PROBDATASTRUCT_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "probConst.h"
 
+/**
+ *  \brief Address of an array stored in the shared region.
+ *
+ *  Arrays whose size depends on the problem dimensions are laid out at run time after the fixed part of the shared
+ *  region. The structure that refers to each one of them keeps its location as a byte offset to the structure own
+ *  address, so that it is valid whatever the address the region is mapped at in each process.
+ */
+#define  SHADDR(p_s,off)     ((void *) ((char *) (p_s) + (off)))
+
+/**
+ *  \brief Definition of <em>dimensions of the problem</em> data type.
+ */
+typedef struct
+        { /** \brief number of plane landings */
+          unsigned int k;
+          /** \brief number of passengers per flight */
+          unsigned int n;
+          /** \brief maximum number of pieces of luggage per passenger */
+          unsigned int m;
+          /** \brief number of seats in the bus */
+          unsigned int t;
+          /** \brief number of porters */
+          unsigned int p;
+          /** \brief number of buses */
+          unsigned int b;
+          /** \brief number of luggage conveyor belts */
+          unsigned int c;
+          /** \brief number of flights which may be under way at once */
+          unsigned int w;
+        } DIM;
+
 /**
  *  \brief Definition of <em>state of the passenger</em> data type.
  */
@@ -42,10 +74,8 @@ typedef struct
  *  \brief Definition of <em>state of the intervening entities</em> data type.
  */
 typedef struct
-        { /** \brief state of the porter */
+        { /** \brief state of the porter (the one who has moved last, if there are several of them) */
           unsigned int porterStat;
-          /** \brief state array of the passengers */
-          STAT_PASSENGER passStat[K][N];
           /** \brief state of the bus driver */
           unsigned int driverStat;
         } STAT;
@@ -60,20 +90,35 @@ typedef struct
 
 /**
  *  \brief Definition of <em>plane load</em> data type.
+ *
+ *  The porters claim the pieces of luggage in the plane's hold by decrementing its number atomically and, once they
+ *  find it empty, count themselves out atomically as well.
  */
 typedef struct
         { /** \brief number of pieces of luggage in the plane's hold */
           unsigned int nBags;
-          /** \brief plane's hold contents */
-          BAG bag[M*N];
+          /** \brief number of porters who have found the plane's hold empty */
+          unsigned int nPortDone;
+          /** \brief offset of the plane's hold contents (M*N bags) */
+          size_t bagOff;
         } LOAD;
 
+/** \brief piece of luggage i in the plane's hold */
+#define  HOLDBAG(p_l,i)      (((BAG *) SHADDR (p_l, (p_l)->bagOff))[i])
+
 /**
  *  \brief Definition of <em>cam of bags</em> data type.
+ *
+ *  Bags are only told apart by the identification of their owner, so the CAM keeps how many bags of each passenger
+ *  are stored instead of the bags themselves.
  */
 typedef struct
-        { /** \brief storage region */
-          BAG mem[M*N];
+        { /** \brief offset of the storage region (number of bags stored per key) */
+          size_t memOff;
+          /** \brief number of keys (N passengers) */
+          unsigned int nKeys;
+          /** \brief maximum number of bags stored */
+          unsigned int size;
           /** \brief number of bags presently stored */
           unsigned int n;
         } CAM;
@@ -82,14 +127,18 @@ typedef struct
  *  \brief Definition of <em>queue of identification</em> data type.
  */
 typedef struct
-        { /** \brief storage region */
-          unsigned int mem[N];
+        { /** \brief offset of the storage region */
+          size_t memOff;
+          /** \brief size of the storage region (at least N identifications) */
+          unsigned int size;
+          /** \brief index mask (size - 1) if size is a power of two, 0 otherwise */
+          unsigned int mask;
           /** \brief insertion pointer */
           unsigned int ii;
           /** \brief retrieval pointer */
           unsigned int ri;
-          /** \brief flag signaling that the queue is full */
-          bool full;
+          /** \brief number of values currently stored */
+          unsigned int n;
         } QUEUE;
 
 /** \brief queue position is empty */
@@ -97,33 +146,113 @@ typedef struct
 
 /**
  *  \brief Definition of <em>participant information for a transfer data</em> data type.
+ *
+ *  There is one per bus, together with the state of its driver and the figures of its rides.
  */
 typedef struct
-        { /** \brief state of occupation of the seats in the bus (empty / identification of the passenger) */
-          int seat[T];
+        { /** \brief offset of the state of occupation of the seats in the bus (empty / identification of the
+           *  passenger)
+           */
+          size_t seatOff;
+          /** \brief number of seats in the bus */
+          unsigned int nSeats;
           /** \brief number of seats presently occupied */
           unsigned int nOccup;
+          /** \brief state of the bus driver */
+          unsigned int driverStat;
+          /** \brief number of departures of the bus */
+          unsigned int nDep;
+          /** \brief total number of passengers who have boarded the bus */
+          unsigned int nPass;
         } TRANSF_INFO;
 
+/** \brief state of occupation of seat i in the bus */
+#define  SEAT(p_b,i)         (((int *) SHADDR (p_b, (p_b)->seatOff))[i])
+
 /** \brief seat is empty */
 #define  EMPTYST     -1
 
+/**
+ *  \brief Definition of <em>logging control</em> data type.
+ *
+ *  It selects which of the states the intervening entities are asked to save are actually saved (see
+ *  <tt>logging.h</tt>).
+ */
+typedef struct
+        { /** \brief logging level */
+          unsigned int level;
+          /** \brief one in every period states passing the level is saved */
+          unsigned int period;
+          /** \brief number of states that have passed the level so far */
+          unsigned int nSel;
+          /** \brief the transitions of the porter are selected */
+          bool porter;
+          /** \brief the transitions of the bus drivers are selected */
+          bool driver;
+          /** \brief offset of the selection flags of the passengers (N) */
+          size_t selOff;
+        } LOGCTL;
+
+/** \brief the transitions of passenger p are selected */
+#define  LOGSEL(p_c,p)       (((bool *) SHADDR (p_c, (p_c)->selOff))[p])
+
+/**
+ *  \brief Definition of <em>bus timetable</em> data type.
+ *
+ *  It sets when the bus departs and keeps track of the departures (see <tt>departure.h</tt>). Times are in
+ *  nanoseconds of a monotonic clock.
+ */
+typedef struct
+        { /** \brief fixed headway between scheduled departures (0, if there is no timetable) */
+          unsigned long long headway;
+          /** \brief longest wait since the first passenger in line queued (0, if unbounded) */
+          unsigned long long maxWait;
+          /** \brief number of queueing passengers the bus departs with, whatever the time */
+          unsigned int load;
+          /** \brief delay past the scheduled time within which a departure is still on time */
+          unsigned long long slack;
+          /** \brief start of the timetable */
+          unsigned long long t0;
+          /** \brief moment the first passenger in line for the present ride queued (0, if nobody is queueing) */
+          unsigned long long firstQ;
+          /** \brief number of departures */
+          unsigned int nDep;
+          /** \brief number of departures triggered by the load threshold ahead of the scheduled time */
+          unsigned int nLoad;
+          /** \brief number of departures after the scheduled time */
+          unsigned int nLate;
+          /** \brief total number of passengers who have boarded */
+          unsigned int nPass;
+          /** \brief sum of the waits of the first passengers in line */
+          unsigned long long waitSum;
+          /** \brief sum of the lateness of the departures against the scheduled time */
+          unsigned long long lateSum;
+          /** \brief largest lateness of a departure against the scheduled time */
+          unsigned long long lateMax;
+        } DEPSCHED;
+
 /**
  *  \brief Definition of <em>full state of the problem</em> data type.
  */
 typedef struct
-        { /** \brief plane landing number */
-          unsigned int nLand;;
+        { /** \brief dimensions of the problem */
+          DIM dim;
+          /** \brief plane landing number (the latest one, if several flights are under way) */
+          unsigned int nLand;
           /** \brief state of the intervening entities */
           STAT st;
-          /** \brief array of manifests for the planes' hold */
-          LOAD plHold[K];
-          /** \brief luggage conveyor belt */
-          CAM convBelt;
+          /** \brief offset of the state array of the passengers (K*N) */
+          size_t passStatOff;
+          /** \brief offset of the array of manifests for the planes' hold (K) */
+          size_t plHoldOff;
+          /** \brief offset of the array of luggage conveyor belts (C) */
+          size_t beltOff;
           /** \brief queue for the transfer ride */
           QUEUE busQueue;
-          /** \brief bus occupation data */
-          TRANSF_INFO bus;
+          /** \brief offset of the array of moments the passengers queued for the transfer ride (N) */
+          size_t qTimeOff;
+          /** \brief offset of the array of bus occupation data (B) */
+          size_t busOff;
           /** \brief total number of passengers for whom the airport was their final destination */
           unsigned int nToTPassFD;
           /** \brief total number of passengers in transit */
@@ -136,6 +265,28 @@ typedef struct
           unsigned int nToTMBags;
           /** \brief driver day's work has ended */
           bool dayEnded;
+          /** \brief logging control */
+          LOGCTL logCtl;
+          /** \brief bus timetable */
+          DEPSCHED dep;
         } FULL_STAT;
 
+/** \brief state of passenger p in plane landing k */
+#define  PASSSTAT(p_fSt,k,p) (((STAT_PASSENGER *) SHADDR (p_fSt, (p_fSt)->passStatOff))[(k)*(p_fSt)->dim.n+(p)])
+
+/** \brief moment passenger p queued for the transfer ride (in ns) */
+#define  QTIME(p_fSt,p)      (((unsigned long long *) SHADDR (p_fSt, (p_fSt)->qTimeOff))[p])
+
+/** \brief manifest for the plane's hold in plane landing k */
+#define  PLHOLD(p_fSt,k)     (((LOAD *) SHADDR (p_fSt, (p_fSt)->plHoldOff))[k])
+
+/** \brief luggage conveyor belt c */
+#define  BELT(p_fSt,c)       (((CAM *) SHADDR (p_fSt, (p_fSt)->beltOff))[c])
+
+/** \brief luggage conveyor belt passenger p collects her bags from */
+#define  BELTOF(p_fSt,p)     ((p) % (p_fSt)->dim.c)
+
+/** \brief occupation data of bus b */
+#define  BUS(p_fSt,b)        (((TRANSF_INFO *) SHADDR (p_fSt, (p_fSt)->busOff))[b])
+
 #endif /* PROBDATASTRUCT_H_ */
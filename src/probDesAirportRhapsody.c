@@ -0,0 +1,1068 @@
+/**
+ *  \file probDesAirportRhapsody.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Discrete-event simulation.
+ *  Implementation with a single thread and a virtual clock.
+ *
+ *  Simulator of the intervening entities. The porters, the bus drivers and the passengers are state machines driven by
+ *  a list of timestamped events: they go through the same transitions and produce the same logging lines as the
+ *  processes of the concurrent version, but the run is not bound to the wall clock.
+ *
+ *  Every operation is carried out atomically, so there is no need for the critical region semaphore. The remaining
+ *  semaphores are simulated: a <em>down</em> on a semaphore in red state parks the entity in the semaphore waiting
+ *  list and an <em>up</em> schedules the first waiting entity to resume at the current time. The departure time of
+ *  the bus scheduled by the timetable (see <tt>departure.h</tt>), in virtual time, is a timer event which takes the
+ *  driver of the bus at the head of the queue of parked buses out of the waiting list of his <tt>waitingDrive</tt>
+ *  semaphore if the load threshold has not been reached by then.
+ *
+ *  The problem dimensions may be set on the command line
+ *    \li <tt>-k</tt> number of plane landings
+ *    \li <tt>-n</tt> number of passengers per flight
+ *    \li <tt>-m</tt> maximum number of pieces of luggage per passenger
+ *    \li <tt>-t</tt> number of seats in the bus
+ *    \li <tt>-p</tt> number of porters
+ *    \li <tt>-d</tt> number of buses, each one with its own driver
+ *    \li <tt>-c</tt> number of luggage conveyor belts, passenger p collecting her bags from belt p mod C
+ *    \li <tt>-w</tt> number of flights which may be under way at once (see <tt>sharedDataSync.h</tt>).
+ *
+ *  The states to be saved in the logging file may be selected as well (see <tt>logging.h</tt>)
+ *    \li <tt>-l</tt> logging level (<tt>off</tt>, <tt>flight</tt>, <tt>entity</tt> or <tt>full</tt>, the default)
+ *    \li <tt>-e</tt> entities whose transitions are saved at level <tt>entity</tt>, which it implies (for instance,
+ *        <tt>po,dr,0-3</tt>)
+ *    \li <tt>-s</tt> only one in every so many states passing the level is saved.
+ *
+ *  The departures of the bus may be scheduled as well (see <tt>departure.h</tt>)
+ *    \li <tt>-b</tt> timetable (for instance, <tt>headway=200,wait=150,load=2</tt>).
+ *
+ *  The random number generator may be seeded as well, so that a run can be repeated
+ *    \li <tt>-r</tt> seed (the process identifier, by default).
+ *
+ *  The logging file and the overwrite policy may be given on the command line as well, so that no question is asked
+ *  (see <tt>logSink.h</tt>)
+ *    \li <tt>-o</tt> name of the logging file
+ *    \li <tt>-O</tt> overwrite policy (<tt>ask</tt>, the default, <tt>yes</tt> or <tt>no</tt>)
+ *    \li <tt>-g</tt> engine (only <tt>des</tt>, as the generator of the engine based on processes runs this one in
+ *        its place when asked to).
+ *
+ *  The options of a network of airports, of their placement on processors and of resident mode (<tt>-a</tt>,
+ *  <tt>-x</tt> and <tt>-R</tt>) are refused, as this engine does not support them (see <tt>options.h</tt>).
+ *
+ *  Upon execution, unless it was given on the command line, one parameter is requested:
+ *    \li name of the logging file (<tt>null</tt>, <tt>-</tt> and <tt>mem:</tt> select the sinks described in
+ *        <tt>logSink.h</tt>).
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "cam.h"
+#include "queue.h"
+#include "departure.h"
+#include "logging.h"
+#include "logSink.h"
+#include "options.h"
+#include "sharedDataSync.h"
+#include "barrier.h"
+#include "event.h"
+
+/** \brief the passenger has this airport as her final destination and has bags to collect */
+#define  FDBTC          0
+
+/** \brief the passenger has this airport as her final destination with no bags to collect */
+#define  FDNBTC         1
+
+/** \brief the passenger is in transit */
+#define  INTRAN         2
+
+/** \brief the passenger has collected all her bags */
+#define  YES            0
+
+/** \brief the passenger has not yet collected all her bags */
+#define  NO             1
+
+/** \brief the passenger has missing bags */
+#define  MB             3
+
+/** \brief identification of porter i */
+#define  PORTER(i)      (i)
+
+/** \brief identification of the driver of bus i */
+#define  DRIVER(i)      ((i)+sh->fSt.dim.p)
+
+/** \brief identification of passenger id */
+#define  PASSENGER(id)  ((id)+sh->fSt.dim.p+sh->fSt.dim.b)
+
+/** \brief identification of the bus driver timer */
+#define  TIMER          PASSENGER (sh->fSt.dim.n)
+
+/** \brief no entity */
+#define  NOENT          ((unsigned int) -1)
+
+/* porter states of the life cycle */
+
+/** \brief the porter is about to take a rest */
+#define  PO_REST        0
+/** \brief the porter is about to try to collect a bag */
+#define  PO_COLLECT     1
+/** \brief the porter is about to carry a bag to the appropriate store */
+#define  PO_CARRY       2
+/** \brief the porter has no more bags to collect */
+#define  PO_NOMORE      3
+
+/* bus driver states of the life cycle */
+
+/** \brief the bus driver is about to check if his day's work has ended */
+#define  DR_CHECK       0
+/** \brief the bus driver is about to announce bus boarding */
+#define  DR_BOARD       1
+/** \brief the bus driver has the passengers on board */
+#define  DR_BOARDED     2
+/** \brief the bus driver has let the passengers off */
+#define  DR_UNLOADED    3
+
+/* passenger states of the life cycle */
+
+/** \brief the passenger is about to descend from the plane */
+#define  PA_LAND        0
+/** \brief the passenger is about to wait for a bag at the luggage collection point */
+#define  PA_COLLECT     1
+/** \brief the passenger has been called by the porter */
+#define  PA_CALLED      2
+/** \brief the passenger is about to go home */
+#define  PA_HOME        3
+/** \brief the passenger is about to take a bus */
+#define  PA_BUS         4
+/** \brief the passenger has been summoned to board the bus */
+#define  PA_BOARD       5
+/** \brief the passenger has been summoned to leave the bus */
+#define  PA_ALIGHT      6
+/** \brief the passenger is done with the current flight */
+#define  PA_NEXT        7
+
+/**
+ *  \brief Definition of <em>simulated semaphore</em> data type.
+ */
+typedef struct
+        { /** \brief counter */
+          unsigned int val;
+          /** \brief first entity in the waiting list */
+          unsigned int head;
+          /** \brief last entity in the waiting list */
+          unsigned int tail;
+        } SIMSEM;
+
+/**
+ *  \brief Definition of <em>entity</em> data type.
+ */
+typedef struct
+        { /** \brief state of the life cycle */
+          unsigned int pc;
+          /** \brief plane landing number */
+          unsigned int k;
+          /** \brief piece of luggage being processed (porter only) */
+          BAG bag;
+          /** \brief the porter was the last one to find the plane's hold empty (porter only) */
+          bool last;
+          /** \brief next entity in a semaphore waiting list */
+          unsigned int next;
+          /** \brief the life cycle has come to an end */
+          bool done;
+        } ENTITY;
+
+/** \brief logging file name */
+static char nFic[51];
+
+/** \brief pointer to the shared data structure */
+static SHARED_DATA *sh;
+
+/** \brief simulated semaphores */
+static SIMSEM *sem;
+
+/** \brief intervening entities */
+static ENTITY *ent;
+
+/** \brief identifications of the passengers summoned to board the bus (T entries) */
+static unsigned int *boardId;
+
+/** \brief event list */
+static EVLIST evl;
+
+/** \brief virtual clock (in microseconds) */
+static unsigned long long now;
+
+/** \brief departure time of the bus (0, if nobody is queueing) */
+static unsigned long long depTime;
+
+/** \brief there is a timer event in the event list */
+static bool timerSet;
+
+/** \brief bus whose driver is waiting on his <tt>waitingDrive</tt> semaphore up to the departure time (<tt>NOENT</tt>,
+ *  if none) */
+static unsigned int timedBus;
+
+/**
+ *  \brief Scheduling of an entity to resume its life cycle at the current time.
+ *
+ *  \param e entity identification
+ */
+
+static void schedule (unsigned int e)
+{
+  if (!evIn (&evl, now, e))
+     { perror ("error on the insertion of an event");
+       exit (EXIT_FAILURE);
+     }
+}
+
+/**
+ *  \brief <em>Down</em> of a simulated semaphore.
+ *
+ *  If the semaphore is in red state, the entity is appended to its waiting list and must suspend its life cycle. It
+ *  will be scheduled again by the <em>up</em> that lets it through.
+ *
+ *  \param s semaphore identification
+ *  \param e entity identification
+ *
+ *  \return \c true, if the entity may proceed
+ *  \return \c false, if it must suspend its life cycle
+ */
+
+static bool simDown (unsigned int s, unsigned int e)
+{
+  if (sem[s].val > 0)
+     { sem[s].val -= 1;
+       return true;
+     }
+  ent[e].next = NOENT;
+  if (sem[s].head == NOENT)
+     sem[s].head = e;
+     else ent[sem[s].tail].next = e;
+  sem[s].tail = e;
+  return false;
+}
+
+/**
+ *  \brief <em>Up</em> of a simulated semaphore.
+ *
+ *  \param s semaphore identification
+ */
+
+static void simUp (unsigned int s)
+{
+  unsigned int e;                                                                            /* entity to be resumed */
+
+  if ((e = sem[s].head) == NOENT)
+     sem[s].val += 1;
+     else { sem[s].head = ent[e].next;
+            schedule (e);
+          }
+}
+
+/**
+ *  \brief Saving the state, if it is selected by the logging control.
+ *
+ *  \param k flight number
+ *  \param who entity saving the state (passenger identification, <tt>LOGPORTER</tt>, <tt>LOGDRIVER</tt> or
+ *         <tt>LOGSUMMARY</tt>)
+ */
+
+static void logState (unsigned int k, unsigned int who)
+{
+  if (logSample (&(sh->fSt), who))
+     saveState (nFic, k, &(sh->fSt));
+}
+
+/* porter operations */
+
+/**
+ *  \brief Try to collect a bag.
+ *
+ *  The porter goes to the plane's hold and checks if there are bags still left to be collected. If so, he picks up one
+ *  and leaves. If not, and he is the last porter to find the hold empty, before leaving, he informs the passengers who
+ *  may be still waiting that there are no more bags left.
+ *
+ *  State should be saved, unless he has found the hold empty and is not the last porter to do so: the porter state
+ *  is shared by all of them, and the others may still be at work.
+ *
+ *  \param k plane landing number
+ *  \param p_bag pointer to the location where the retrieved bag should be stored
+ *  \param p_last pointer to the location where it is stored whether he was the last porter to find the hold empty
+ *
+ *  \return \c true, if he has picked up a bag
+ *  \return \c false, otherwise
+ */
+
+static bool tryToCollectABag (unsigned int k, BAG *p_bag, bool *p_last)
+{
+  bool ret = false;                                                                           /* a bag was picked up */
+  unsigned int c, i;                                                                           /* counting variables */
+
+  if (PLHOLD (&(sh->fSt), k).nBags != 0)
+     { *p_bag = HOLDBAG (&PLHOLD (&(sh->fSt), k), PLHOLD (&(sh->fSt), k).nBags - 1);
+       PLHOLD (&(sh->fSt), k).nBags -= 1;
+       ret = true;
+     }
+  *p_last = !ret && (++PLHOLD (&(sh->fSt), k).nPortDone == sh->fSt.dim.p);
+  if (*p_last)
+     for (c = 0; c < sh->fSt.dim.c; c++)                                             /* going over the belts in turn */
+       for (i = c; i < sh->fSt.dim.n; i += sh->fSt.dim.c)
+         if ((PASSSTAT (&(sh->fSt), k, i).sit == FD) &&
+             ((PASSSTAT (&(sh->fSt), k, i).nBagsAct + NCALLS (sh, i)) < PASSSTAT (&(sh->fSt), k, i).nBagsReal))
+            { simUp (PASSSEM (sh, i));                                        /* inform the passenger of missing bags */
+              NCALLS (sh, i) += 1;
+            }
+  if (!ret && !*p_last)                                                /* the state is left to those still at work */
+     return ret;
+  sh->fSt.st.porterStat = AT_THE_PLANES_HOLD;
+  logState (k, LOGPORTER);
+  return ret;
+}
+
+/**
+ *  \brief Carry it to the appropriate store.
+ *
+ *  The porter checks the bag identification. If it is unknown, he issues an error message.
+ *  He then checks the passenger flight situation. If she has this airport as her final destination, he deposits the
+ *  bag on the belt conveyor she collects from and informs her. Otherwise, he takes the bag to the storeroom for
+ *  temporary storage. He also updates statistical data in both cases.
+ *
+ *  State should be saved.
+ *
+ *  \param k plane landing number
+ *  \param p_bag pointer to the location where the retrieved bag is stored
+ */
+
+static void carryItToAppropriateStore (unsigned int k, BAG *p_bag)
+{
+  if (p_bag->id >= sh->fSt.dim.n)
+     { perror ("ID Unknown");
+       exit (EXIT_FAILURE);
+     }
+  if (PASSSTAT (&(sh->fSt), k, p_bag->id).sit == FD)
+     { sh->fSt.nToTBagsPCB += 1;
+       NCALLS (sh, p_bag->id) += 1;
+       camIn (&BELT (&(sh->fSt), BELTOF (&(sh->fSt), p_bag->id)), p_bag->id);
+       sh->fSt.st.porterStat = AT_THE_LUGGAGE_BELT_CONVEYOR;
+       logState (k, LOGPORTER);
+       simUp (PASSSEM (sh, p_bag->id));                                                      /* inform the passenger */
+     }
+     else if (PASSSTAT (&(sh->fSt), k, p_bag->id).sit == TRT)
+             { sh->fSt.nToTBagsPSR += 1;
+               sh->fSt.st.porterStat = AT_THE_STOREROOM;
+               logState (k, LOGPORTER);
+             }
+             else printf ("Error Situation");
+}
+
+/**
+ *  \brief No more bags to collect.
+ *
+ *  The porter goes back to his office.
+ *
+ *  State should be saved, and the summary of the flight with it, by the last porter to find the hold empty only.
+ *
+ *  \param k plane landing number
+ *  \param last the porter was the last one to find the hold empty
+ */
+
+static void noMoreBagsToCollect (unsigned int k, bool last)
+{
+  if (!last) return;
+  sh->fSt.st.porterStat = WAITING_FOR_A_PLANE_TO_LAND;
+  logState (k, LOGSUMMARY);
+}
+
+/* bus driver operations */
+
+/**
+ *  \brief Announcing bus boarding.
+ *
+ *  The bus driver checks if the queue is empty. If it is, he issues an error message.
+ *  He then proceeds to summon passengers in the queue to board his bus. If some passenger identity is unknown, he
+ *  issues an error message. His bus leaves the queue of parked buses and, if another one is parked, its driver is told
+ *  it is his turn.
+ *
+ *  No state should be saved.
+ *
+ *  \param b bus identification
+ */
+
+static void announcingBusBoarding (unsigned int b)
+{
+  unsigned int i, n;                                           /* counting variable and number of summoned passengers */
+  unsigned int next;                                                                 /* bus leaving the parked queue */
+
+  if (queueEmpty (&sh->fSt.busQueue))
+     { perror ("the bus queue is already empty");
+       exit (EXIT_FAILURE);
+     }
+  n = queueOutN (&sh->fSt.busQueue, boardId, sh->fSt.dim.t);                             /* up to a busload in one go */
+  NPASSD (sh, b) += n;
+  depDepart (&(sh->fSt), now * 1000ULL, n, b);
+  queueOut (&sh->parkQueue, &next);
+  if (!queueEmpty (&sh->parkQueue))
+     simUp (DRIVESEM (sh, queuePeek (&sh->parkQueue, 0)));                        /* the bus next in line takes over */
+  for (i = 0; i < n; i++)
+  { if (boardId[i] >= sh->fSt.dim.n)
+       { perror ("passenger identity unknown");
+         exit (EXIT_FAILURE);
+       }
+    PASSBUS (sh, boardId[i]) = b;
+    simUp (PASSSEM (sh, boardId[i]));                                                        /* summon the passenger */
+  }
+}
+
+/**
+ *  \brief Go to departure terminal.
+ *
+ *  The bus driver takes the bus to the departure transfer terminal.
+ *
+ *  State should be saved.
+ *
+ *  \param b bus identification
+ */
+
+static void goToDepartureTerminal (unsigned int b)
+{
+  BUS (&(sh->fSt), b).driverStat = DRIVING_FORWARD;
+  logState (sh->fSt.nLand, LOGDRIVER);
+}
+
+/**
+ *  \brief Park the bus and let passengers off.
+ *
+ *  The bus driver checks if the bus is empty or overcrowded. If it is, he issues an error message.
+ *  He then proceeds to summon passengers in the bus to exit. If some passenger identity is unknown, he
+ *  issues an error message.
+ *
+ *  State should be saved.
+ *
+ *  \param b bus identification
+ */
+
+static void parkTheBusAndLetPassOff (unsigned int b)
+{
+  TRANSF_INFO *bus = &BUS (&(sh->fSt), b);                                                                /* the bus */
+  unsigned int i;                                                                               /* counting variable */
+
+  bus->driverStat = PARKING_AT_THE_DEPARTURE_TERMINAL;
+  if ((bus->nOccup > sh->fSt.dim.t) || (bus->nOccup == 0))
+     { perror ("Bus is Empty or OverCrowded");
+       exit (EXIT_FAILURE);
+     }
+  for (i = 0; i < bus->nOccup; i++)
+  { if ((SEAT (bus, i) < 0) || ((unsigned int) SEAT (bus, i) >= sh->fSt.dim.n))
+       { perror ("Invalid ID");
+         exit (EXIT_FAILURE);
+       }
+    NPASSD (sh, b) += 1;
+    simUp (PASSSEM (sh, SEAT (bus, i)));                                                     /* summon the passenger */
+  }
+  logState (sh->fSt.nLand, LOGDRIVER);
+}
+
+/**
+ *  \brief Go to arrival terminal.
+ *
+ *  The bus driver takes the bus back to the arrival transfer terminal.
+ *
+ *  State should be saved.
+ *
+ *  \param b bus identification
+ */
+
+static void goToArrivalTerminal (unsigned int b)
+{
+  BUS (&(sh->fSt), b).driverStat = DRIVING_BACKWARD;
+  logState (sh->fSt.nLand, LOGDRIVER);
+}
+
+/**
+ *  \brief Park the bus.
+ *
+ *  The bus driver parks the bus at the arrival transfer terminal, at the tail of the queue of parked buses.
+ *
+ *  State should be saved.
+ *
+ *  \param b bus identification
+ */
+
+static void parkTheBus (unsigned int b)
+{
+  queueIn (&sh->parkQueue, b);
+  BUS (&(sh->fSt), b).driverStat = PARKING_AT_THE_ARRIVAL_TERMINAL;
+  logState (sh->fSt.nLand, LOGDRIVER);
+}
+
+/* passenger operations */
+
+/**
+ *  \brief What should I do.
+ *
+ *  The passenger descending from the plane decides what should she do according to her situation and updates
+ *  statistical information. If she is the very last passenger descending from the plane, she must inform the porter
+ *  that a new plane has landed. If she is the very first passenger, she sets the number of the plane landing.
+ *
+ *  State should only be saved by the very first passenger descending from the plane.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ *
+ *  \return \c FDBTC, if she has this airport as her final destination and has bags to collect
+ *  \return \c FDNBTC, if she has this airport as her final destination with no bags to collect
+ *  \return \c INTRAN, if she is in transit
+ */
+
+static unsigned int whatShouldIDo (unsigned int k, unsigned int id)
+{
+  unsigned int stat = INTRAN;                                                                 /* passenger situation */
+  unsigned int i;                                                                               /* counting variable */
+
+  NPASSP (sh, k) += 1;
+  PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_DISEMBARKING_ZONE;
+  if (PASSSTAT (&(sh->fSt), k, id).sit == TRT)
+     sh->fSt.nToTPassTST += 1;
+     else { sh->fSt.nToTPassFD += 1;
+            stat = (PASSSTAT (&(sh->fSt), k, id).nBagsReal == 0) ? FDNBTC : FDBTC;
+          }
+  if (NPASSP (sh, k) == 1)
+     { sh->fSt.nLand = k;
+       logState (k, id);
+     }
+  if (NPASSP (sh, k) == sh->fSt.dim.n)
+     { NPASSP (sh, k) = 0;
+       for (i = 0; i < sh->fSt.dim.p; i++)
+         simUp (PORTSEM (sh, i));                                           /* inform the porters a plane has landed */
+     }
+  return stat;
+}
+
+/**
+ *  \brief Go collect a bag (before waiting for a call from the porter).
+ *
+ *  State is saved only if there is a change of state of the passenger.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ */
+
+static void goCollectABag (unsigned int k, unsigned int id)
+{
+  if (PASSSTAT (&(sh->fSt), k, id).stat == AT_THE_DISEMBARKING_ZONE)
+     { PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_LUGGAGE_COLLECTION_POINT;
+       logState (k, id);
+     }
+}
+
+/**
+ *  \brief Go collect a bag (after receiving a call from the porter).
+ *
+ *  The passenger checks if there is a bag on the belt conveyor she collects from that belongs to her. If so, she picks
+ *  it up and updates the number of bags already recovered. Upon exit, a decision is taken about her present situation.
+ *
+ *  State should be saved.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ *
+ *  \return \c YES, if she has collected all her bags
+ *  \return \c NO, if she has not yet collected all her bags
+ *  \return \c MB, if she has missing bags
+ */
+
+static unsigned int pickUpABag (unsigned int k, unsigned int id)
+{
+  CAM *belt = &BELT (&(sh->fSt), BELTOF (&(sh->fSt), id));                      /* belt conveyor she collects from */
+
+  NCALLS (sh, id) -= 1;
+  if (!camEmpty (belt) && camSearch (belt, id))
+     { camOut (belt, id);
+       PASSSTAT (&(sh->fSt), k, id).nBagsAct += 1;
+       logState (k, id);
+       return (PASSSTAT (&(sh->fSt), k, id).nBagsAct < PASSSTAT (&(sh->fSt), k, id).nBagsReal) ? NO : YES;
+     }
+  logState (k, id);
+  return (PASSSTAT (&(sh->fSt), k, id).nBagsAct < PASSSTAT (&(sh->fSt), k, id).nBagsReal) ? MB : YES;
+}
+
+/**
+ *  \brief Report missing bags.
+ *
+ *  The passenger fills the form for missing bags.
+ *
+ *  State should be saved.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ */
+
+static void reportMissingBags (unsigned int k, unsigned int id)
+{
+  PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_BAGGAGE_RECLAIM_OFFICE;
+  logState (k, id);
+}
+
+/**
+ *  \brief Leaving the arrival area (go home / prepare next leg).
+ *
+ *  The passenger either exits the airport or enters the departure terminal. If she is the last passenger of the
+ *  flight to be ready to do so, she wakes up the passengers waiting for it to be over and, if it is the very last
+ *  flight, the bus drivers' day's work is finished.
+ *
+ *  State should be saved.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ *  \param stat new passenger state
+ *  \param p_sense pointer to the location where the sense to wait on at the end-of-flight barrier is to be stored
+ *
+ *  \return \c true, if she may go on
+ *  \return \c false, if she must wait for an earlier flight to be over (her own, with a window of one flight)
+ */
+
+static bool leaveArrival (unsigned int k, unsigned int id, unsigned int stat, unsigned int *p_sense)
+{
+  unsigned int i, b;                                                                           /* counting variables */
+  unsigned int bst, nRel;                                /* status of the arrival and number of passengers released */
+
+  PASSSTAT (&(sh->fSt), k, id).stat = stat;
+  if ((bst = barrierArrive (&(sh->flightEnd), k, p_sense, &nRel)) != BARRIER_WAIT)
+     { for (i = 0; i < nRel; i++)
+         simUp (BARRIERSEM (&(sh->flightEnd), *p_sense));               /* those waiting for the flight are released */
+       if (bst == BARRIER_FINAL)
+          { sh->fSt.dayEnded = true;
+            for (b = 0; b < sh->fSt.dim.b; b++)
+              simUp (DRIVESEM (sh, b));                      /* the drivers may be sleeping on the empty queue */
+          }
+     }
+  logState (k, id);
+  return (bst != BARRIER_WAIT);
+}
+
+/**
+ *  \brief Take a bus.
+ *
+ *  The transit passenger queues at the arrival transfer terminal to take a bus to the departure transfer terminal.
+ *  She informs the driver of the bus at the head of the queue of parked buses, if any, it is time to start boarding if
+ *  the number of queueing passengers reaches the load threshold, or that he should start counting down to departure if
+ *  she is the first one in line.
+ *
+ *  State should be saved.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ */
+
+static void takeABus (unsigned int k, unsigned int id)
+{
+  PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_ARRIVAL_TRANSFER_TERMINAL;
+  queueIn (&sh->fSt.busQueue, id);
+  if (depQueued (&(sh->fSt), id, now * 1000ULL) && !queueEmpty (&sh->parkQueue))
+     simUp (DRIVESEM (sh, queuePeek (&sh->parkQueue, 0)));
+  logState (k, id);
+}
+
+/**
+ *  \brief Enter the bus.
+ *
+ *  The passenger enters the bus she has been handed to and occupies an available seat. If it is already packed full,
+ *  she issues an error message. If she is the last one to board the bus for the ride, she informs the driver he may
+ *  start the journey.
+ *
+ *  State should be saved.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ */
+
+static void enterTheBus (unsigned int k, unsigned int id)
+{
+  unsigned int b = PASSBUS (sh, id);                                                                  /* her bus */
+  TRANSF_INFO *bus = &BUS (&(sh->fSt), b);
+  unsigned int i;                                                                               /* counting variable */
+
+  if (bus->nOccup == sh->fSt.dim.t)
+     { perror ("error, the bus is full");
+       exit (EXIT_FAILURE);
+     }
+  PASSSTAT (&(sh->fSt), k, id).stat = TERMINAL_TRANSFER;
+  NPASSD (sh, b) -= 1;
+  for (i = 0; i < sh->fSt.dim.t; i++)
+    if (SEAT (bus, i) == EMPTYST)
+       { SEAT (bus, i) = id;
+         bus->nOccup += 1;
+         break;
+       }
+  if (NPASSD (sh, b) == 0)
+     simUp (WPASSSEM (sh, b));
+  logState (k, id);
+}
+
+/**
+ *  \brief Leave the bus.
+ *
+ *  The passenger checks the bus occupation. If it is already empty, she issues an error message. She then leaves the
+ *  bus and, if she is the last one to exit, she informs the driver he may start the journey back.
+ *
+ *  State should be saved.
+ *
+ *  \param k plane landing number
+ *  \param id passenger identification
+ */
+
+static void leaveTheBus (unsigned int k, unsigned int id)
+{
+  unsigned int b = PASSBUS (sh, id);                                                                  /* her bus */
+  TRANSF_INFO *bus = &BUS (&(sh->fSt), b);
+  unsigned int i;                                                                               /* counting variable */
+
+  if (bus->nOccup == 0)
+     { perror ("error, the bus is already empty");
+       exit (EXIT_FAILURE);
+     }
+  PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_DEPARTURE_TRANSFER_TERMINAL;
+  for (i = 0; i < sh->fSt.dim.t; i++)
+    if (SEAT (bus, i) == (int) id)
+       { SEAT (bus, i) = EMPTYST;
+         bus->nOccup -= 1;
+         break;
+       }
+  NPASSD (sh, b) -= 1;
+  if (NPASSD (sh, b) == 0)
+     simUp (WPASSSEM (sh, b));
+  logState (k, id);
+}
+
+/* life cycles */
+
+/**
+ *  \brief Porter life cycle, run until the porter has to wait.
+ *
+ *  \param i porter identification
+ */
+
+static void porterStep (unsigned int i)
+{
+  ENTITY *e = &ent[PORTER (i)];                                                                        /* the porter */
+
+  for (;;)
+    switch (e->pc)
+    { case PO_REST:
+        if (e->k == sh->fSt.dim.k)
+           { e->done = true;
+             return;
+           }
+        e->pc = PO_COLLECT;
+        if (!simDown (PORTSEM (sh, i), PORTER (i))) return;                   /* the porter waits for a plane to land */
+        break;
+      case PO_COLLECT:
+        e->pc = tryToCollectABag (e->k, &e->bag, &e->last) ? PO_CARRY : PO_NOMORE;
+        break;
+      case PO_CARRY:
+        carryItToAppropriateStore (e->k, &e->bag);
+        e->pc = PO_COLLECT;
+        break;
+      case PO_NOMORE:
+        noMoreBagsToCollect (e->k, e->last);
+        e->k += 1;
+        e->pc = PO_REST;
+        break;
+    }
+}
+
+/**
+ *  \brief Bus driver life cycle, run until the bus driver has to wait.
+ *
+ *  \param b bus identification
+ */
+
+static void driverStep (unsigned int b)
+{
+  ENTITY *e = &ent[DRIVER (b)];                                                                    /* the bus driver */
+
+  for (;;)
+    switch (e->pc)
+    { case DR_CHECK:
+        if (timedBus == b) timedBus = NOENT;
+        if (sh->fSt.dayEnded)
+           { e->done = true;
+             return;
+           }
+        if ((queuePeek (&sh->parkQueue, 0) != (int) b) ||         /* sleep until it is his turn and someone queues, */
+            queueEmpty (&sh->fSt.busQueue))                                           /* or the day's work is over */
+           { if (!simDown (DRIVESEM (sh, b), DRIVER (b))) return;
+             break;
+           }
+        depTime = (depDeadline (&(sh->fSt)) + 999) / 1000;             /* scheduled departure, which never moves back */
+        if (!timerSet)
+           { if (!evIn (&evl, depTime, TIMER))
+                { perror ("error on the insertion of an event");
+                  exit (EXIT_FAILURE);
+                }
+             timerSet = true;
+           }
+        if ((queueSize (&sh->fSt.busQueue) < sh->fSt.dep.load) && (now < depTime))
+           { timedBus = b;                                /* wait for the queue to fill up or the departure time */
+             if (!simDown (DRIVESEM (sh, b), DRIVER (b))) return;
+             break;
+           }
+        depTime = 0;
+        e->pc = DR_BOARD;
+        break;
+      case DR_BOARD:
+        announcingBusBoarding (b);
+        e->pc = DR_BOARDED;
+        if (!simDown (WPASSSEM (sh, b), DRIVER (b))) return;                 /* wait for the boarding to be complete */
+        break;
+      case DR_BOARDED:
+        goToDepartureTerminal (b);
+        parkTheBusAndLetPassOff (b);
+        e->pc = DR_UNLOADED;
+        if (!simDown (WPASSSEM (sh, b), DRIVER (b))) return;                     /* wait for the exit to be complete */
+        break;
+      case DR_UNLOADED:
+        goToArrivalTerminal (b);
+        parkTheBus (b);
+        e->pc = DR_CHECK;
+        break;
+    }
+}
+
+/**
+ *  \brief Passenger life cycle, run until the passenger has to wait.
+ *
+ *  \param p passenger identification
+ */
+
+static void passengerStep (unsigned int p)
+{
+  ENTITY *e = &ent[PASSENGER (p)];                                                                  /* the passenger */
+  unsigned int sense;                                             /* sense to wait on at the end-of-flight barrier */
+
+  for (;;)
+    switch (e->pc)
+    { case PA_LAND:
+        if (e->k == sh->fSt.dim.k)
+           { e->done = true;
+             return;
+           }
+        switch (whatShouldIDo (e->k, p))
+        { case FDBTC:  e->pc = PA_COLLECT;
+                       break;
+          case FDNBTC: e->pc = PA_HOME;
+                       break;
+          default:     e->pc = PA_BUS;
+        }
+        break;
+      case PA_COLLECT:
+        goCollectABag (e->k, p);
+        e->pc = PA_CALLED;
+        if (!simDown (PASSSEM (sh, p), PASSENGER (p))) return;            /* wait until a call from the porter comes */
+        break;
+      case PA_CALLED:
+        switch (pickUpABag (e->k, p))
+        { case NO:  e->pc = PA_COLLECT;
+                    break;
+          case MB:  reportMissingBags (e->k, p);
+                    e->pc = PA_HOME;
+                    break;
+          default:  e->pc = PA_HOME;
+        }
+        break;
+      case PA_HOME:
+        e->pc = PA_NEXT;
+        if (!leaveArrival (e->k, p, EXITING_THE_ARRIVAL_TERMINAL, &sense) &&
+            !simDown (BARRIERSEM (&(sh->flightEnd), sense), PASSENGER (p)))
+           return;                                                          /* wait for an earlier flight to be over */
+        break;
+      case PA_BUS:
+        takeABus (e->k, p);
+        e->pc = PA_BOARD;
+        if (!simDown (PASSSEM (sh, p), PASSENGER (p))) return;                                      /* wait her turn */
+        break;
+      case PA_BOARD:
+        enterTheBus (e->k, p);
+        e->pc = PA_ALIGHT;
+        if (!simDown (PASSSEM (sh, p), PASSENGER (p))) return;             /* wait for the bus to reach the terminal */
+        break;
+      case PA_ALIGHT:
+        leaveTheBus (e->k, p);
+        e->pc = PA_NEXT;
+        if (!leaveArrival (e->k, p, ENTERING_THE_DEPARTURE_TERMINAL, &sense) &&
+            !simDown (BARRIERSEM (&(sh->flightEnd), sense), PASSENGER (p)))
+           return;                                                          /* wait for an earlier flight to be over */
+        break;
+      case PA_NEXT:
+        e->k += 1;
+        e->pc = PA_LAND;
+        break;
+    }
+}
+
+/**
+ *  \brief Bus driver timer.
+ *
+ *  At the departure time, the driver of the bus at the head of the queue of parked buses is taken out of the waiting
+ *  list of his <tt>waitingDrive</tt> semaphore, if he is still waiting for the queue to fill up. If the departure time
+ *  has been set again in the meantime, the timer event is moved to it. Nothing else is scheduled, so the simulation
+ *  ends when the entities have nothing left to do.
+ */
+
+static void timerStep (void)
+{
+  timerSet = false;
+  if (depTime == 0) return;                                                               /* the bus has already left */
+  if (now < depTime)
+     { if (!evIn (&evl, depTime, TIMER))
+          { perror ("error on the insertion of an event");
+            exit (EXIT_FAILURE);
+          }
+       timerSet = true;
+       return;
+     }
+  if ((timedBus != NOENT) && (sem[DRIVESEM (sh, timedBus)].head == DRIVER (timedBus)))     /* the only one there */
+     { sem[DRIVESEM (sh, timedBus)].head = sem[DRIVESEM (sh, timedBus)].tail = NOENT;
+       schedule (DRIVER (timedBus));
+       timedBus = NOENT;
+     }
+}
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is running the simulation by processing the events in chronological order up to the moment there are no
+ *  more events.
+ */
+
+int main (int argc, char *argv[])
+{
+  unsigned int e, s, nEnt;                                                      /* counting variables and dimensions */
+  EVENT ev;                                                                                         /* current event */
+  unsigned long long nEv = 0;                                                          /* number of processed events */
+  struct timespec t0, t1;                                                                   /* wall clock time marks */
+  double wall;                                                                          /* wall clock time (seconds) */
+  OPTIONS opt;                                                                               /* command line options */
+
+  /* getting the options */
+
+  getOptions (argc, argv, "des", &opt);
+
+  /* getting logging file name */
+
+  if (!sinkChoose (nFic, opt.logName, opt.policy))
+     return EXIT_FAILURE;
+
+  /* creating and initializing the shared data, the simulated semaphores, the entities and the logging file */
+
+  nEnt = opt.dim.p + opt.dim.b + opt.dim.n;
+  if (((sh = calloc (1, sharedDataSize (&opt.dim))) == NULL) ||
+      ((sem = malloc ((SEM_NU (opt.dim.n, opt.dim.p, opt.dim.b, opt.dim.c, opt.dim.w) + 1)
+                      * sizeof (SIMSEM))) == NULL) ||
+      ((ent = calloc (nEnt, sizeof (ENTITY))) == NULL) ||
+      ((boardId = malloc (opt.dim.t * sizeof (unsigned int))) == NULL) || !evInit (&evl, nEnt + 1))
+     { perror ("error on allocating the simulation data");
+       return EXIT_FAILURE;
+     }
+
+  srandom (opt.seed);                                                          /* initialize random number generator */
+
+  sharedDataInit (sh, &opt.dim);                                           /* lay out and initialize the shared data */
+  if (!logSetup (&(sh->fSt), opt.logLevel, opt.logSel, opt.logPeriod))              /* select the states to be saved */
+     { fprintf (stderr, "invalid logging level or list of entities\n");
+       return EXIT_FAILURE;
+     }
+  if (!depSetup (&(sh->fSt), opt.timetable, 0))                                          /* set up the bus timetable */
+     { fprintf (stderr, "invalid bus timetable\n");
+       return EXIT_FAILURE;
+     }
+
+  sinkSetup (nFic);                                                                      /* resolve the logging sink */
+  createLog (nFic, &opt.dim);                                                             /* create the logging file */
+
+  for (s = 0; s <= SEM_NU (opt.dim.n, opt.dim.p, opt.dim.b, opt.dim.c, opt.dim.w); s++)    /* all semaphores are set to
+                                                                                                        red state */
+  { sem[s].val = 0;
+    sem[s].head = sem[s].tail = NOENT;
+  }
+  for (s = LANDACCESS; s <= STATSACCESS; s++)                                        /* but the critical region ones */
+    sem[s].val = 1;
+  for (s = 0; s < opt.dim.c; s++)                                                   /* including the conveyor belts' */
+    sem[BELTSEM (sh, s)].val = 1;
+  sem[INACCESS].val = 1;                                                                /* and the inbound channel's */
+  depTime = 0;
+  timerSet = false;
+  timedBus = NOENT;
+
+  /* scheduling the start of the life cycle of the intervening entities */
+
+  now = 0;
+  for (e = 0; e < nEnt; e++)
+  { ent[e].pc = 0;
+    ent[e].k = 0;
+    ent[e].next = NOENT;
+    ent[e].done = false;
+    schedule (e);
+  }
+  /* processing the events in chronological order */
+
+  clock_gettime (CLOCK_MONOTONIC, &t0);
+  while (!evEmpty (&evl))
+  { evOut (&evl, &ev);
+    now = ev.time;
+    nEv += 1;
+    if (ev.ent < DRIVER (0))
+       porterStep (ev.ent - PORTER (0));
+       else if (ev.ent < PASSENGER (0))
+               driverStep (ev.ent - DRIVER (0));
+               else if (ev.ent < nEnt)
+                       passengerStep (ev.ent - PASSENGER (0));
+                       else timerStep ();
+  }
+  clock_gettime (CLOCK_MONOTONIC, &t1);
+  wall = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+  /* checking for the termination of all intervening entities */
+
+  printf ("\nFinal report\n");
+  for (e = 0; e < nEnt; e++)
+    if (!ent[e].done)
+       { if (e < DRIVER (0))
+            fprintf (stderr, "porter, with id %u, has not terminated (state %u)\n", e - PORTER (0), ent[e].pc);
+            else if (e < PASSENGER (0))
+                    fprintf (stderr, "bus driver, with id %u, has not terminated (state %u)\n", e - DRIVER (0),
+                             ent[e].pc);
+                    else fprintf (stderr, "passenger, with id %u, has not terminated (state %u)\n", e - PASSENGER (0),
+                                  ent[e].pc);
+         return EXIT_FAILURE;
+       }
+  printf ("all intervening entities have terminated\n");
+  printf ("virtual time: %.3f s, events: %llu, wall clock time: %.3f s, passenger journeys per second: %.0f\n",
+          now / 1e6, nEv, wall, (wall > 0) ? (double) opt.dim.k * opt.dim.n / wall : 0.0);
+
+  /* print final report */
+
+  finalReport (nFic, &(sh->fSt));
+  depReport (stdout, &(sh->fSt));
+
+  evDestroy (&evl);
+  free (boardId);
+  free (ent);
+  free (sem);
+  free (sh);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,25 @@
+/**
+ *  \file probDesAirportRhapsody.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Discrete-event simulation.
+ *  Implementation with a single thread and a virtual clock.
+ *
+ *  Simulator of the intervening entities. The porter, the bus driver and the passengers are state machines driven by
+ *  a list of timestamped events: they go through the same transitions and produce the same logging lines as the
+ *  processes of the concurrent version, but the run is not bound to the wall clock.
+ *
+ *  The problem dimensions may be set on the command line
+ *    \li <tt>-k</tt> number of plane landings
+ *    \li <tt>-n</tt> number of passengers per flight
+ *    \li <tt>-m</tt> maximum number of pieces of luggage per passenger
+ *    \li <tt>-t</tt> number of seats in the bus.
+ *
+ *  Upon execution, one parameter is requested:
+ *    \li name of the logging file.
+ *
+ *  \author António Rui Borges - December 2013
+ */
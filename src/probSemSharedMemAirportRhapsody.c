@@ -10,28 +10,87 @@
  *
  *  Generator process of the intervening entities.
  *
- *  Upon execution, one parameter is requested:
- *    \li name of the logging file.
+ *  The problem dimensions may be set on the command line
+ *    \li <tt>-k</tt> number of plane landings
+ *    \li <tt>-n</tt> number of passengers per flight
+ *    \li <tt>-m</tt> maximum number of pieces of luggage per passenger
+ *    \li <tt>-t</tt> number of seats in the bus
+ *    \li <tt>-p</tt> number of porters
+ *    \li <tt>-d</tt> number of buses, each one with its own driver
+ *    \li <tt>-c</tt> number of luggage conveyor belts, passenger p collecting her bags from belt p mod C
+ *    \li <tt>-w</tt> number of flights which may be under way at once (see <tt>sharedDataSync.h</tt>).
+ *
+ *  Several airports may be run side by side, the passengers in transit being handed off from one to the next (see
+ *  <tt>network.h</tt>)
+ *    \li <tt>-a</tt> number of airports in the network, each one with its own intervening entities and logging file
+ *        (the name given, followed by <tt>.</tt> and the airport number)
+ *    \li <tt>-x</tt> the processes of airport a are placed on processor a mod P, P being the number of processors.
+ *
+ *  The states to be saved in the logging file may be selected as well (see <tt>logging.h</tt>)
+ *    \li <tt>-l</tt> logging level (<tt>off</tt>, <tt>flight</tt>, <tt>entity</tt> or <tt>full</tt>, the default)
+ *    \li <tt>-e</tt> entities whose transitions are saved at level <tt>entity</tt>, which it implies (for instance,
+ *        <tt>po,dr,0-3</tt>)
+ *    \li <tt>-s</tt> only one in every so many states passing the level is saved.
+ *
+ *  The departures of the bus may be scheduled as well (see <tt>departure.h</tt>)
+ *    \li <tt>-b</tt> timetable (for instance, <tt>headway=200,wait=150,load=2</tt>).
+ *
+ *  The random number generator may be seeded as well, so that a run can be repeated
+ *    \li <tt>-r</tt> seed (the process identifier, by default).
+ *
+ *  The access keys to the shared regions and the semaphore sets are composed from the process identifier of the
+ *  generator, so that several simulations may be run at once in the same directory (see <tt>monteCarlo.c</tt>). They
+ *  are destroyed when the generator exits or is terminated by a signal it can catch (among them <tt>SIGPIPE</tt>, when
+ *  the reader of its standard output goes away early), the intervening entities being killed if need be; if it is
+ *  killed outright, the batch runner removes them.
+ *
+ *  The logging file, the overwrite policy and the engine may be given on the command line as well, so that no
+ *  question is asked (see <tt>logSink.h</tt>)
+ *    \li <tt>-o</tt> name of the logging file
+ *    \li <tt>-O</tt> overwrite policy (<tt>ask</tt>, the default, <tt>yes</tt> or <tt>no</tt>)
+ *    \li <tt>-g</tt> engine (<tt>process</tt>, the default, <tt>thread</tt> or <tt>des</tt>): the generator of any
+ *        other engine is run in its place, with the same command line, <tt>-a</tt>, <tt>-x</tt> and <tt>-R</tt> being
+ *        refused beforehand (see <tt>options.h</tt>).
+ *
+ *  The airport may be made resident (see <tt>resident.h</tt>)
+ *    \li <tt>-R</tt> the intervening entities, the shared regions and the semaphore sets are kept from one day to the
+ *        next, the days being run on command (see <tt>getCommand</tt>); every day has a logging file of its own (the
+ *        name given, followed by <tt>.</tt> and the day number).
+ *
+ *  Upon execution, unless it was given on the command line, one parameter is requested:
+ *    \li name of the logging file (<tt>null</tt>, <tt>-</tt> and <tt>mem:</tt> select the sinks described in
+ *        <tt>logSink.h</tt>).
  *
  *  \author António Rui Borges - December 2013
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <errno.h>
+#include <signal.h>
 #include <sys/wait.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <string.h>
 #include <math.h>
+#include <sched.h>
 
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "cam.h"
 #include "queue.h"
 #include "logging.h"
+#include "departure.h"
+#include "logSink.h"
+#include "options.h"
+#include "logRing.h"
 #include "sharedDataSync.h"
+#include "network.h"
+#include "resident.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
 
@@ -44,245 +103,570 @@
 /** \brief name of the bus driver process */
 #define   DRIVER         "./driver"
 
+/** \brief name of the log writer process */
+#define   LOGGER         "./logger"
+
+/** \brief name of the generator of the engine based on threads */
+#define   THREADGEN      "./probThreadAirportRhapsody"
+
+/** \brief name of the generator of the discrete event engine */
+#define   DESGEN         "./probDesAirportRhapsody"
+
+/** \brief generator process identifier */
+static pid_t genPid;
+
+/** \brief shared memory access identifier of each airport */
+static int shmid[A_MAX];
+
+/** \brief semaphore set access identifier of each airport */
+static int semgid[A_MAX];
+
+/** \brief pointer to shared memory region of each airport */
+static SHARED_DATA *sh[A_MAX];
+
+/** \brief processes identifiers */
+static int *pid = NULL;
+
+/** \brief number of processes identifiers */
+static unsigned int nPid = 0;
+
+/** \brief log writer process identifier of each airport */
+static int logPid[A_MAX];
+
 /**
- *  \brief Main program.
+ *  \brief Naming a file after the airport it belongs to.
+ *
+ *  If there are several airports, the airport number is appended to the name.
  *
- *  Its role is starting the simulation by generating the intervening entities processes (porter, passengers and bus
- *  driver) and waiting for their termination.
+ *  \param name file name (it is rewritten in place)
+ *  \param a airport number
+ *  \param nAirports number of airports in the network
  */
 
-int main (int argc, char *argv[])
+static void airportName (char *name, unsigned int a, unsigned int nAirports)
 {
-  char nFic[51];                                                                              /*name of logging file */
-  char nFicErr[12];                                                                           /* name of error files */
-  FILE *fic;                                                                                      /* file descriptor */
-  int shmid,                                                                      /* shared memory access identifier */
-      semgid;                                                                     /* semaphore set access identifier */
-  int t;                                                                               /* keyboard reading test flag */
-  char opt;                                                                                                /* answer */
-  unsigned int k, p, i, j, n;                                                                  /* counting variables */
-  SHARED_DATA *sh;                                                                /* pointer to shared memory region */
-  unsigned int nTot;                                                                        /* plane load per flight */
-  int pid[2+N];                                                                             /* processes identifiers */
-  int key;                                                           /*access key to shared memory and semaphore set */
-  char num[2][12];                                                     /* numeric value conversion (up to 10 digits) */
-  int status,                                                                                    /* execution status */
-      info;                                                                                   /* info identification */
-  bool term;                                                                             /* process termination flag */
-
-  /* getting logging file name */
+  if (nAirports > 1)
+     sprintf (name + strlen (name), ".%u", a);
+}
 
-  do
-  { do
-    { printf ("\nLog file name? ");
-      t = scanf ("%20[^\n]", nFic);
-      scanf ("%*[^\n]");
-      scanf ("%*c");
-    } while (t == 0);
-    fic = fopen (nFic, "r");
-    if (fic != NULL)
-       { fclose (fic);
-         printf ("There is already a file with this name! ");
-         do
-         { printf ("Overwrite? ");
-           scanf ("%c", &opt);
-           if (opt != '\n')
-              { scanf ("%*[^\n]");
-                scanf ("%*c");
-              }
-         } while ((opt == '\n') || ((opt != 'Y') && (opt != 'y') && (opt != 'N') && (opt != 'n')));
-         if ((opt == 'Y') || (opt == 'y')) break;
-       }
-  } while (fic != NULL);
+/**
+ *  \brief Placing the calling process on the processor of its airport.
+ *
+ *  Airport a is given processor a mod P, P being the number of processors online. The program terminates upon
+ *  failure.
+ *
+ *  \param a airport number
+ */
 
-  /* composing command line */
+static void airportPin (unsigned int a)
+{
+  cpu_set_t cpus;                                                                              /* processor affinity */
+  long nCpu = sysconf (_SC_NPROCESSORS_ONLN);                                         /* number of processors online */
 
-  sprintf (num[0], "%s", "0");
-  if ((key = ftok (".", 'a')) == -1)
-     { perror ("error on generating the key");
+  CPU_ZERO (&cpus);
+  CPU_SET ((nCpu > 0) ? a % nCpu : 0, &cpus);
+  if (sched_setaffinity (0, sizeof (cpu_set_t), &cpus) == -1)
+     { perror ("error on placing the process on the processor of its airport");
        exit (EXIT_FAILURE);
      }
-  sprintf (num[1], "%d", key);
-
-  /* creating and initializing the shared memory region and the logging file */
+}
 
-  if ((shmid = shmemCreate (key, sizeof (SHARED_DATA))) == -1)
-     { perror ("error on creating the shared memory region");
-       return EXIT_FAILURE;
-     }
-  if (shmemAttach (shmid, (void **) &sh) == -1)
-     { perror ("error on mapping the shared region on the process address space");
-       return EXIT_FAILURE;
-     }
+/**
+ *  \brief Cleaning up after the simulation.
+ *
+ *  The processes which have not been waited for are killed and the semaphore sets and shared regions which still
+ *  exist are destroyed. It is registered with <tt>atexit</tt>, so that nothing is left behind however the generator
+ *  terminates, and does nothing in the children, which inherit it until they are overlaid.
+ */
 
-  srandom ((unsigned int) getpid ());                                          /* initialize random number generator */
-
-  sh->fSt.nLand = 0;                                                                     /* initialize plane landing */
-  sh->fSt.st.porterStat = WAITING_FOR_A_PLANE_TO_LAND;        /* the porter is reading a newspaper while waiting for
-                                                                                                     next assignment */
-  for (k = 0; k < K; k++)
-  { nTot = 0;                                                                    /* initialize plane load per flight */
-    for (p = 0; p < N; p++)
-    { sh->fSt.st.passStat[k][p].stat = AT_THE_DISEMBARKING_ZONE;         /* the passenger is coming out of the plane
-                                                                                                       after landing */
-      if (((unsigned int) floor (9.0*random ()/RAND_MAX+1.5)) < 4)
-         sh->fSt.st.passStat[k][p].sit = TRT;                                         /* the passenger is in transit */
-         else sh->fSt.st.passStat[k][p].sit = FD;         /* the passenger has this airport as her final destination */
-                                                       /* number of pieces of luggage she is supposed to be carrying */
-      sh->fSt.st.passStat[k][p].nBagsReal = (unsigned int) floor (((double) M)*random ()/RAND_MAX+0.5);
-                                                             /* number of pieces of luggage she is actually carrying */
-      if ((sh->fSt.st.passStat[k][p].sit == TRT) || (sh->fSt.st.passStat[k][p].nBagsReal == 0))
-         sh->fSt.st.passStat[k][p].nBagsAct = sh->fSt.st.passStat[k][p].nBagsReal;            /* no need to consider
-                                                                                                        missing bags */
-         else if (((unsigned int) floor (9.0*random ()/RAND_MAX+1.5)) < 5)
-                                                                                   /* the passenger has lost one bag */
-                 sh->fSt.st.passStat[k][p].nBagsAct = sh->fSt.st.passStat[k][p].nBagsReal - 1;
-                 else sh->fSt.st.passStat[k][p].nBagsAct = sh->fSt.st.passStat[k][p].nBagsReal;     /* the passenger
-                                                                                                          has no bag */
-      nTot += sh->fSt.st.passStat[k][p].nBagsAct;                                               /* update plane load */
-    }
-    sh->fSt.plHold[k].nBags = nTot;                                             /* set number of bags for plane load */
-    i = 0;
-    while (i < nTot)                                                                           /* fill in plane load */
-    { for (p = 0; p < N; p++)
-      { for (j = 0; j < sh->fSt.st.passStat[k][p].nBagsAct; j++, i++)
-          sh->fSt.plHold[k].bag[i].id = p;
-        sh->fSt.st.passStat[k][p].nBagsAct = 0;                /* reset number of pieces of luggage the passenger is
-                                                                                                   actually carrying */
-      }
-    }
+static void cleanUp (void)
+{
+  unsigned int i;                                                                               /* counting variable */
+
+  if (getpid () != genPid) return;
+  for (i = 0; i < nPid; i++)
+    if (pid[i] > 0)
+       kill (pid[i], SIGKILL);
+  for (i = 0; i < A_MAX; i++)
+  { if (logPid[i] > 0)
+       kill (logPid[i], SIGKILL);
+    if (semgid[i] != -1)
+       semDestroy (semgid[i]);
+    if (sh[i] != NULL)
+       shmemDettach (sh[i]);
+    if (shmid[i] != -1)
+       shmemDestroy (shmid[i]);
+    logPid[i] = 0;
+    semgid[i] = shmid[i] = -1;
+    sh[i] = NULL;
   }
-  sh->fSt.st.driverStat = PARKING_AT_THE_ARRIVAL_TERMINAL;          /* the driver has parked at the arrival transfer
-                                                                        terminal waiting for passengers to transport */
-  camInit (&(sh->fSt.convBelt));                                                 /* set conveyor belt to empty state */
-  queueInit (&(sh->fSt.busQueue));                                                   /* set bus queue to empty state */
-  sh->fSt.bus.nOccup = 0;                                                               /* initialize bus occupation */
-  for (i = 0; i < T; i++)
-    sh->fSt.bus.seat[i] = EMPTYST;                                                             /* list seat as empty */
-  sh->fSt.nToTPassFD = 0;  /* initialize total number of passengers for whom the airport was their final destination */
-  sh->fSt.nToTPassTST = 0;                                       /* initialize total number of passengers in transit */
-  sh->fSt.nToTBagsPCB = 0;                            /* initialize total number of bags placed in the belt conveyor */
-  sh->fSt.nToTBagsPSR = 0;                                /* initialize total number of bags placed in the storeroom */
-  sh->fSt.nToTMBags = 0;                                                  /* initialize total number of missing bags */
-  sh->fSt.dayEnded = false;                                           /* initialize flag signaling driver day's work */
-
-  sh->nPassP = 0;                   /* initialize number of passengers who have executed the operation whatShouldIDo
-                                                                                               in each plane landing */
-  for (p = 0; p< N; p++)
-    sh->nCalls[p] = 0;                            /* initialize number of calls made by the porter to each passenger */
-  sh->nPassD = 0;              /* initialize number of passengers who have executed either the operation enterTheBus
-                                                                                 or leaveTheBus in each bus transfer */
-
-  sh->access = ACCESS;                                                /* identification of critical region semaphore */
-  sh->waitingFlight = WAITINGFLIGHT;                          /* identification of porter waiting for work semaphore */
-  sh->waitingDrive = WAITINGDRIVE;      /* identification of bus driver waiting for starting a new journey semaphore */
-  sh->waitingPass = WAITINGPASS; /* identification of bus driver waiting for passengers to board / unboard semaphore */
-  for (p = 0; p < N; p++)
-    sh->pass[p] = B_PASS + p;                                               /* identification of passenger semaphore */
-
-  createLog (nFic);                                                                       /* create the logging file */
-
-  /* creating and initializing the semaphore set (all semaphores but the critical region one are set to red state) */
-
-  if ((semgid = semCreate (key, SEM_NU)) == -1)
-     { perror ("error on creating the semaphore set");
-       return EXIT_FAILURE;
-     }
-  if (semUp (semgid, sh->access) == -1)                                          /* enable access to critical region */
-     { perror ("error on the up operation for semaphore access");
-       return EXIT_FAILURE;
-     }
-
-  /* generating the intervening entities processes */
+  nPid = 0;
+}
 
-  if ((pid[0] = fork ()) < 0)
-     { perror ("error on the fork operation for the porter");
-       return EXIT_FAILURE;
-     }
-  strcpy (nFicErr, "error_PO");
-  if (pid[0] == 0)
-     if (execl (PORTER, PORTER, nFic, num[1], nFicErr, NULL) < 0)
-          { perror ("error on the generation of the porter process");
-            return EXIT_FAILURE;
-          }
-
-  if ((pid[1] = fork ()) < 0)
-     { perror ("error on the fork operation for the bus driver");
-       return EXIT_FAILURE;
-     }
-  strcpy (nFicErr, "error_DR");
-  if (pid[1] == 0)
-     if (execl (DRIVER, DRIVER, nFic, num[1], nFicErr, NULL) < 0)
-          { perror ("error on the generation of the bus driver process");
-            return EXIT_FAILURE;
-          }
-
-  strcpy (nFicErr, "error_PA_");
-  for (p = 2; p < N+2; p++)
-  { if ((pid[p] = fork ()) < 0)
-       { perror ("error on the fork operation for the passenger");
-         return EXIT_FAILURE;
-       }
-    num[0][0] = '0' + p - 2;
-    nFicErr[8] = '0' + p - 2;
-    if (pid[p] == 0)
-       if (execl (PASSENGER, PASSENGER, num[0], nFic, num[1], nFicErr, NULL) < 0)
-          { perror ("error on the generation of the passenger process");
-            return EXIT_FAILURE;
-          }
-  }
+/**
+ *  \brief Terminating the generator upon a signal.
+ *
+ *  The simulation is cleaned up and the signal is raised again, its default action taking place.
+ *
+ *  \param sig signal number
+ */
 
-  /* signal start of operations */
+static void abortRun (int sig)
+{
+  cleanUp ();
+  signal (sig, SIG_DFL);
+  raise (sig);
+}
 
-  if (semSignal (semgid) == -1)
-     { perror ("error on signaling start of operations");
-       return EXIT_FAILURE;
-     }
+/**
+ *  \brief Waiting for the termination of the intervening entities processes of every airport.
+ *
+ *  The program terminates upon failure, and also if a log writer terminates first, since the intervening entities
+ *  would then be left waiting on its ring once it fills up.
+ *
+ *  \param nAirports number of airports in the network
+ *  \param nEnt number of intervening entities per airport
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ */
 
-  /* wait for the termination of the thieves processes */
+static void waitAll (unsigned int nAirports, unsigned int nEnt, DIM *p_dim)
+{
+  int status,                                                                                    /* execution status */
+      info;                                                                                   /* info identification */
+  bool term;                                                                             /* process termination flag */
+  unsigned int i, n;                                                                           /* counting variables */
 
-  printf ("\nFinal report\n");
   n = 0;
   do
-  { info = wait (&status);
+  { if ((info = wait (&status)) == -1)
+       { perror ("error on waiting for an intervening process");
+         exit (EXIT_FAILURE);
+       }
+    for (i = 0; i < nAirports; i++)
+      if (info == logPid[i])
+         { logPid[i] = 0;
+           fprintf (stderr, "log writer process of airport %u has terminated before the intervening entities\n", i);
+           exit (EXIT_FAILURE);
+         }
     term = false;
-    for (i = 0; i < 2+N; i++)
+    for (i = 0; i < nAirports*nEnt; i++)
       if (info == pid[i])
          { term = true;
            break;
          }
     if (!term)
-       { perror ("error on waiting for an intervening process");
-         return EXIT_FAILURE;
+       { fprintf (stderr, "error on waiting for an intervening process: unexpected process %d\n", info);
+         exit (EXIT_FAILURE);
        }
-    if (i == 0)
-       printf ("porter process has terminated: ");
-       else if (i == 1)
-               printf ("bus driver process has terminated: ");
-               else printf ("passenger process, with id %u, has terminated: ", i-2);
+    pid[i] = 0;
+    if (nAirports > 1)
+       printf ("airport %u, ", i / nEnt);
+    i %= nEnt;
+    if (i < p_dim->p)
+       printf ("porter process, with id %u, has terminated: ", i);
+       else if (i < p_dim->p+p_dim->b)
+               printf ("bus driver process, with id %u, has terminated: ", i-p_dim->p);
+               else printf ("passenger process, with id %u, has terminated: ", i-p_dim->p-p_dim->b);
     if (WIFEXITED (status))
        printf ("its status was %d\n", WEXITSTATUS (status));
     n += 1;
-  } while (n < (2+N));
+  } while (n < nAirports*nEnt);
+}
+
+/**
+ *  \brief Reading the next command of a resident airport.
+ *
+ *  The commands are read from the standard input, one per line:
+ *    \li <tt>day</tt> [<em>seed</em>] - a day is run (with the seed following that of the previous day, unless one is
+ *        given)
+ *    \li <tt>days</tt> <em>n</em> - n days are run back to back
+ *    \li <tt>timetable</tt> <em>timetable</em> - the bus timetable of the days to come is set (<tt>default</tt>, for
+ *        the default one)
+ *    \li <tt>quit</tt> - the airport is closed down, as it is upon the end of the input.
+ *
+ *  \param p_nDays pointer to the location where the number of days to be run is to be stored
+ *  \param p_seed pointer to the location where the seed of the next day is stored
+ *  \param p_tt pointer to the location where the bus timetable is stored
+ *  \param p_fSt pointer to a full internal state on which a timetable may be tried out
+ *
+ *  \return \c true, if days are to be run
+ *  \return \c false, if the airport is to be closed down
+ */
+
+static bool getCommand (unsigned int *p_nDays, unsigned int *p_seed, char **p_tt, FULL_STAT *p_fSt)
+{
+  static char tt[101];                                                                              /* bus timetable */
+  char line[121],                                                                                    /* command line */
+       cmd[11],                                                                                           /* command */
+       arg[101];                                                                                         /* argument */
+  char *tinp;                                                                      /* numerical parameters test flag */
+  long val;                                                                                       /* converted value */
+  int n;                                                                                    /* number of fields read */
+
+  while (true)
+  { printf ("\nCommand? ");
+    fflush (stdout);
+    if (fgets (line, sizeof (line), stdin) == NULL)
+       return false;
+    line[strcspn (line, "\n")] = '\0';
+    if ((n = sscanf (line, "%10s %100s", cmd, arg)) < 1)
+       continue;
+    val = (n == 2) ? strtol (arg, &tinp, 0) : 1;
+    if ((n == 2) && ((*tinp != '\0') || (val <= 0) || (val > 0x7FFFFFFF)))
+       val = -1;
+    if (strcmp (cmd, "quit") == 0)
+       return false;
+    if ((strcmp (cmd, "day") == 0) && (val > 0))
+       { if (n == 2)
+            *p_seed = (unsigned int) val;
+         *p_nDays = 1;
+         return true;
+       }
+    if ((strcmp (cmd, "days") == 0) && (n == 2) && (val > 0))
+       { *p_nDays = (unsigned int) val;
+         return true;
+       }
+    if ((strcmp (cmd, "timetable") == 0) && (n == 2))
+       { if (strcmp (arg, "default") == 0)
+            { *p_tt = NULL;
+              continue;
+            }
+         if (depSetup (p_fSt, arg, 0))
+            { strcpy (tt, arg);
+              *p_tt = tt;
+              continue;
+            }
+       }
+    fprintf (stderr, "invalid command: %s (day [seed], days n, timetable timetable|default or quit)\n", line);
+  }
+}
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is starting the simulation by generating the intervening entities processes (porters, passengers and bus
+ *  drivers) of every airport and waiting for their termination.
+ */
 
-  /* print final report */
+int main (int argc, char *argv[])
+{
+  char nFic[51];                                                                              /*name of logging file */
+  char nFicA[A_MAX][51];                                                     /* name of logging file of each airport */
+  char nFicD[A_MAX][51];                                         /* name of logging file of each airport for the day */
+  char nFicErr[31];                                                                           /* name of error files */
+  unsigned int a, p, s;                                                                        /* counting variables */
+  int key[A_MAX];                                    /*access key to shared memory and semaphore set of each airport */
+  char num[2][12];                                                     /* numeric value conversion (up to 10 digits) */
+  int status;                                                                                    /* execution status */
+  unsigned int nEnt;                                                   /* number of intervening entities per airport */
+  unsigned long long t0,                                                                  /* start of the day's work */
+                     elapsed;                                              /* time taken to carry out the day's work */
+  OPTIONS opt;                                                                               /* command line options */
+  unsigned int day,                                                                                    /* day number */
+               nDays,                                                       /* number of days to be run back to back */
+               daySeed;                                                   /* random number generator seed of the day */
+
+  /* getting the options */
 
-  finalReport (nFic, &(sh->fSt));
+  getOptions (argc, argv, "process", &opt);
 
-  /* destroy the semaphore set and the shared region */
+  /* the generator of any other engine is run in its place */
 
-  if (semDestroy (semgid) == -1)
-     { perror ("error on destroying the semaphore set");
+  if (strcmp (opt.engine, "process") != 0)
+     { execv ((strcmp (opt.engine, "thread") == 0) ? THREADGEN : DESGEN, argv);
+       perror ("error on the generation of the generator of the engine");
        return EXIT_FAILURE;
      }
-  if (shmemDettach (sh) == -1)
-     { perror ("error on unmapping the shared region off the process address space");
+  nEnt = opt.dim.p + opt.dim.b + opt.dim.n;
+
+  /* from now on, whatever is created is destroyed upon termination */
+
+  genPid = getpid ();
+  for (a = 0; a < A_MAX; a++)
+  { semgid[a] = shmid[a] = -1;
+    sh[a] = NULL;
+    logPid[a] = 0;
+  }
+  if ((atexit (cleanUp) != 0) || (signal (SIGINT, abortRun) == SIG_ERR) ||
+      (signal (SIGTERM, abortRun) == SIG_ERR) || (signal (SIGHUP, abortRun) == SIG_ERR) ||
+      (signal (SIGQUIT, abortRun) == SIG_ERR) || (signal (SIGABRT, abortRun) == SIG_ERR) ||
+      (signal (SIGSEGV, abortRun) == SIG_ERR) || (signal (SIGBUS, abortRun) == SIG_ERR) ||
+      (signal (SIGPIPE, abortRun) == SIG_ERR))
+     { perror ("error on installing the clean up handlers");
        return EXIT_FAILURE;
      }
-  if (shmemDestroy (shmid) == -1)
-     { perror ("error on destroying the shared region");
+  if ((pid = calloc (opt.nAirports * nEnt, sizeof (int))) == NULL)
+     { perror ("error on allocating the processes identifiers");
        return EXIT_FAILURE;
      }
+  nPid = opt.nAirports * nEnt;
+
+  /* getting logging file name */
+
+  if (!sinkChoose (nFic, opt.logName, opt.policy))
+     return EXIT_FAILURE;
+
+  /* creating the shared regions and the semaphore sets, one of each per airport, so that the next airport is known
+     before any of them is started; a key already in use, left behind by a run that crashed or belonging to another
+     one, is salted anew */
+
+  for (a = 0; a < opt.nAirports; a++)
+  { for (s = 0; s < NSALTS; s++)
+    { key[a] = RUNKEY (genPid, s, a);
+      if ((shmid[a] = shmemCreate (key[a], sharedDataSize (&opt.dim))) == -1)
+         { if (errno == EEXIST) continue;
+           break;
+         }
+      if ((semgid[a] = semCreate (key[a], SEM_NU (opt.dim.n, opt.dim.p, opt.dim.b, opt.dim.c, opt.dim.w))) != -1)
+         break;
+      if (errno != EEXIST) break;
+      shmemDestroy (shmid[a]);
+      shmid[a] = -1;
+    }
+    if (shmid[a] == -1)
+       { perror ("error on creating the shared memory region");
+         return EXIT_FAILURE;
+       }
+    if ((semgid[a] == -1) && (errno == ERANGE))
+       { fprintf (stderr, "error on creating the semaphore set: %u semaphores are more than the system allows in a "
+                  "set (SEMMSL); use fewer passengers or build with make SEMOBJ=semaphoreFutex.o\n",
+                  SEM_NU (opt.dim.n, opt.dim.p, opt.dim.b, opt.dim.c, opt.dim.w) + 1);
+         return EXIT_FAILURE;
+       }
+    if (semgid[a] == -1)
+       { perror ("error on creating the semaphore set");
+         return EXIT_FAILURE;
+       }
+  }
+
+  srandom (opt.seed);                                                          /* initialize random number generator */
+
+  for (a = 0; a < opt.nAirports; a++)
+  {                                                      /* laying out the shared memory region and the logging sink */
+
+    if (shmemAttach (shmid[a], (void **) &sh[a]) == -1)
+       { perror ("error on mapping the shared region on the process address space");
+         return EXIT_FAILURE;
+       }
+
+    sharedDataInit (sh[a], &opt.dim);                       /* lay out the shared region, the semaphores being known */
+
+    strcpy (nFicA[a], nFic);
+    if (opt.nAirports > 1)
+       sinkInstance (nFicA[a], a);                                               /* every airport has a logging file */
+    sinkSetup (nFicA[a]);                                                                /* resolve the logging sink */
+
+    /* initializing the semaphore set (all semaphores but the critical region ones are set to red state) */
+
+    for (p = LANDACCESS; p <= STATSACCESS; p++)
+      if (semUp (semgid[a], p) == -1)                                            /* enable access to critical region */
+         { perror ("error on the up operation for a critical region semaphore");
+           return EXIT_FAILURE;
+         }
+    for (p = 0; p < opt.dim.c; p++)
+      if (semUp (semgid[a], BELTSEM (sh[a], p)) == -1)                      /* enable access to belt critical region */
+         { perror ("error on the up operation for a conveyor belt critical region semaphore");
+           return EXIT_FAILURE;
+         }
+    if (semUp (semgid[a], INACCESS) == -1)                       /* enable access to inbound channel critical region */
+       { perror ("error on the up operation for the inbound channel critical region semaphore");
+         return EXIT_FAILURE;
+       }
+    for (p = 0; p < LOGSLOTS; p++)
+      if (semUp (semgid[a], sh[a]->logFree) == -1)                                   /* all logging records are free */
+         { perror ("error on the up operation for semaphore logFree");
+           return EXIT_FAILURE;
+         }
+  }
+
+  for (a = 0; a < opt.nAirports; a++)
+  {                                                                                        /* composing command line */
+
+    sprintf (num[1], "%d", key[a]);
+
+    /* generating the intervening entities processes */
+
+    for (p = 0; p < opt.dim.p; p++)
+    { if ((pid[a*nEnt+p] = fork ()) < 0)
+         { perror ("error on the fork operation for the porter");
+           return EXIT_FAILURE;
+         }
+      sprintf (num[0], "%u", p);
+      sprintf (nFicErr, "error_PO%u", p);
+      airportName (nFicErr, a, opt.nAirports);
+      if (pid[a*nEnt+p] == 0)
+         { if (opt.pin) airportPin (a);
+           if (execl (PORTER, PORTER, num[0], nFicA[a], num[1], nFicErr, NULL) < 0)
+              { perror ("error on the generation of the porter process");
+                return EXIT_FAILURE;
+              }
+         }
+    }
+
+    for (p = opt.dim.p; p < opt.dim.p+opt.dim.b; p++)
+    { if ((pid[a*nEnt+p] = fork ()) < 0)
+         { perror ("error on the fork operation for the bus driver");
+           return EXIT_FAILURE;
+         }
+      sprintf (num[0], "%u", p - opt.dim.p);
+      sprintf (nFicErr, "error_DR%u", p - opt.dim.p);
+      airportName (nFicErr, a, opt.nAirports);
+      if (pid[a*nEnt+p] == 0)
+         { if (opt.pin) airportPin (a);
+           if (execl (DRIVER, DRIVER, num[0], nFicA[a], num[1], nFicErr, NULL) < 0)
+              { perror ("error on the generation of the bus driver process");
+                return EXIT_FAILURE;
+              }
+         }
+    }
+
+    for (p = opt.dim.p+opt.dim.b; p < nEnt; p++)
+    { if ((pid[a*nEnt+p] = fork ()) < 0)
+         { perror ("error on the fork operation for the passenger");
+           return EXIT_FAILURE;
+         }
+      sprintf (num[0], "%u", p - opt.dim.p - opt.dim.b);
+      sprintf (nFicErr, "error_PA%u", p - opt.dim.p - opt.dim.b);
+      airportName (nFicErr, a, opt.nAirports);
+      if (pid[a*nEnt+p] == 0)
+         { if (opt.pin) airportPin (a);
+           if (execl (PASSENGER, PASSENGER, num[0], nFicA[a], num[1], nFicErr, NULL) < 0)
+              { perror ("error on the generation of the passenger process");
+                return EXIT_FAILURE;
+              }
+         }
+    }
+  }
+
+  /* carrying out the day's work, one day after another if the airport is resident */
+
+  nDays = opt.resident ? 0 : 1;
+  daySeed = opt.seed;
+  for (day = 0; ; day++)
+  { if ((nDays == 0) && !getCommand (&nDays, &daySeed, &opt.timetable, &(sh[0]->fSt)))
+       break;                                                                    /* the airport is to be closed down */
+    nDays -= 1;
+
+    srandom (daySeed);                                                         /* initialize random number generator */
+
+    for (a = 0; a < opt.nAirports; a++)
+    {                                                  /* initializing the shared memory region and the logging file */
+
+      sharedDataInit (sh[a], &opt.dim);                                              /* initialize the shared region */
+      netLink (sh[a], a, opt.nAirports, key[(a + 1) % opt.nAirports],                       /* link it to the network */
+               (unsigned int) random ());
+      dayLink (sh[a], opt.resident, day);                                                /* keep it for the next day */
+      if (!logSetup (&(sh[a]->fSt), opt.logLevel, opt.logSel, opt.logPeriod) ||     /* select the states to be saved */
+          !depSetup (&(sh[a]->fSt), opt.timetable, depClock ()))                         /* set up the bus timetable */
+         { fprintf (stderr, "invalid logging level, list of entities or bus timetable\n");
+           return EXIT_FAILURE;
+         }
+
+      strcpy (nFicD[a], nFicA[a]);
+      if (opt.resident)
+         sinkInstance (nFicD[a], day);                                               /* every day has a logging file */
+      createLog (nFicD[a], &opt.dim);                                                     /* create the logging file */
+
+      /* generating the log writer process */
+
+      sprintf (num[1], "%d", key[a]);
+      if ((logPid[a] = fork ()) < 0)
+         { perror ("error on the fork operation for the log writer");
+           return EXIT_FAILURE;
+         }
+      strcpy (nFicErr, "error_LW");
+      airportName (nFicErr, a, opt.nAirports);
+      if (logPid[a] == 0)
+         { if (opt.pin) airportPin (a);
+           if (execl (LOGGER, LOGGER, nFicD[a], num[1], nFicErr, NULL) < 0)
+              { perror ("error on the generation of the log writer process");
+                return EXIT_FAILURE;
+              }
+         }
+    }
+
+    /* signal start of the day's work */
+
+    t0 = depClock ();
+    for (a = 0; a < opt.nAirports; a++)
+      dayRelease (semgid[a], sh[a], nEnt, false);
+
+    /* wait for the end of the day's work: the intervening entities of a resident airport live on */
+
+    if (opt.resident)
+       for (a = 0; a < opt.nAirports; a++)
+         dayWait (semgid[a], sh[a], nEnt);
+       else { printf ("\nFinal report\n");
+              waitAll (opt.nAirports, nEnt, &opt.dim);
+            }
+    elapsed = depClock () - t0;
+
+    /* wait for the log writers to drain the rings of logging records */
+
+    for (a = 0; a < opt.nAirports; a++)
+    { logRingEnd (semgid[a], sh[a]);
+      if (waitpid (logPid[a], &status, 0) != logPid[a])
+         { perror ("error on waiting for the log writer process");
+           return EXIT_FAILURE;
+         }
+      logPid[a] = 0;
+      if (!opt.resident)
+         { if (opt.nAirports > 1)
+              printf ("airport %u, ", a);
+           printf ("log writer process has terminated: ");
+           if (WIFEXITED (status))
+              printf ("its status was %d\n", WEXITSTATUS (status));
+         }
+    }
+
+    /* print final report */
+
+    if (opt.resident)
+       printf ("day %u (seed %u): day's work carried out in %.3f ms\n", day, daySeed, (double) elapsed / 1.0e6);
+    for (a = 0; a < opt.nAirports; a++)
+    { finalReport (nFicD[a], &(sh[a]->fSt));
+      if (opt.nAirports > 1)
+         printf ("airport %u:\n", a);
+      depReport (stdout, &(sh[a]->fSt));
+    }
+    if (opt.nAirports > 1)
+       netReport (stdout, sh, opt.nAirports, elapsed);
+    fflush (stdout);
+    daySeed += 1;
+    if (!opt.resident) break;
+  }
+
+  /* close a resident airport down: the intervening entities are let into a last day, in which they terminate at
+     once */
+
+  if (opt.resident)
+     { for (a = 0; a < opt.nAirports; a++)
+         dayRelease (semgid[a], sh[a], nEnt, true);
+       printf ("\nFinal report\n");
+       waitAll (opt.nAirports, nEnt, &opt.dim);
+     }
+
+  /* destroy the semaphore sets and the shared regions */
+
+  for (a = 0; a < opt.nAirports; a++)
+  { if (semDestroy (semgid[a]) == -1)
+       { perror ("error on destroying the semaphore set");
+         return EXIT_FAILURE;
+       }
+    semgid[a] = -1;
+    if (shmemDettach (sh[a]) == -1)
+       { perror ("error on unmapping the shared region off the process address space");
+         return EXIT_FAILURE;
+       }
+    sh[a] = NULL;
+    if (shmemDestroy (shmid[a]) == -1)
+       { perror ("error on destroying the shared region");
+         return EXIT_FAILURE;
+       }
+    shmid[a] = -1;
+  }
+  nPid = 0;
+  free (pid);
 
   return EXIT_SUCCESS;
 }
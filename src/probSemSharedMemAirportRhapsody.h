@@ -10,6 +10,12 @@
  *
  *  Generator process of the intervening entities.
  *
+ *  The problem dimensions may be set on the command line
+ *    \li <tt>-k</tt> number of plane landings
+ *    \li <tt>-n</tt> number of passengers per flight
+ *    \li <tt>-m</tt> maximum number of pieces of luggage per passenger
+ *    \li <tt>-t</tt> number of seats in the bus.
+ *
  *  Upon execution, one parameter is requested:
  *    \li name of the logging file.
  *
@@ -0,0 +1,258 @@
+/**
+ *  \file probThreadAirportRhapsody.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *  Implementation with POSIX threads.
+ *
+ *  Generator of the intervening entities, which are run as threads of a single process. The shared region is
+ *  allocated in the process memory and the semaphores are built upon mutexes and condition variables, so no system
+ *  wide IPC resources are used.
+ *
+ *  The problem dimensions may be set on the command line
+ *    \li <tt>-k</tt> number of plane landings
+ *    \li <tt>-n</tt> number of passengers per flight
+ *    \li <tt>-m</tt> maximum number of pieces of luggage per passenger
+ *    \li <tt>-t</tt> number of seats in the bus
+ *    \li <tt>-p</tt> number of porters
+ *    \li <tt>-d</tt> number of buses, each one with its own driver
+ *    \li <tt>-c</tt> number of luggage conveyor belts, passenger p collecting her bags from belt p mod C
+ *    \li <tt>-w</tt> number of flights which may be under way at once (see <tt>sharedDataSync.h</tt>).
+ *
+ *  The states to be saved in the logging file may be selected as well (see <tt>logging.h</tt>)
+ *    \li <tt>-l</tt> logging level (<tt>off</tt>, <tt>flight</tt>, <tt>entity</tt> or <tt>full</tt>, the default)
+ *    \li <tt>-e</tt> entities whose transitions are saved at level <tt>entity</tt>, which it implies (for instance,
+ *        <tt>po,dr,0-3</tt>)
+ *    \li <tt>-s</tt> only one in every so many states passing the level is saved.
+ *
+ *  The departures of the bus may be scheduled as well (see <tt>departure.h</tt>)
+ *    \li <tt>-b</tt> timetable (for instance, <tt>headway=200,wait=150,load=2</tt>).
+ *
+ *  The random number generator may be seeded as well, so that a run can be repeated
+ *    \li <tt>-r</tt> seed (the process identifier, by default).
+ *
+ *  The logging file and the overwrite policy may be given on the command line as well, so that no question is asked
+ *  (see <tt>logSink.h</tt>)
+ *    \li <tt>-o</tt> name of the logging file
+ *    \li <tt>-O</tt> overwrite policy (<tt>ask</tt>, the default, <tt>yes</tt> or <tt>no</tt>)
+ *    \li <tt>-g</tt> engine (only <tt>thread</tt>, as the generator of the engine based on processes runs this one in
+ *        its place when asked to).
+ *
+ *  The options of a network of airports, of their placement on processors and of resident mode (<tt>-a</tt>,
+ *  <tt>-x</tt> and <tt>-R</tt>) are refused, as this engine does not support them (see <tt>options.h</tt>).
+ *
+ *  Upon execution, unless it was given on the command line, one parameter is requested:
+ *    \li name of the logging file (<tt>null</tt>, <tt>-</tt> and <tt>mem:</tt> select the sinks described in
+ *        <tt>logSink.h</tt>).
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "departure.h"
+#include "logSink.h"
+#include "options.h"
+#include "logRing.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "probThreadAirportRhapsody.h"
+
+/** \brief access key to the shared memory and the semaphore set (it is local to the process) */
+#define  KEY            0x41525400
+
+/** \brief stack size of the intervening entities threads */
+#define  STACKSZ        (64 * 1024)
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is starting the simulation by launching the intervening entities threads (porters, passengers and bus
+ *  drivers) and waiting for their termination.
+ */
+
+int main (int argc, char *argv[])
+{
+  char nFic[51];                                                                              /*name of logging file */
+  int shmid,                                                                      /* shared memory access identifier */
+      semgid;                                                                     /* semaphore set access identifier */
+  unsigned int p;                                                                               /* counting variable */
+  SHARED_DATA *sh;                                                                /* pointer to shared memory region */
+  pthread_t *tid;                                                                             /* threads identifiers */
+  pthread_t logTid;                                                                  /* log writer thread identifier */
+  unsigned int *id;                                                        /* passengers and porters identifications */
+  pthread_attr_t attr;                                                                /* threads creation attributes */
+  OPTIONS opt;                                                                               /* command line options */
+
+  /* getting the options */
+
+  getOptions (argc, argv, "thread", &opt);
+  if (((tid = malloc ((opt.dim.p + opt.dim.b + opt.dim.n) * sizeof (pthread_t))) == NULL) ||
+      ((id = malloc ((opt.dim.n + opt.dim.p + opt.dim.b) * sizeof (unsigned int))) == NULL))
+     { perror ("error on allocating the threads identifiers");
+       return EXIT_FAILURE;
+     }
+
+  /* getting logging file name */
+
+  if (!sinkChoose (nFic, opt.logName, opt.policy))
+     return EXIT_FAILURE;
+
+  /* creating and initializing the shared memory region and the logging file */
+
+  if ((shmid = shmemCreate (KEY, sharedDataSize (&opt.dim))) == -1)
+     { perror ("error on creating the shared memory region");
+       return EXIT_FAILURE;
+     }
+  if (shmemAttach (shmid, (void **) &sh) == -1)
+     { perror ("error on mapping the shared region on the process address space");
+       return EXIT_FAILURE;
+     }
+
+  srandom (opt.seed);                                                          /* initialize random number generator */
+
+  sharedDataInit (sh, &opt.dim);                                         /* lay out and initialize the shared region */
+  if (!logSetup (&(sh->fSt), opt.logLevel, opt.logSel, opt.logPeriod))              /* select the states to be saved */
+     { fprintf (stderr, "invalid logging level or list of entities\n");
+       return EXIT_FAILURE;
+     }
+  if (!depSetup (&(sh->fSt), opt.timetable, depClock ()))                                /* set up the bus timetable */
+     { fprintf (stderr, "invalid bus timetable\n");
+       return EXIT_FAILURE;
+     }
+
+  sinkSetup (nFic);                                                                      /* resolve the logging sink */
+  createLog (nFic, &opt.dim);                                                             /* create the logging file */
+
+  /* creating and initializing the semaphore set (all semaphores but the critical region ones are set to red state) */
+
+  if ((semgid = semCreate (KEY, SEM_NU (opt.dim.n, opt.dim.p, opt.dim.b, opt.dim.c, opt.dim.w))) == -1)
+     { perror ("error on creating the semaphore set");
+       return EXIT_FAILURE;
+     }
+  for (p = LANDACCESS; p <= STATSACCESS; p++)
+    if (semUp (semgid, p) == -1)                                                 /* enable access to critical region */
+       { perror ("error on the up operation for a critical region semaphore");
+         return EXIT_FAILURE;
+       }
+  for (p = 0; p < opt.dim.c; p++)
+    if (semUp (semgid, BELTSEM (sh, p)) == -1)                               /* enable access to belt critical region */
+       { perror ("error on the up operation for a conveyor belt critical region semaphore");
+         return EXIT_FAILURE;
+       }
+  if (semUp (semgid, INACCESS) == -1)                            /* enable access to inbound channel critical region */
+     { perror ("error on the up operation for the inbound channel critical region semaphore");
+       return EXIT_FAILURE;
+     }
+  for (p = 0; p < LOGSLOTS; p++)
+    if (semUp (semgid, sh->logFree) == -1)                                           /* all logging records are free */
+       { perror ("error on the up operation for semaphore logFree");
+         return EXIT_FAILURE;
+       }
+
+  /* signal start of operations (the entities connect from this thread, so it must be done beforehand) */
+
+  if (semSignal (semgid) == -1)
+     { perror ("error on signaling start of operations");
+       return EXIT_FAILURE;
+     }
+
+  /* launching the intervening entities threads */
+
+  loggerSetup (nFic, KEY);
+  porterSetup (nFic, KEY);
+  driverSetup (nFic, KEY);
+  passengerSetup (nFic, KEY);
+  if ((pthread_attr_init (&attr) != 0) || (pthread_attr_setstacksize (&attr, STACKSZ) != 0))
+     { perror ("error on setting the threads creation attributes");
+       return EXIT_FAILURE;
+     }
+  if (pthread_create (&logTid, &attr, loggerThread, NULL) != 0)
+     { perror ("error on launching the log writer thread");
+       return EXIT_FAILURE;
+     }
+  for (p = 0; p < opt.dim.p; p++)
+  { id[opt.dim.n+p] = p;
+    if (pthread_create (&tid[p], &attr, porterThread, &id[opt.dim.n+p]) != 0)
+       { perror ("error on launching the porter thread");
+         return EXIT_FAILURE;
+       }
+  }
+  for (p = 0; p < opt.dim.b; p++)
+  { id[opt.dim.n+opt.dim.p+p] = p;
+    if (pthread_create (&tid[opt.dim.p+p], &attr, driverThread, &id[opt.dim.n+opt.dim.p+p]) != 0)
+       { perror ("error on launching the bus driver thread");
+         return EXIT_FAILURE;
+       }
+  }
+  for (p = 0; p < opt.dim.n; p++)
+  { id[p] = p;
+    if (pthread_create (&tid[opt.dim.p+opt.dim.b+p], &attr, passengerThread, &id[p]) != 0)
+       { perror ("error on launching the passenger thread");
+         return EXIT_FAILURE;
+       }
+  }
+  pthread_attr_destroy (&attr);
+
+  /* wait for the termination of the intervening entities threads */
+
+  printf ("\nFinal report\n");
+  for (p = 0; p < opt.dim.p+opt.dim.b+opt.dim.n; p++)
+  { if (pthread_join (tid[p], NULL) != 0)
+       { perror ("error on waiting for an intervening thread");
+         return EXIT_FAILURE;
+       }
+    if (p < opt.dim.p)
+       printf ("porter thread, with id %u, has terminated\n", p);
+       else if (p < opt.dim.p+opt.dim.b)
+               printf ("bus driver thread, with id %u, has terminated\n", p-opt.dim.p);
+               else printf ("passenger thread, with id %u, has terminated\n", p-opt.dim.p-opt.dim.b);
+  }
+
+  /* wait for the log writer to drain the ring of logging records */
+
+  logRingEnd (semgid, sh);
+  if (pthread_join (logTid, NULL) != 0)
+     { perror ("error on waiting for the log writer thread");
+       return EXIT_FAILURE;
+     }
+  printf ("log writer thread has terminated\n");
+
+  /* print final report */
+
+  finalReport (nFic, &(sh->fSt));
+  depReport (stdout, &(sh->fSt));
+
+  /* destroy the semaphore set and the shared region */
+
+  if (semDestroy (semgid) == -1)
+     { perror ("error on destroying the semaphore set");
+       return EXIT_FAILURE;
+     }
+  if (shmemDettach (sh) == -1)
+     { perror ("error on unmapping the shared region off the process address space");
+       return EXIT_FAILURE;
+     }
+  if (shmemDestroy (shmid) == -1)
+     { perror ("error on destroying the shared region");
+       return EXIT_FAILURE;
+     }
+  free (id);
+  free (tid);
+
+  return EXIT_SUCCESS;
+}
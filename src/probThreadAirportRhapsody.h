@@ -0,0 +1,98 @@
+/**
+ *  \file probThreadAirportRhapsody.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *  Implementation with POSIX threads.
+ *
+ *  Entry points of the intervening entities when they are run as threads of a single process.
+ *
+ *  Every entity has a set up function, which connects it to the semaphore set and the shared memory region and must
+ *  be called before the thread is launched, and a thread function, which generates its life cycle.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#ifndef PROBTHREADAIRPORTRHAPSODY_H_
+#define PROBTHREADAIRPORTRHAPSODY_H_
+
+/**
+ *  \brief Porters set up.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+extern void porterSetup (char *fName, int key);
+
+/**
+ *  \brief Porter thread.
+ *
+ *  \param arg pointer to the location where the porter identification is stored
+ *
+ *  \return \c NULL
+ */
+
+extern void *porterThread (void *arg);
+
+/**
+ *  \brief Bus drivers set up.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+extern void driverSetup (char *fName, int key);
+
+/**
+ *  \brief Bus driver thread.
+ *
+ *  \param arg pointer to the location where the bus identification is stored
+ *
+ *  \return \c NULL
+ */
+
+extern void *driverThread (void *arg);
+
+/**
+ *  \brief Passengers set up.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+extern void passengerSetup (char *fName, int key);
+
+/**
+ *  \brief Passenger thread.
+ *
+ *  \param arg pointer to the location where the passenger identification is stored
+ *
+ *  \return \c NULL
+ */
+
+extern void *passengerThread (void *arg);
+
+/**
+ *  \brief Log writer set up.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+extern void loggerSetup (char *fName, int key);
+
+/**
+ *  \brief Log writer thread.
+ *
+ *  \param arg not used
+ *
+ *  \return \c NULL
+ */
+
+extern void *loggerThread (void *arg);
+
+#endif /* PROBTHREADAIRPORTRHAPSODY_H_ */
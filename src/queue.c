@@ -11,9 +11,16 @@
  *     \li initialization
  *     \li insertion of a value
  *     \li retrieval of a value
+ *     \li retrieval of up to a given number of values
+ *     \li peek at a value
+ *     \li iteration over the stored values, from the oldest to the newest
+ *     \li queue size
  *     \li test for queue full
  *     \li test for queue empty.
  *
+ *  The queue keeps track of its length, so that its size is known in constant time. When the storage region has a
+ *  power of two size, the pointers wrap around by masking instead of being compared against the size.
+ *
  *  \author António Rui Borges - November 2013
  */
 
@@ -21,6 +28,24 @@
 #include <stdbool.h>
 
 #include "probDataStruct.h"
+#include "queue.h"
+
+/**
+ *  \brief Advance a storage position by a given amount.
+ *
+ *  \param p_q pointer to the location where the queue is stored
+ *  \param i storage position
+ *  \param d amount of the advance (not greater than the size of the storage region)
+ *
+ *  \return the advanced storage position
+ */
+
+static unsigned int advance (QUEUE *p_q, unsigned int i, unsigned int d)
+{
+  if (p_q->mask != 0) return (i + d) & p_q->mask;
+  i += d;
+  return (i >= p_q->size) ? i - p_q->size : i;
+}
 
 /**
  *  \brief Queue initialization.
@@ -34,8 +59,8 @@
 void queueInit (QUEUE *p_q)
 {
   if (p_q == NULL) return;
-  p_q->ii = p_q->ri = 0;
-  p_q->full = false;
+  p_q->ii = p_q->ri = p_q->n = 0;
+  p_q->mask = ((p_q->size != 0) && ((p_q->size & (p_q->size - 1)) == 0)) ? p_q->size - 1 : 0;
 }
 
 /**
@@ -50,10 +75,13 @@ void queueInit (QUEUE *p_q)
 
 void queueIn (QUEUE *p_q, unsigned int val)
 {
-  if ((p_q == NULL) || (p_q->full)) return;
-  p_q->mem[p_q->ii] = val;
-  p_q->ii = (p_q->ii + 1) % N;
-  p_q->full = (p_q->ii == p_q->ri);
+  unsigned int *mem;                   /* storage region */
+
+  if ((p_q == NULL) || (p_q->n == p_q->size)) return;
+  mem = SHADDR (p_q, p_q->memOff);
+  mem[p_q->ii] = val;
+  p_q->ii = advance (p_q, p_q->ii, 1);
+  p_q->n += 1;
 }
 
 /**
@@ -68,10 +96,47 @@ void queueIn (QUEUE *p_q, unsigned int val)
 
 void queueOut (QUEUE *p_q, unsigned int *p_val)
 {
-  if ((p_q == NULL) || (p_val == NULL) || (!(p_q->full) && (p_q->ii == p_q->ri))) return;
-  *p_val = p_q->mem[p_q->ri];
-  p_q->ri = (p_q->ri + 1) % N;
-  p_q->full = false;
+  unsigned int *mem;                   /* storage region */
+
+  if ((p_q == NULL) || (p_val == NULL) || (p_q->n == 0)) return;
+  mem = SHADDR (p_q, p_q->memOff);
+  *p_val = mem[p_q->ri];
+  p_q->ri = advance (p_q, p_q->ri, 1);
+  p_q->n -= 1;
+}
+
+/**
+ *  \brief Retrieval of up to a given number of values from the queue.
+ *
+ *         The values are retrieved in queue order, the oldest first.
+ *         The function fails if a null pointer is passed as a parameter.
+ *         Nothing is retrieved if the function fails.
+ *
+ *  \param p_q pointer to the location where the queue is stored
+ *  \param val pointer to the array where the retrieved values are to be stored
+ *  \param max maximum number of values to be retrieved
+ *
+ *  \return the number of values actually retrieved
+ */
+
+unsigned int queueOutN (QUEUE *p_q, unsigned int *val, unsigned int max)
+{
+  unsigned int *mem;                   /* storage region */
+  unsigned int cnt, first, j;          /* number of values retrieved, length of the run before the wrap around and
+                                          counting variable */
+
+  if ((p_q == NULL) || (val == NULL)) return 0;
+  cnt = (max < p_q->n) ? max : p_q->n;
+  mem = SHADDR (p_q, p_q->memOff);
+  first = p_q->size - p_q->ri;         /* the values are copied in at most two contiguous runs */
+  if (first > cnt) first = cnt;
+  for (j = 0; j < first; j++)
+    val[j] = mem[p_q->ri + j];
+  for (j = first; j < cnt; j++)
+    val[j] = mem[j - first];
+  p_q->ri = advance (p_q, p_q->ri, cnt);
+  p_q->n -= cnt;
+  return cnt;
 }
 
 /**
@@ -89,14 +154,70 @@ void queueOut (QUEUE *p_q, unsigned int *p_val)
 
 int queuePeek (QUEUE *p_q, unsigned int pos)
 {
-  if ((p_q == NULL) || (pos >= N) || (!(p_q->full) && (p_q->ii == p_q->ri))) return EMPTYPOS;
-  if ((p_q->ii > p_q->ri) && (p_q->ii > (p_q->ri + pos)))
-     return (int) p_q->mem[p_q->ri + pos];
-     else if (p_q->ii <= p_q->ri)
-             { if ((((p_q->ri + pos) % N) >= p_q->ri) || (((p_q->ri + pos) % N) < p_q->ii))
-                  return (int) p_q->mem[(p_q->ri + pos)%N];
-            }
-  return EMPTYPOS;
+  unsigned int *mem;                   /* storage region */
+
+  if ((p_q == NULL) || (pos >= p_q->n)) return EMPTYPOS;
+  mem = SHADDR (p_q, p_q->memOff);
+  return (int) mem[advance (p_q, p_q->ri, pos)];
+}
+
+/**
+ *  \brief Iterator initialization.
+ *
+ *         The iterator is positioned at the oldest value of the queue.
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_q pointer to the location where the queue is stored
+ *  \param p_it pointer to the location where the iterator is stored
+ */
+
+void queueIterInit (QUEUE *p_q, QUEUEIT *p_it)
+{
+  if ((p_q == NULL) || (p_it == NULL)) return;
+  p_it->p_q = p_q;
+  p_it->i = p_q->ri;
+  p_it->left = p_q->n;
+}
+
+/**
+ *  \brief Iteration step.
+ *
+ *         The function fails if a null pointer is passed as a parameter or every value was already visited.
+ *         Nothing is retrieved if the function fails.
+ *
+ *  \param p_it pointer to the location where the iterator is stored
+ *  \param p_val pointer to the location where the visited value is to be stored
+ *
+ *  \return \c true, if a value was visited
+ *  \return \c false, otherwise
+ */
+
+bool queueIterNext (QUEUEIT *p_it, unsigned int *p_val)
+{
+  unsigned int *mem;                   /* storage region */
+
+  if ((p_it == NULL) || (p_val == NULL) || (p_it->left == 0)) return false;
+  mem = SHADDR (p_it->p_q, p_it->p_q->memOff);
+  *p_val = mem[p_it->i];
+  p_it->i = advance (p_it->p_q, p_it->i, 1);
+  p_it->left -= 1;
+  return true;
+}
+
+/**
+ *  \brief Queue size.
+ *
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_q pointer to the location where the queue is stored
+ *
+ *  \return the number of values stored in the queue (0, if the function fails)
+ */
+
+unsigned int queueSize (QUEUE *p_q)
+{
+  if (p_q == NULL) return 0;
+  return p_q->n;
 }
 
 /**
@@ -113,7 +234,7 @@ int queuePeek (QUEUE *p_q, unsigned int pos)
 bool queueFull (QUEUE *p_q)
 {
   if (p_q == NULL) return false;
-  return p_q->full;
+  return p_q->n == p_q->size;
 }
 
 /**
@@ -130,5 +251,5 @@ bool queueFull (QUEUE *p_q)
 bool queueEmpty (QUEUE *p_q)
 {
   if (p_q == NULL) return false;
-  return !(p_q->full) && (p_q->ii == p_q->ri);
+  return p_q->n == 0;
 }
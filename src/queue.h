@@ -11,9 +11,16 @@
  *     \li initialization
  *     \li insertion of a value
  *     \li retrieval of a value
+ *     \li retrieval of up to a given number of values
+ *     \li peek at a value
+ *     \li iteration over the stored values, from the oldest to the newest
+ *     \li queue size
  *     \li test for queue full
  *     \li test for queue empty.
  *
+ *  The queue keeps track of its length, so that its size is known in constant time. When the storage region has a
+ *  power of two size, the pointers wrap around by masking instead of being compared against the size.
+ *
  *  \author António Rui Borges - November 2013
  */
 
@@ -24,6 +31,20 @@
 
 #include "probDataStruct.h"
 
+/**
+ *  \brief Definition of <em>queue iterator</em> data type.
+ *
+ *  It is only valid while the queue is not changed.
+ */
+typedef struct
+        { /** \brief queue being traversed */
+          QUEUE *p_q;
+          /** \brief storage position of the next value */
+          unsigned int i;
+          /** \brief number of values still to be visited */
+          unsigned int left;
+        } QUEUEIT;
+
 /**
  *  \brief Queue initialization.
  *
@@ -59,6 +80,22 @@ extern void queueIn (QUEUE *p_q, unsigned int val);
 
 extern void queueOut (QUEUE *p_q, unsigned int *p_val);
 
+/**
+ *  \brief Retrieval of up to a given number of values from the queue.
+ *
+ *         The values are retrieved in queue order, the oldest first.
+ *         The function fails if a null pointer is passed as a parameter.
+ *         Nothing is retrieved if the function fails.
+ *
+ *  \param p_q pointer to the location where the queue is stored
+ *  \param val pointer to the array where the retrieved values are to be stored
+ *  \param max maximum number of values to be retrieved
+ *
+ *  \return the number of values actually retrieved
+ */
+
+extern unsigned int queueOutN (QUEUE *p_q, unsigned int *val, unsigned int max);
+
 /**
  *  \brief Peek at a value from the queue.
  *
@@ -74,6 +111,45 @@ extern void queueOut (QUEUE *p_q, unsigned int *p_val);
 
 extern int queuePeek (QUEUE *p_q, unsigned int pos);
 
+/**
+ *  \brief Iterator initialization.
+ *
+ *         The iterator is positioned at the oldest value of the queue.
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_q pointer to the location where the queue is stored
+ *  \param p_it pointer to the location where the iterator is stored
+ */
+
+extern void queueIterInit (QUEUE *p_q, QUEUEIT *p_it);
+
+/**
+ *  \brief Iteration step.
+ *
+ *         The function fails if a null pointer is passed as a parameter or every value was already visited.
+ *         Nothing is retrieved if the function fails.
+ *
+ *  \param p_it pointer to the location where the iterator is stored
+ *  \param p_val pointer to the location where the visited value is to be stored
+ *
+ *  \return \c true, if a value was visited
+ *  \return \c false, otherwise
+ */
+
+extern bool queueIterNext (QUEUEIT *p_it, unsigned int *p_val);
+
+/**
+ *  \brief Queue size.
+ *
+ *         The function fails if a null pointer is passed as a parameter.
+ *
+ *  \param p_q pointer to the location where the queue is stored
+ *
+ *  \return the number of values stored in the queue (0, if the function fails)
+ */
+
+extern unsigned int queueSize (QUEUE *p_q);
+
 /**
  *  \brief Test for queue full.
  *
@@ -0,0 +1,132 @@
+/**
+ *  \file resident.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Days of a resident airport.
+ *
+ *  Defined operations:
+ *     \li making the airport resident for a day
+ *     \li letting the intervening entities into a day
+ *     \li waiting for the end of a day
+ *     \li an intervening entity beginning a day.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "resident.h"
+
+/**
+ *  \brief Making the airport resident for a day.
+ *
+ *  It must be called by the generator, after the shared region has been initialized for the day and before the
+ *  intervening entities are let into it.
+ *
+ *  \param sh pointer to the shared region
+ *  \param resident \c true, if the intervening entities are to live the next day as well; \c false, if they are to
+ *         terminate at the end of this one
+ *  \param day day number
+ */
+
+void dayLink (SHARED_DATA *sh, bool resident, unsigned int day)
+{
+  sh->day.resident = resident;
+  sh->day.day = day;
+  sh->day.quit = false;
+}
+
+/**
+ *  \brief Letting the intervening entities into a day.
+ *
+ *  The program terminates upon failure.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param nEnt number of intervening entities
+ *  \param quit \c true, if they are to terminate at once, the airport being closed down
+ */
+
+void dayRelease (int semgid, SHARED_DATA *sh, unsigned int nEnt, bool quit)
+{
+  if (quit)
+     { sh->day.quit = true;
+       if (sh->day.resident)                                          /* the entities are waiting for the next day */
+          sh->day.day += 1;
+     }
+  if (sh->day.day == 0)
+     { if (semSignal (semgid) == -1)                                    /* the first day begins with the operations */
+          { perror ("error on signaling start of operations");
+            exit (EXIT_FAILURE);
+          }
+     }
+     else if (semUpBy (semgid, sh->day.startSem + sh->day.day % 2, nEnt) == -1)
+             { perror ("error on the up operation for the day release semaphore");
+               exit (EXIT_FAILURE);
+             }
+}
+
+/**
+ *  \brief Waiting for the end of a day of a resident airport.
+ *
+ *  The generator is blocked until all the intervening entities have got through their day's work. The program
+ *  terminates upon failure.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param nEnt number of intervening entities
+ */
+
+void dayWait (int semgid, SHARED_DATA *sh, unsigned int nEnt)
+{
+  unsigned int i;                                                                               /* counting variable */
+
+  for (i = 0; i < nEnt; i++)
+    if (semDown (semgid, sh->day.endSem) == -1)
+       { perror ("error on the down operation for the end of the day semaphore");
+         exit (EXIT_FAILURE);
+       }
+}
+
+/**
+ *  \brief An intervening entity beginning a day.
+ *
+ *  The first day begins at once. At a resident airport, the next ones begin once the entity has been let into them;
+ *  otherwise, there is no next day. The program terminates upon failure.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param p_nDays pointer to the location where the number of days the entity has lived is stored (0, at first)
+ *
+ *  \return \c true, if the entity is to live the day
+ *  \return \c false, if it is to terminate
+ */
+
+bool dayBegin (int semgid, SHARED_DATA *sh, unsigned int *p_nDays)
+{
+  if (*p_nDays > 0)
+     { if (!sh->day.resident)                                               /* the airport is closed after one day */
+          return false;
+       if (semUp (semgid, sh->day.endSem) == -1)                                      /* signal the end of the day */
+          { perror ("error on the up operation for the end of the day semaphore");
+            exit (EXIT_FAILURE);
+          }
+       if (semDown (semgid, sh->day.startSem + *p_nDays % 2) == -1)             /* wait to be let into the next one */
+          { perror ("error on the down operation for the day release semaphore");
+            exit (EXIT_FAILURE);
+          }
+     }
+  *p_nDays += 1;
+  return !sh->day.quit;
+}
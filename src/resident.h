@@ -0,0 +1,96 @@
+/**
+ *  \file resident.h (interface file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *
+ *  \brief Days of a resident airport.
+ *
+ *  Defined operations:
+ *     \li making the airport resident for a day
+ *     \li letting the intervening entities into a day
+ *     \li waiting for the end of a day
+ *     \li an intervening entity beginning a day.
+ *
+ *  The intervening entities of a resident airport, and the shared region and semaphore set they use, outlive the
+ *  day: as her day's work is over, every entity signals the end of the day semaphore and waits to be let into the
+ *  next one, while the generator, once all of them have done so, writes the final report, initializes the shared
+ *  region anew and lets them in. The first day is let in through the start of operations, as the day of an airport
+ *  which is not resident.
+ *
+ *  The days have a <em>sense</em>, d mod 2, and the entities waiting for day d block on the release semaphore of its
+ *  sense: an entity which, having been let into day d, lives it through before another one has even woken up, waits
+ *  for day d+1 on the other semaphore and cannot take the release meant for the latter.
+ *
+ *  When the airport is closed down, the entities are let into a last day in which they terminate at once.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#ifndef RESIDENT_H_
+#define RESIDENT_H_
+
+#include <stdbool.h>
+
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Making the airport resident for a day.
+ *
+ *  It must be called by the generator, after the shared region has been initialized for the day and before the
+ *  intervening entities are let into it.
+ *
+ *  \param sh pointer to the shared region
+ *  \param resident \c true, if the intervening entities are to live the next day as well; \c false, if they are to
+ *         terminate at the end of this one
+ *  \param day day number
+ */
+
+extern void dayLink (SHARED_DATA *sh, bool resident, unsigned int day);
+
+/**
+ *  \brief Letting the intervening entities into a day.
+ *
+ *  The program terminates upon failure.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param nEnt number of intervening entities
+ *  \param quit \c true, if they are to terminate at once, the airport being closed down
+ */
+
+extern void dayRelease (int semgid, SHARED_DATA *sh, unsigned int nEnt, bool quit);
+
+/**
+ *  \brief Waiting for the end of a day of a resident airport.
+ *
+ *  The generator is blocked until all the intervening entities have got through their day's work. The program
+ *  terminates upon failure.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param nEnt number of intervening entities
+ */
+
+extern void dayWait (int semgid, SHARED_DATA *sh, unsigned int nEnt);
+
+/**
+ *  \brief An intervening entity beginning a day.
+ *
+ *  The first day begins at once. At a resident airport, the next ones begin once the entity has been let into them;
+ *  otherwise, there is no next day. The program terminates upon failure.
+ *
+ *  \param semgid semaphore set access identifier
+ *  \param sh pointer to the shared region
+ *  \param p_nDays pointer to the location where the number of days the entity has lived is stored (0, at first)
+ *
+ *  \return \c true, if the entity is to live the day
+ *  \return \c false, if it is to terminate
+ */
+
+extern bool dayBegin (int semgid, SHARED_DATA *sh, unsigned int *p_nDays);
+
+#endif /* RESIDENT_H_ */
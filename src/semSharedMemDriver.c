@@ -8,7 +8,7 @@
  *  Synchronization based on semaphores and shared memory.
  *  Implementation with SVIPC.
  *
- *  Definition of the operations carried out by the bus driver thread:
+ *  Definition of the operations carried out by the bus drivers:
  *     \li has day's work ended
  *     \li announcing bus boarding
  *     \li go to departure terminal
@@ -16,6 +16,9 @@
  *     \li go to arrival terminal
  *     \li park the bus.
  *
+ *  There is a driver per bus. The buses parked at the arrival transfer terminal are dispatched in the order they have
+ *  arrived (see <tt>sharedDataSync.h</tt>).
+ *
  *  \author António Rui Borges - December 2013
  *
  *  \developed by
@@ -30,17 +33,24 @@
 #include <sys/types.h>
 #include <string.h>
 #include <math.h>
-#include <signal.h>
-#include <sys/time.h>
+#include <time.h>
 #include <errno.h>
+#include <limits.h>
 
 #include "probConst.h"
 #include "probDataStruct.h"
 #include "queue.h"
+#include "departure.h"
 #include "logging.h"
+#include "logRing.h"
 #include "sharedDataSync.h"
+#include "resident.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#ifdef THREAD_ENGINE
+#include <pthread.h>
+#include "probThreadAirportRhapsody.h"
+#endif
 
 /** \brief logging file name */
 static char nFic[51];
@@ -55,47 +65,56 @@ static int semgid;
 static SHARED_DATA *sh;
 
 /** \brief has day's work ended operation */
-static bool hasDaysWorkEnded (void);
+static bool hasDaysWorkEnded (unsigned int b);
 
 /** \brief announcing bus boarding operation */
-static void announcingBusBoarding (void);
+static void announcingBusBoarding (unsigned int b, unsigned int *boardId);
 
 /** \brief go to the departure terminal */
-static void goToDepartureTerminal (void);
+static void goToDepartureTerminal (unsigned int b);
 
 /** \brief park the bus and let passengers off operation */
-static void parkTheBusAndLetPassOff (void);
+static void parkTheBusAndLetPassOff (unsigned int b, unsigned int *boardId);
 
 /** \brief go to the arrival terminal */
-static void goToArrivalTerminal (void);
+static void goToArrivalTerminal (unsigned int b);
 
 /** \brief park the bus operation */
-static void parkTheBus (void);
+static void parkTheBus (unsigned int b);
+
+/** \brief life cycle of the bus driver */
+static void lifeCycle (unsigned int b);
 
-/** \brief signal service function */
-static void alarmCk (int signum);
+#ifndef THREAD_ENGINE
 
 /**
  *  \brief Main program.
  *
- *  Its role is to generate the life cycle of one of intervening entities in the problem: the porter.
+ *  Its role is to generate the life cycle of one of intervening entities in the problem: the bus driver.
  */
 
 int main (int argc, char *argv[])
 {
   int key;                                                           /*access key to shared memory and semaphore set */
   char *tinp;                                                                      /* numerical parameters test flag */
+  unsigned int b;                                                                              /* bus identification */
+  unsigned int nDays;                                                                        /* number of days lived */
 
   /* validation of command line parameters */
 
-  if (argc != 4)
+  if (argc != 5)
      { freopen ("error_GDR", "a", stderr);
        fprintf (stderr, "Number of parameters is incorrect!\n");
        return EXIT_FAILURE;
      }
-     else freopen (argv[3], "w", stderr);
-  strcpy (nFic, argv[1]);
-  key = (unsigned int) strtol (argv[2], &tinp, 0);
+     else freopen (argv[4], "w", stderr);
+  b = (unsigned int) strtol (argv[1], &tinp, 0);
+  if (*tinp != '\0')
+     { fprintf (stderr, "Bus driver process identification is wrong!\n");
+       return EXIT_FAILURE;
+     }
+  strcpy (nFic, argv[2]);
+  key = (unsigned int) strtol (argv[3], &tinp, 0);
   if (*tinp != '\0')
      { fprintf (stderr, "Error on the access key communication!\n");
        return EXIT_FAILURE;
@@ -116,36 +135,16 @@ int main (int argc, char *argv[])
      { perror ("error on mapping the shared region on the process address space");
        return EXIT_FAILURE;
      }
-
-  /* set the timer */
-
-  struct sigaction act, oact;                                         /* action to be introduced and existing action */
-  struct itimerval titv, otitv;                         /* time interval to be introduced and existing time interval */
-
-  act.sa_handler = alarmCk;                                              /* specification of signal service function */
-  sigemptyset (&act.sa_mask);                /* no other signal will be blocked during the processing of this signal */
-  act.sa_flags = 0;                                                                              /* default behavior */
-  if (sigaction (SIGALRM, &act, &oact) != 0)                                                 /* function registering */
-     { perror ("error on registering the signal function (DR)");
-       return EXIT_FAILURE;
-     }
-  titv.it_interval.tv_sec = titv.it_value.tv_sec = 0;                                    /* time interval definition */
-  titv.it_interval.tv_usec = titv.it_value.tv_usec = 100000;
-  if (setitimer (ITIMER_REAL, &titv, &otitv) != 0)
-     { perror ("error on registering the time interval for interruption (DR)");
+  if (b >= sh->fSt.dim.b)
+     { fprintf (stderr, "Bus driver process identification is wrong!\n");
        return EXIT_FAILURE;
      }
 
-  /* simulation of the life cycle of the bus driver */
+  /* simulation of the life cycle of the bus driver, one day after another if the airport is resident */
 
-  while (!hasDaysWorkEnded ())
-  { announcingBusBoarding ();             /* the driver invites the passengers forming the queue to board the bus up
-                                                     to it is packed full or there is at least one passenger waiting */
-    goToDepartureTerminal ();                                  /* the driver takes the bus to the departure terminal */
-    parkTheBusAndLetPassOff ();             /* the driver parks the bus at the terminal and let the passengers leave */
-    goToArrivalTerminal ();                                 /* the driver takes the bus back to the arrival terminal */
-    parkTheBus ();                                                               /* the driver parks at the terminal */
-  }
+  nDays = 0;
+  while (dayBegin (semgid, sh, &nDays))
+    lifeCycle (b);
 
   /* unmapping the shared region off the process address space */
 
@@ -157,92 +156,184 @@ int main (int argc, char *argv[])
   return EXIT_SUCCESS;
 }
 
+#else
+
+/**
+ *  \brief Bus drivers set up.
+ *
+ *  Connection to the semaphore set and the shared memory region of the engine based on threads. It must be called
+ *  once before the bus driver threads are launched.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+void driverSetup (char *fName, int key)
+{
+  strcpy (nFic, fName);
+  if ((semgid = semConnect (key)) == -1)
+     { perror ("error on connecting to the semaphore set (DR)");
+       exit (EXIT_FAILURE);
+     }
+  if ((shmid = shmemConnect (key)) == -1)
+     { perror ("error on connecting to the shared memory region (DR)");
+       exit (EXIT_FAILURE);
+     }
+  if (shmemAttach (shmid, (void **) &sh) == -1)
+     { perror ("error on mapping the shared region on the process address space (DR)");
+       exit (EXIT_FAILURE);
+     }
+}
+
+/**
+ *  \brief Bus driver thread.
+ *
+ *  Its role is to generate the life cycle of one of intervening entities in the problem: the bus driver.
+ *
+ *  \param arg pointer to the location where the bus identification is stored
+ *
+ *  \return \c NULL
+ */
+
+void *driverThread (void *arg)
+{
+  lifeCycle (*((unsigned int *) arg));
+  return NULL;
+}
+
+#endif /* THREAD_ENGINE */
+
+/**
+ *  \brief Life cycle of the bus driver.
+ *
+ *  \param b bus identification
+ */
+
+static void lifeCycle (unsigned int b)
+{
+  unsigned int *boardId;                   /* identifications of the passengers summoned to board the bus (T entries) */
+
+  if ((boardId = malloc (sh->fSt.dim.t * sizeof (unsigned int))) == NULL)
+     { perror ("error on allocating the boarding list (DR)");
+       exit (EXIT_FAILURE);
+     }
+  while (!hasDaysWorkEnded (b))
+  { announcingBusBoarding (b, boardId);   /* the driver invites the passengers forming the queue to board the bus up
+                                                     to it is packed full or there is at least one passenger waiting */
+    goToDepartureTerminal (b);                                 /* the driver takes the bus to the departure terminal */
+    parkTheBusAndLetPassOff (b, boardId);   /* the driver parks the bus at the terminal and let the passengers leave */
+    goToArrivalTerminal (b);                                /* the driver takes the bus back to the arrival terminal */
+    parkTheBus (b);                                                              /* the driver parks at the terminal */
+  }
+  free (boardId);
+}
+
 /**
  *  \brief Has days work ended.
  *
  *  The bus driver keeps waiting for passengers to transfer until his day's work has come to an end. He only proceeds
  *  if his day's work is indeed finished or there are passengers needing to be serviced.
  *
+ *  He sleeps while his bus is not at the head of the queue of parked buses, until the driver of the bus ahead departs
+ *  or the last passenger of the day tells him. Once it is his turn, he sleeps while the queue is empty, until the first
+ *  passenger in line or the last passenger of the day tells him. Once someone is queueing, he waits for the load
+ *  threshold to be reached, but no later than the departure time scheduled by the timetable (see
+ *  <tt>departure.h</tt>).
+ *
  *  No state should be saved.
  *
+ *  \param b bus identification
+ *
  *  \return \c true, if the day has come to the end
  *  \return \c false, if there are passengers needing to be serviced
  */
 
-// REMARK
-// when waiting for service or for leaving, use here
-//
-//     if (semDown (semgid, sh->waitingDrive) == -1)                           /* wait for the right moment to check */
-//        { if (errno != EINTR)                     /* check if it is not departure time according to the time table */
-//             { perror ("error on the down operation for semaphore waitingDrive (DR)");
-//               exit (EXIT_FAILURE);
-//             }
-//        }
-
-static bool hasDaysWorkEnded (void)
+static bool hasDaysWorkEnded (unsigned int b)
 {
-	bool retorno= false;
-	// if his day's work is indeed finished or there are passengers needing to be serviced
-	do{
-		/* enter critical region */
-		if (semDown (semgid, sh->access) == -1)
+	bool ended, turn;
+	unsigned int n;
+	unsigned long long dl, now, us;
+
+	for (;;)
+	{
+		/* enter bus queue critical region */
+		if (semDown (semgid, sh->queueAccess) == -1)
 		{
-			perror ("error on the down operation for semaphore access (DR)");
+			perror ("error on the down operation for semaphore queueAccess (DR)");
 			exit (EXIT_FAILURE);
 		}
 		/* insert your code here */
-		// Verify if driver day has ended
-		if (sh->fSt.dayEnded)
-		{
-			retorno = true;
-		}
-		/* exit critical region */
-		if (semUp (semgid, sh->access) == -1)
+		ended = sh->fSt.dayEnded;
+		turn = (queuePeek(&sh->parkQueue,0) == (int) b);
+		n = turn ? queueSize(&sh->fSt.busQueue) : 0;
+		dl = (n != 0) ? depDeadline(&sh->fSt) : 0;
+		/* exit bus queue critical region */
+		if (semUp (semgid, sh->queueAccess) == -1)
 		{
-			perror ("error on the up operation for semaphore access (DR)");
+			perror ("error on the up operation for semaphore queueAccess (DR)");
 			exit (EXIT_FAILURE);
 		}
-		// If his day's work is indeed finished
-		if(retorno)
-			break;
-	}while(queueEmpty(&sh->fSt.busQueue));
-	// If day is not ended -> Sleep Me
-	if (!retorno)
-	{
-		/* wait for the right moment to check */
-		if (semDown (semgid, sh->waitingDrive) == -1)
+		// If his day's work is indeed finished or the load threshold is reached
+		if (ended)
+			return true;
+		if (turn && (n >= sh->fSt.dep.load))
+			return false;
+		// Not his turn or nobody queueing -> Sleep Me
+		if (n == 0)
 		{
-			/* check if it is not departure time according to the time table */
-			if (errno != EINTR)
+			if (semDown (semgid, DRIVESEM (sh, b)) == -1)
 			{
 				perror ("error on the down operation for semaphore waitingDrive (DR)");
 				exit (EXIT_FAILURE);
 			}
+			continue;
+		}
+		// Someone queueing -> wait for the load threshold or the departure time, whichever comes first
+		now = depClock();
+		if (now >= dl)
+			return false;
+		us = (dl - now + 999) / 1000;
+		if (us > UINT_MAX)                              /* a longer wait is resumed on the next turn of the loop */
+			us = UINT_MAX;
+		if ((semDownTimed (semgid, DRIVESEM (sh, b), (unsigned int) us) == -1) &&
+		    (errno != EAGAIN))
+		{
+			perror ("error on the down operation for semaphore waitingDrive (DR)");
+			exit (EXIT_FAILURE);
 		}
 	}
-	return retorno;
 }
 
 /**
  *  \brief Announcing bus boarding.
  *
  *  The bus driver checks if the queue is empty. If it is, he issues an error message.
- *  He then proceeds to summon passengers in the queue to board the bus. If some passenger identity is unknown, he
- *  issues an error message. He finally waits for the boarding to be complete.
+ *  He then proceeds to summon passengers in the queue to board his bus. If some passenger identity is unknown, he
+ *  issues an error message. His bus leaves the queue of parked buses and, if another one is parked, its driver is told
+ *  it is his turn. He finally waits for the boarding to be complete.
  *
  *  No state should be saved.
+ *
+ *  \param b bus identification
+ *  \param boardId buffer for the passengers summoned to board the bus (T entries)
  */
 
-static void announcingBusBoarding (void)
+static void announcingBusBoarding (unsigned int b, unsigned int *boardId)
 {
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter bus queue critical region */
+	if (semDown (semgid, sh->queueAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (DR)");
+		perror ("error on the down operation for semaphore queueAccess (DR)");
+		exit (EXIT_FAILURE);
+	}
+	/* enter bus seats critical region */
+	if (semDown (semgid, sh->seatsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore seatsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	unsigned int i,id;
+	unsigned int i,n,next;
 
 	//The bus driver checks if the queue is empty
 	if(queueEmpty(&sh->fSt.busQueue))
@@ -251,41 +342,55 @@ static void announcingBusBoarding (void)
 		perror("the bus queue is already empty");
 		exit(EXIT_FAILURE);
 	}
-	//he then procceeds to summon passengers in the queue to board
-	for(i=0;i<T;i++)
+	//he then procceeds to summon up to a busload of passengers in the queue to board, taken out in one go
+	n = queueOutN(&sh->fSt.busQueue,boardId,sh->fSt.dim.t);
+	NPASSD (sh, b) += n;
+	//the departure is checked against the timetable
+	depDepart(&sh->fSt,depClock(),n,b);
+	//his bus leaves the queue of parked buses and the driver of the next one, if any, takes over
+	queueOut(&sh->parkQueue,&next);
+	if (!queueEmpty(&sh->parkQueue))
 	{
-		// If bus queue not empty
-		if (!queueEmpty(&sh->fSt.busQueue))
+		if (semUp (semgid, DRIVESEM (sh, queuePeek(&sh->parkQueue,0))) == -1)
 		{
-			// Summon passenger
-			queueOut(&sh->fSt.busQueue,&id);
-			// Increment nPassD
-			sh->nPassD++;
-			// Wake up Passenger
-			if(id < N)
-			{
-				if(semUp (semgid, sh->pass[id]) == -1)
-				{
-					perror ("error on the up operation for semaphore Passenger[i] (PA)");
-					exit (EXIT_FAILURE);
-				}
-			}
-			// Unknown Passenger
-			else{
-				perror("passenger identity unknown");
-				exit(EXIT_FAILURE);
-			}
+			perror ("error on the up operation for semaphore waitingDrive (DR)");
+			exit (EXIT_FAILURE);
 		}
 	}
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	for(i=0;i<n;i++)
 	{
-		perror ("error on the up operation for semaphore access (DR)");
+		// Hand the Passenger to this bus and wake her up (all of them at once, below)
+		if(boardId[i] < sh->fSt.dim.n)
+		{
+			PASSBUS (sh, boardId[i]) = b;
+			boardId[i] = PASSSEM (sh, boardId[i]);
+		}
+		// Unknown Passenger
+		else{
+			perror("passenger identity unknown");
+			exit(EXIT_FAILURE);
+		}
+	}
+	if(semUpMany (semgid, boardId, n) == -1)
+	{
+		perror ("error on the up operation for semaphore Passenger[i] (PA)");
+		exit (EXIT_FAILURE);
+	}
+	/* exit bus seats critical region */
+	if (semUp (semgid, sh->seatsAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore seatsAccess (DR)");
+		exit (EXIT_FAILURE);
+	}
+	/* exit bus queue critical region */
+	if (semUp (semgid, sh->queueAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore queueAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 	//he finally waits for the boarding to be complete
-	if (semDown (semgid, sh->waitingPass) == -1)
+	if (semDown (semgid, WPASSSEM (sh, b)) == -1)
 	{
 		perror ("error on the down operation for semaphore waitingPass (DR)");
 		exit (EXIT_FAILURE);
@@ -299,26 +404,28 @@ static void announcingBusBoarding (void)
  *  The bus driver takes the bus to the departure transfer terminal.
  *
  *  State should be saved.
+ *
+ *  \param b bus identification
  */
 
-static void goToDepartureTerminal (void)
+static void goToDepartureTerminal (unsigned int b)
 {
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter statistics critical region */
+	if (semDown (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (DR)");
+		perror ("error on the down operation for semaphore statsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 	// Change State
-	sh->fSt.st.driverStat = DRIVING_FORWARD;
+	BUS (&sh->fSt, b).driverStat = DRIVING_FORWARD;
 	// Save State
-	saveState (nFic, sh->fSt.nLand, &(sh->fSt));
+	logRingPut (semgid, sh, sh->fSt.nLand, LOGDRIVER);
 
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	/* exit statistics critical region */
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (DR)");
+		perror ("error on the up operation for semaphore statsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 }
@@ -331,40 +438,40 @@ static void goToDepartureTerminal (void)
  *  issues an error message. He finally waits for the exit to be complete.
  *
  *  State should be saved.
+ *
+ *  \param b bus identification
+ *  \param boardId buffer for the semaphores of the passengers summoned to leave the bus (T entries)
  */
 
-static void parkTheBusAndLetPassOff (void)
+static void parkTheBusAndLetPassOff (unsigned int b, unsigned int *boardId)
 {
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter bus seats critical region */
+	if (semDown (semgid, sh->seatsAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (DR)");
+		perror ("error on the down operation for semaphore seatsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	int i;
+	unsigned int i;
+	TRANSF_INFO *bus = &BUS (&sh->fSt, b);
 	// Change State
-	sh->fSt.st.driverStat = PARKING_AT_THE_DEPARTURE_TERMINAL;
+	bus->driverStat = PARKING_AT_THE_DEPARTURE_TERMINAL;
 
 	// the bus driver checks if the bus driver is empty or overcrowded
-	if (sh->fSt.bus.nOccup > T || sh->fSt.bus.nOccup == 0)
+	if (bus->nOccup > sh->fSt.dim.t || bus->nOccup == 0)
 	{
 		perror ("Bus is Empty or OverCrowded");
 		exit (EXIT_FAILURE);
 	}
 	// summon passengers in the bus to exit
-	for (i = 0; i < sh->fSt.bus.nOccup; i++)
+	for (i = 0; i < bus->nOccup; i++)
 	{
-		if (sh->fSt.bus.seat[i] < N)
+		if ((SEAT (bus, i) != EMPTYST) && ((unsigned int) SEAT (bus, i) < sh->fSt.dim.n))
 		{
 			// Increment nPassD
-			sh->nPassD++;
-			// Wake Up Passenger
-			if (semUp (semgid, sh->pass[sh->fSt.bus.seat[i]]) == -1)
-			{
-				perror ("Error on the up operation for semaphore access (DR)");
-				exit (EXIT_FAILURE);
-			}
+			NPASSD (sh, b)++;
+			// Wake Up Passenger (all of them at once, below)
+			boardId[i] = PASSSEM (sh, SEAT (bus, i));
 		}
 		// Unknown Passenger
 		else{
@@ -372,16 +479,31 @@ static void parkTheBusAndLetPassOff (void)
 			exit (EXIT_FAILURE);
 		}
 	}
+	if (semUpMany (semgid, boardId, bus->nOccup) == -1)
+	{
+		perror ("Error on the up operation for semaphore access (DR)");
+		exit (EXIT_FAILURE);
+	}
 	//save
-	saveState (nFic, sh->fSt.nLand, &(sh->fSt));
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	if (semDown (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore statsAccess (DR)");
+		exit (EXIT_FAILURE);
+	}
+	logRingPut (semgid, sh, sh->fSt.nLand, LOGDRIVER);
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (DR)");
+		perror ("error on the up operation for semaphore statsAccess (DR)");
+		exit (EXIT_FAILURE);
+	}
+	/* exit bus seats critical region */
+	if (semUp (semgid, sh->seatsAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore seatsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	if (semDown (semgid, sh->waitingPass) == -1)
+	if (semDown (semgid, WPASSSEM (sh, b)) == -1)
 	{
 		perror ("error on the down operation for semaphore access (DR)");
 		exit (EXIT_FAILURE);
@@ -394,26 +516,28 @@ static void parkTheBusAndLetPassOff (void)
  *  The bus driver takes the bus back to the arrival transfer terminal.
  *
  *  State should be saved.
+ *
+ *  \param b bus identification
  */
 
-static void goToArrivalTerminal (void)
+static void goToArrivalTerminal (unsigned int b)
 {
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter statistics critical region */
+	if (semDown (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (DR)");
+		perror ("error on the down operation for semaphore statsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 	// Change State
-	sh->fSt.st.driverStat = DRIVING_BACKWARD;
+	BUS (&sh->fSt, b).driverStat = DRIVING_BACKWARD;
 	// Save State
-	saveState (nFic, sh->fSt.nLand, &(sh->fSt));
+	logRingPut (semgid, sh, sh->fSt.nLand, LOGDRIVER);
 
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	/* exit statistics critical region */
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (DR)");
+		perror ("error on the up operation for semaphore statsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 }
@@ -421,59 +545,45 @@ static void goToArrivalTerminal (void)
 /**
  *  \brief Park the bus.
  *
- *  The parks the bus at the arrival transfer terminal.
+ *  The parks the bus at the arrival transfer terminal, at the tail of the queue of parked buses.
  *
  *  State should be saved.
+ *
+ *  \param b bus identification
  */
 
-static void parkTheBus (void)
+static void parkTheBus (unsigned int b)
 {
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter bus queue critical region */
+	if (semDown (semgid, sh->queueAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (DR)");
+		perror ("error on the down operation for semaphore queueAccess (DR)");
+		exit (EXIT_FAILURE);
+	}
+	// Wait in line for the next boarding batch
+	queueIn(&sh->parkQueue,b);
+	/* enter statistics critical region */
+	if (semDown (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore statsAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert youy code here */
 	// Change State
-	sh->fSt.st.driverStat = PARKING_AT_THE_ARRIVAL_TERMINAL;
+	BUS (&sh->fSt, b).driverStat = PARKING_AT_THE_ARRIVAL_TERMINAL;
 	// Save State
-	saveState (nFic, sh->fSt.nLand, &(sh->fSt));
+	logRingPut (semgid, sh, sh->fSt.nLand, LOGDRIVER);
 
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	/* exit statistics critical region */
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (DR)");
+		perror ("error on the up operation for semaphore statsAccess (DR)");
+		exit (EXIT_FAILURE);
+	}
+	/* exit bus queue critical region */
+	if (semUp (semgid, sh->queueAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore queueAccess (DR)");
 		exit (EXIT_FAILURE);
 	}
-}
-
-/**
- *  \brief Signal service function.
- *
- *  Inform the bus driver he should check whether it is the right time to start the journey.
- */
-
-static void alarmCk (int signum)
-{
-  if (signum == SIGALRM)
-     { if (semDown (semgid, sh->access) == -1)                                              /* enter critical region */
-          { perror ("error on the down operation for semaphore access (DR)");
-            exit (EXIT_FAILURE);
-          }
-
-       if (semUp (semgid, sh->waitingDrive) == -1)               /* inform the bus driver he should check whether it
-                                                                              is the right time to start the journey */
-          { perror ("error on the down operation for semaphore waitingDrive (DR)");
-            exit (EXIT_FAILURE);
-          }
-
-       if (semUp (semgid, sh->access) == -1)                                                 /* exit critical region */
-          { perror ("error on the up operation for semaphore access (DR)");
-            exit (EXIT_FAILURE);
-          }
-     }
-     else { fprintf (stderr, "a signal other than SIGALRM was received (DR)!\n");
-            exit (EXIT_FAILURE);
-          }
 }
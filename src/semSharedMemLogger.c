@@ -0,0 +1,175 @@
+/**
+ *  \file semSharedMemLogger.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *  Implementation with SVIPC.
+ *
+ *  Definition of the operations carried out by the log writer process:
+ *     \li drain the ring of logging records into the logging file.
+ *
+ *  The logging sink is opened once and kept open until the end of logging mark is retrieved, so the intervening
+ *  entities only have to take a snapshot of the state into the ring.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "logging.h"
+#include "logRing.h"
+#include "logSink.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "sharedMemory.h"
+#ifdef THREAD_ENGINE
+#include "probThreadAirportRhapsody.h"
+#endif
+
+/** \brief logging file name */
+static char nFic[51];
+
+/** \brief shared memory block access identifier */
+static int shmid;
+
+/** \brief semaphore set access identifier */
+static int semgid;
+
+/** \brief pointer to shared memory region */
+static SHARED_DATA *sh;
+
+/** \brief life cycle of the log writer */
+static void lifeCycle (void);
+
+#ifndef THREAD_ENGINE
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to generate the life cycle of the log writer.
+ */
+
+int main (int argc, char *argv[])
+{
+  int key;                                                           /*access key to shared memory and semaphore set */
+  char *tinp;                                                                      /* numerical parameters test flag */
+
+  /* validation of command line parameters */
+
+  if (argc != 4)
+     { freopen ("error_GLW", "a", stderr);
+       fprintf (stderr, "Number of parameters is incorrect!\n");
+       return EXIT_FAILURE;
+     }
+     else freopen (argv[3], "w", stderr);
+  strcpy (nFic, argv[1]);
+  key = (unsigned int) strtol (argv[2], &tinp, 0);
+  if (*tinp != '\0')
+     { fprintf (stderr, "Error on the access key communication!\n");
+       return EXIT_FAILURE;
+     }
+
+  /* connection to the semaphore set and the shared memory region and mapping the shared region onto the
+     process address space */
+
+  if ((semgid = semConnect (key)) == -1)
+     { perror ("error on connecting to the semaphore set");
+       return EXIT_FAILURE;
+     }
+  if ((shmid = shmemConnect (key)) == -1)
+     { perror ("error on connecting to the shared memory region");
+       return EXIT_FAILURE;
+     }
+  if (shmemAttach (shmid, (void **) &sh) == -1)
+     { perror ("error on mapping the shared region on the process address space");
+       return EXIT_FAILURE;
+     }
+
+  /* simulation of the life cycle of the log writer */
+
+  lifeCycle ();
+
+  /* unmapping the shared region off the process address space */
+
+  if (shmemDettach (sh) == -1)
+     { perror ("error on unmapping the shared region off the process address space");
+       return EXIT_FAILURE;
+     }
+
+  return EXIT_SUCCESS;
+}
+
+#else
+
+/**
+ *  \brief Log writer set up.
+ *
+ *  Connection to the semaphore set and the shared memory region of the engine based on threads. It must be called
+ *  before the log writer thread is launched.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+void loggerSetup (char *fName, int key)
+{
+  strcpy (nFic, fName);
+  if ((semgid = semConnect (key)) == -1)
+     { perror ("error on connecting to the semaphore set (LW)");
+       exit (EXIT_FAILURE);
+     }
+  if ((shmid = shmemConnect (key)) == -1)
+     { perror ("error on connecting to the shared memory region (LW)");
+       exit (EXIT_FAILURE);
+     }
+  if (shmemAttach (shmid, (void **) &sh) == -1)
+     { perror ("error on mapping the shared region on the process address space (LW)");
+       exit (EXIT_FAILURE);
+     }
+}
+
+/**
+ *  \brief Log writer thread.
+ *
+ *  Its role is to generate the life cycle of the log writer.
+ *
+ *  \param arg not used
+ *
+ *  \return \c NULL
+ */
+
+void *loggerThread (void *arg)
+{
+  (void) arg;                                                              /* the signature is the one of a thread */
+  lifeCycle ();
+  return NULL;
+}
+
+#endif                                                                                              /* THREAD_ENGINE */
+
+/**
+ *  \brief Life cycle of the log writer.
+ *
+ *  The records are written as they are retrieved from the ring until the end of logging mark comes out.
+ */
+
+static void lifeCycle (void)
+{
+  FILE *fic;                                                                                      /* file descriptor */
+  int fmt;                                                                               /* format of the logging file */
+
+  fic = sinkOpen (nFic, false);
+  fmt = sinkFormat (nFic);
+  while (logRingGet (semgid, sh, fic, fmt));
+  sinkClose (fic);
+}
@@ -37,10 +37,18 @@
 #include "probDataStruct.h"
 #include "cam.h"
 #include "queue.h"
+#include "departure.h"
 #include "logging.h"
+#include "logRing.h"
 #include "sharedDataSync.h"
+#include "barrier.h"
+#include "network.h"
+#include "resident.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#ifdef THREAD_ENGINE
+#include "probThreadAirportRhapsody.h"
+#endif
 
 /** \brief logging file name */
 static char nFic[51];
@@ -54,6 +62,12 @@ static int semgid;
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
+/** \brief semaphore set access identifier of the next airport of the network */
+static int semgidNext;
+
+/** \brief pointer to shared memory region of the next airport of the network (\c NULL, if there is none) */
+static SHARED_DATA *shNext = NULL;
+
 /** \brief the passenger has this airport as her final destination and has bags to collect */
 #define FDBTC          0
 
@@ -96,6 +110,14 @@ static void leaveTheBus (unsigned int k, unsigned int id);
 /** \brief prepare next leg operation */
 static void prepareNextLeg (unsigned int k, unsigned int id);
 
+/** \brief arrive at the end-of-flight barrier */
+static bool arriveAtFlightEnd (unsigned int k, unsigned int *p_sense);
+
+/** \brief life cycle of the passenger */
+static void lifeCycle (unsigned int p);
+
+#ifndef THREAD_ENGINE
+
 /**
  *  \brief Main program.
  *
@@ -107,9 +129,9 @@ int main (int argc, char *argv[])
 {
   int key;                                                           /*access key to shared memory and semaphore set */
   char *tinp;                                                                      /* numerical parameters test flag */
-  unsigned int k;                                                                                   /* flight number */
   unsigned int p;                                                                        /* passenger identification */
-  unsigned int stat;                                                                          /* status of operation */
+  unsigned int nDays;                                                                        /* number of days lived */
+  int shmidNext;                                              /* shared memory access identifier of the next airport */
 
   /* validation of command line parameters */
 
@@ -120,7 +142,7 @@ int main (int argc, char *argv[])
      }
      else freopen (argv[4], "w", stderr);
   p = (unsigned int) strtol (argv[1], &tinp, 0);
-  if ((*tinp != '\0') || (p >= N))
+  if (*tinp != '\0')
      { fprintf (stderr, "Passenger process identification is wrong!\n");
        return EXIT_FAILURE;
      }
@@ -146,10 +168,108 @@ int main (int argc, char *argv[])
      { perror ("error on mapping the shared region on the process address space");
        return EXIT_FAILURE;
      }
+  if (p >= sh->fSt.dim.n)
+     { fprintf (stderr, "Passenger process identification is wrong!\n");
+       return EXIT_FAILURE;
+     }
 
-  /* simulation of the life cycle of the passenger */
+  /* connection to the semaphore set and the shared memory region of the next airport of the network, if there is
+     one, to hand off the passengers in transit */
+
+  if (sh->net.nextKey != -1)
+     { if ((semgidNext = semConnect (sh->net.nextKey)) == -1)
+          { perror ("error on connecting to the semaphore set of the next airport");
+            return EXIT_FAILURE;
+          }
+       if ((shmidNext = shmemConnect (sh->net.nextKey)) == -1)
+          { perror ("error on connecting to the shared memory region of the next airport");
+            return EXIT_FAILURE;
+          }
+       if (shmemAttach (shmidNext, (void **) &shNext) == -1)
+          { perror ("error on mapping the shared region of the next airport on the process address space");
+            return EXIT_FAILURE;
+          }
+     }
+
+  /* simulation of the life cycle of the passenger, one day after another if the airport is resident */
+
+  nDays = 0;
+  while (dayBegin (semgid, sh, &nDays))
+    lifeCycle (p);
 
-  for (k = 0; k < K; k++)
+  /* unmapping the shared regions off the process address space */
+
+  if ((shNext != NULL) && (shmemDettach (shNext) == -1))
+     { perror ("error on unmapping the shared region of the next airport off the process address space");
+       return EXIT_FAILURE;
+     }
+  if (shmemDettach (sh) == -1)
+     { perror ("error on unmapping the shared region off the process address space");
+       return EXIT_FAILURE;;
+     }
+
+  return EXIT_SUCCESS;
+}
+
+#else
+
+/**
+ *  \brief Passengers set up.
+ *
+ *  Connection to the semaphore set and the shared memory region of the engine based on threads. It must be called
+ *  once before the passenger threads are launched.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+void passengerSetup (char *fName, int key)
+{
+  strcpy (nFic, fName);
+  if ((semgid = semConnect (key)) == -1)
+     { perror ("error on connecting to the semaphore set (PA)");
+       exit (EXIT_FAILURE);
+     }
+  if ((shmid = shmemConnect (key)) == -1)
+     { perror ("error on connecting to the shared memory region (PA)");
+       exit (EXIT_FAILURE);
+     }
+  if (shmemAttach (shmid, (void **) &sh) == -1)
+     { perror ("error on mapping the shared region on the process address space (PA)");
+       exit (EXIT_FAILURE);
+     }
+}
+
+/**
+ *  \brief Passenger thread.
+ *
+ *  Its role is to generate the life cycle of one of intervening entities in the problem: the passenger.
+ *
+ *  \param arg pointer to the location where the passenger identification is stored
+ *
+ *  \return \c NULL
+ */
+
+void *passengerThread (void *arg)
+{
+  lifeCycle (*((unsigned int *) arg));
+  return NULL;
+}
+
+#endif /* THREAD_ENGINE */
+
+/**
+ *  \brief Life cycle of the passenger.
+ *
+ *  \param p passenger identification
+ */
+
+static void lifeCycle (unsigned int p)
+{
+  unsigned int k;                                                                                   /* flight number */
+  unsigned int stat;                                                                          /* status of operation */
+
+  for (k = 0; k < sh->fSt.dim.k; k++)
     switch (whatShouldIDo (k, p))                                          /* the passenger decides on her next move */
     { case FDBTC:                                /* she has arrived to her final destination and has bags to collect */
                                 /* the passenger goes to the luggage collection point to pick up her bags one by one */
@@ -171,15 +291,6 @@ int main (int argc, char *argv[])
                                                                                                   leg of the journey */
         break;
     }
-
-  /* unmapping the shared region off the process address space */
-
-  if (shmemDettach (sh) == -1)
-     { perror ("error on unmapping the shared region off the process address space");
-       return EXIT_FAILURE;;
-     }
-
-  return EXIT_SUCCESS;
 }
 
 /**
@@ -189,8 +300,9 @@ int main (int argc, char *argv[])
  *  as her final destination and has bags to collect / has this airport as her final destination with no bags to
  *  collect / is in transit) and updates statistical information.
  *
- *  If she is the very last passenger descending from the plane, she must inform the porter that a new plane has
- *  landed. If she is the very first passenger, she sets the number of the plane landing.
+ *  If she is the very last passenger descending from the plane, she must inform the porters that a new plane has
+ *  landed. If she is the very first passenger, she sets the number of the plane landing and, if the airport is part
+ *  of a network, she first lets the passengers handed off by the previous airport take their seats in the plane.
  *
  *  State should only be saved by the very first passenger descending from the plane.
  *
@@ -205,20 +317,44 @@ int main (int argc, char *argv[])
 static unsigned int whatShouldIDo (unsigned int k, unsigned int id)
 {
 	unsigned int stat = INTRAN;
-	/* Enter Critical Region */
-	if (semDown (semgid, sh->access) == -1)
+	/* Enter Landing Critical Region */
+	if (semDown (semgid, sh->landAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore landAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	// Update statistical information
-	sh->nPassP++;
+	// Update statistical information (several flights may be under way, each one with its own count)
+	NPASSP (sh, k)++;
+	//if she is the very first passenger descending from a plane of an airport of a network
+	if ((NPASSP (sh, k) == 1) && (sh->net.nAirports > 1))
+	{
+		/* Enter Inbound Channel Critical Region */
+		if (semDown (semgid, sh->net.inAccess) == -1)
+		{
+			perror ("error on the down operation for semaphore inAccess (PA)");
+			exit (EXIT_FAILURE);
+		}
+		//the passengers handed off by the previous airport board the plane before anyone looks at her state
+		netBoard (sh, k);
+		/* Exit Inbound Channel Critical Region */
+		if (semUp (semgid, sh->net.inAccess) == -1)
+		{
+			perror ("error on the up operation for semaphore inAccess (PA)");
+			exit (EXIT_FAILURE);
+		}
+	}
 	// Change State
-	sh->fSt.st.passStat[k][id].stat = AT_THE_DISEMBARKING_ZONE;
+	PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_DISEMBARKING_ZONE;
 
+	/* Enter Statistics Critical Region */
+	if (semDown (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
 	//if she is in transit
-	if(sh->fSt.st.passStat[k][id].sit==TRT){
+	if(PASSSTAT (&(sh->fSt), k, id).sit==TRT){
 		//update statistical information
 		sh->fSt.nToTPassTST++;
 	}
@@ -226,7 +362,7 @@ static unsigned int whatShouldIDo (unsigned int k, unsigned int id)
 		//if she is in her final destination
 		sh->fSt.nToTPassFD++;
 		//and no bags to collect
-		if(sh->fSt.st.passStat[k][id].nBagsReal==0)
+		if(PASSSTAT (&(sh->fSt), k, id).nBagsReal==0)
 			stat= FDNBTC;
 		//or has bags to collect
 		else
@@ -234,26 +370,35 @@ static unsigned int whatShouldIDo (unsigned int k, unsigned int id)
 	}
 
 	//if she is the very first passenger descending from the plane
-	if(sh->nPassP % N == 1)
+	if(NPASSP (sh, k) == 1)
 	{
 		//she sets the number of the plane landing
 		sh->fSt.nLand=k;
 		//state should only be saved by the first passenger descending from plane
-		saveState (nFic,k,&(sh->fSt));
+		logRingPut (semgid, sh, k, id);
 	}
-	else
-		//if she is the very last passenger descending
-		if(sh->nPassP % N == 0)
-		//she must inform the porter that a new plane has landed
-		if (semUp(semgid, sh->waitingFlight) == -1)
+	/* Exit Statistics Critical Region */
+	if (semUp (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
+	//if she is the very last passenger descending
+	if(NPASSP (sh, k) == sh->fSt.dim.n)
+	{
+		//the count starts over for the plane landing which will take its place
+		NPASSP (sh, k) = 0;
+		//she must inform the porters that a new plane has landed
+		if (semUpMany(semgid, &PORTSEM (sh, 0), sh->fSt.dim.p) == -1)
 		{
 			perror ("error on the up operation for semaphore waitingFlight (PA)");
 			exit (EXIT_FAILURE);
 		}
-	/* Exit Critical Region */
-	if (semUp (semgid, sh->access) == -1)
+	}
+	/* Exit Landing Critical Region */
+	if (semUp (semgid, sh->landAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore landAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	return stat;
@@ -263,8 +408,8 @@ static unsigned int whatShouldIDo (unsigned int k, unsigned int id)
  *  \brief Go collect a bag.
  *
  *  The passenger waits until she receives a call from the porter. She then checks if there is a bag on the belt
- *  conveyor that belongs to her. If so, she picks it up and updates the number of bags already recovered. If not,
- *  she updates statistical information. Upon exit, a decision is taken about her present situation.
+ *  conveyor she collects from that belongs to her. If so, she picks it up and updates the number of bags already
+ *  recovered. If not, she updates statistical information. Upon exit, a decision is taken about her present situation.
  *
  *  State may be be saved twice. The first of the two only if there is a change of state of the passenger.
  *
@@ -279,51 +424,54 @@ static unsigned int whatShouldIDo (unsigned int k, unsigned int id)
 static unsigned int goCollectABag (unsigned int k, unsigned int id)
 {
 	unsigned int retorno;
-	/* Enter Critical Region */
-	if (semDown (semgid, sh->access) == -1)
+	// The belt she collects from (she only contends with the passengers sharing it)
+	unsigned int c = BELTOF (&(sh->fSt), id);
+	CAM *belt = &BELT (&(sh->fSt), c);
+	/* Enter Statistics Critical Region */
+	if (semDown (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore statsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	// Different State?
-	if (sh->fSt.st.passStat[k][id].stat == AT_THE_DISEMBARKING_ZONE)
+	if (PASSSTAT (&(sh->fSt), k, id).stat == AT_THE_DISEMBARKING_ZONE)
 	{
 		//if there is a state change
-		sh->fSt.st.passStat[k][id].stat = AT_THE_LUGGAGE_COLLECTION_POINT;
+		PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_LUGGAGE_COLLECTION_POINT;
 		//save state
-		saveState (nFic,k,&(sh->fSt));
+		logRingPut (semgid, sh, k, id);
 	}
 
-	/* Exit Critical Region */
-	if (semUp (semgid, sh->access) == -1)
+	/* Exit Statistics Critical Region */
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore statsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 
 	// The passenger waits until she receives a call from the porter.
-	if (semDown (semgid, sh->pass[id]) == -1)
+	if (semDown (semgid, PASSSEM (sh, id)) == -1)
 	{
 		perror ("error on the down operation for semaphore Passenger[i] (PA)");
 		exit (EXIT_FAILURE);
 	}
 
-	/* Enter Critical Region */
-	if (semDown (semgid, sh->access) == -1)
+	/* Enter Belt Critical Region */
+	if (semDown (semgid, BELTSEM (sh, c)) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore beltAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 	//update nCalls
-	sh->nCalls[id]--;
+	NCALLS (sh, id)--;
 
 	//If the belt is empty
-	if(camEmpty(&sh->fSt.convBelt))
+	if(camEmpty(belt))
 	{
 		//and the passenger doesnt have all her bags
-		if(sh->fSt.st.passStat[k][id].nBagsAct < sh->fSt.st.passStat[k][id].nBagsReal)
+		if(PASSSTAT (&(sh->fSt), k, id).nBagsAct < PASSSTAT (&(sh->fSt), k, id).nBagsReal)
 			//she has missing bags
 			retorno = MB;
 		else
@@ -334,13 +482,13 @@ static unsigned int goCollectABag (unsigned int k, unsigned int id)
 	{
 		//goCollectBag
 		//if there is a bag in the belt
-		if(camSearch(&sh->fSt.convBelt,id))
+		if(camSearch(belt,id))
 		{
 			//she collects it
-			camOut(&sh->fSt.convBelt,id);
-			sh->fSt.st.passStat[k][id].nBagsAct++;
+			camOut(belt,id);
+			PASSSTAT (&(sh->fSt), k, id).nBagsAct++;
 
-			if(sh->fSt.st.passStat[k][id].nBagsAct < sh->fSt.st.passStat[k][id].nBagsReal)
+			if(PASSSTAT (&(sh->fSt), k, id).nBagsAct < PASSSTAT (&(sh->fSt), k, id).nBagsReal)
 				//she has more bags to collect
 				retorno = NO;
 			else
@@ -351,7 +499,7 @@ static unsigned int goCollectABag (unsigned int k, unsigned int id)
 		else
 		{
 			//and she doesnt have all her bags
-			if(sh->fSt.st.passStat[k][id].nBagsAct < sh->fSt.st.passStat[k][id].nBagsReal)
+			if(PASSSTAT (&(sh->fSt), k, id).nBagsAct < PASSSTAT (&(sh->fSt), k, id).nBagsReal)
 				//she has missing bags
 				retorno = MB;
 			else
@@ -359,13 +507,28 @@ static unsigned int goCollectABag (unsigned int k, unsigned int id)
 				retorno = YES;
 		}
 	}
-	// Save State
-	saveState (nFic,k,&(sh->fSt));
+	// Save State (unless logging is off)
+	if (LOGACTIVE (&(sh->fSt)))
+	{
+		/* Enter Statistics Critical Region */
+		if (semDown (semgid, sh->statsAccess) == -1)
+		{
+			perror ("error on the down operation for semaphore statsAccess (PA)");
+			exit (EXIT_FAILURE);
+		}
+		logRingPut (semgid, sh, k, id);
+		/* Exit Statistics Critical Region */
+		if (semUp (semgid, sh->statsAccess) == -1)
+		{
+			perror ("error on the up operation for semaphore statsAccess (PA)");
+			exit (EXIT_FAILURE);
+		}
+	}
 
-	/* Exit Critical Region */
-	if (semUp(semgid, sh->access) == -1)
+	/* Exit Belt Critical Region */
+	if (semUp(semgid, BELTSEM (sh, c)) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore beltAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	return retorno;
@@ -384,23 +547,23 @@ static unsigned int goCollectABag (unsigned int k, unsigned int id)
 
 static void reportMissingBags (unsigned int k, unsigned int id)
 {
-	/* Enter Critical Region */
-	if (semDown (semgid, sh->access) == -1)
+	/* Enter Statistics Critical Region */
+	if (semDown (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore statsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 
 	// Change State
-	sh->fSt.st.passStat[k][id].stat = AT_THE_BAGGAGE_RECLAIM_OFFICE;
+	PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_BAGGAGE_RECLAIM_OFFICE;
 	// Save State
-	saveState (nFic,k,&(sh->fSt));
+	logRingPut (semgid, sh, k, id);
 
-	/* Exit Critical Region */
-	if (semUp (semgid, sh->access) == -1)
+	/* Exit Statistics Critical Region */
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore statsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 }
@@ -410,9 +573,10 @@ static void reportMissingBags (unsigned int k, unsigned int id)
  *
  *  The passenger exits the airport.
  *
- *  However, before actually doing that, she waits for all other passengers being ready to either exit the airport or
- *  also enter the departure terminal and, if she is the very last passenger of the very last flight, she informs the
- *  bus driver that his day's work is finished.
+ *  However, before actually doing that, she waits for all other passengers of her flight being ready to either exit
+ *  the airport or also enter the departure terminal (of the flight W-1 landings back, if several flights may be under
+ *  way) and, if she is the very last passenger of the very last flight, she informs the bus drivers that their day's
+ *  work is finished.
  *
  *  State should be saved.
  *
@@ -422,61 +586,49 @@ static void reportMissingBags (unsigned int k, unsigned int id)
 
 void goHome (unsigned int k, unsigned int id)
 {
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter landing critical region */
+	if (semDown (semgid, sh->landAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore landAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	int counter=0,i;
+	unsigned int sense;
+	bool pass;
 	//state change
-	sh->fSt.st.passStat[k][id].stat = EXITING_THE_ARRIVAL_TERMINAL;
+	PASSSTAT (&(sh->fSt), k, id).stat = EXITING_THE_ARRIVAL_TERMINAL;
 
-	//She checks if all passengers are ready leave the airport
-	for(i=0; i<N; i++)
+	//She checks in at the end-of-flight barrier; the last one to arrive wakes up those waiting for her flight
+	pass = arriveAtFlightEnd (k, &sense);
+	/* enter statistics critical region */
+	if (semDown (semgid, sh->statsAccess) == -1)
 	{
-		if(sh->fSt.st.passStat[k][i].stat==ENTERING_THE_DEPARTURE_TERMINAL|| sh->fSt.st.passStat[k][i].stat==EXITING_THE_ARRIVAL_TERMINAL)
-		{
-			counter++;
-		}
+		perror ("error on the down operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
 	}
-	//if they are
-	if(counter==N)
+	// Save State
+	logRingPut (semgid, sh, k, id);
+	/* exit statistics critical region */
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		for(i=0; i<N; i++)
-		{
-			if(i!=id)
-				// Wake Up Passenger
-				if (semUp (semgid, sh->pass[i]) == -1)
-				{
-					perror ("error on the up operation for semaphore Passenger[i] (PA)");
-					exit (EXIT_FAILURE);
-				}
-		}
-		//last passenger of last flight
-		if(k==K-1)
-		{
-			sh->fSt.dayEnded = true;
-		}
+		perror ("error on the up operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
 	}
-	// Save State
-	saveState (nFic,k,&(sh->fSt));
 
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	/* exit landing critical region */
+	if (semUp (semgid, sh->landAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore landAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	//if not all can leave the airport
-	if(counter!=N)
+	//if an earlier flight is not over yet (her own, when flights follow each other)
+	if(!pass)
 	{
 		//she waits
-		if (semDown (semgid, sh->pass[id]) == -1)
+		if (semDown (semgid, BARRIERSEM (&sh->flightEnd, sense)) == -1)
 		{
-			perror ("error on the down operation for semaphore Passenger[i] (PA)");
+			perror ("error on the down operation for semaphore flightEnd (PA)");
 			exit (EXIT_FAILURE);
 		}
 	}
@@ -487,8 +639,10 @@ void goHome (unsigned int k, unsigned int id)
  *
  *  The transit passenger queues at the arrival transfer terminal to take a bus to the departure transfer terminal.
  *
- *  However, before waiting her turn, she informs the bus driver it is time to start boarding if the number of queueing
- *  passengers is equal to the number of seats in the bus.
+ *  However, before waiting her turn, she informs the driver of the bus at the head of the queue of parked buses, if
+ *  any, it is time to start boarding if the number of queueing passengers reaches the load threshold of the timetable
+ *  (the number of seats in the bus, by default). If she is the first one in line, she informs him as well, so that he
+ *  starts counting down to departure. She is told which bus to board when she is summoned.
  *
  *  State should be saved.
  *
@@ -499,49 +653,50 @@ void goHome (unsigned int k, unsigned int id)
 static void takeABus (unsigned int k, unsigned int id)
 {
 
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter bus queue critical region */
+	if (semDown (semgid, sh->queueAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore queueAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 
 	// Change State
-	sh->fSt.st.passStat[k][id].stat = AT_THE_ARRIVAL_TRANSFER_TERMINAL;
+	PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_ARRIVAL_TRANSFER_TERMINAL;
 	//the transit passenger queues at the arrival transfer terminal
 	queueIn(&sh->fSt.busQueue,id);
-	//if the number of queueing passengers equals the number of sits in the bus
-	int i, counter = 0;
-	for (i = 0; i < T; i++)
+	//if she is the first one in the queue (the driver starts his count down to departure) or the number of queueing
+	//passengers reaches the load threshold of the timetable
+	if (depQueued(&sh->fSt,id,depClock()) && !queueEmpty(&sh->parkQueue))
 	{
-		//if the number of queueing passengers
-		if(queuePeek(&sh->fSt.busQueue,i) != EMPTYPOS)
-		{
-			counter++;
-		}
-	}
-	// Full
-	if (counter == T)
-	{
-		//she informs the bus driver it is time start boarding
-		if (semUp (semgid, sh->waitingDrive) == -1)
+		//she informs the driver of the next bus it is time start boarding, or time to start counting down
+		if (semUp (semgid, DRIVESEM (sh, queuePeek(&sh->parkQueue,0))) == -1)
 		{
 			perror ("error on the up operation for semaphore waitingDrive (PA)");
 			exit (EXIT_FAILURE);
 		}
 	}
 	//savestate
-	saveState (nFic,k,&(sh->fSt));
-	//exit critical region
-	if (semUp (semgid, sh->access) == -1)
+	if (semDown (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
+	logRingPut (semgid, sh, k, id);
+	if (semUp (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
+	//exit bus queue critical region
+	if (semUp (semgid, sh->queueAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore queueAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 	//she waits her turn
-	if (semDown (semgid, sh->pass[id]) == -1)
+	if (semDown (semgid, PASSSEM (sh, id)) == -1)
 	{
 		perror ("error on the down operation for semaphore Passenger[i] (PA)");
 		exit (EXIT_FAILURE);
@@ -552,8 +707,8 @@ static void takeABus (unsigned int k, unsigned int id)
 /**
  *  \brief Enter the bus.
  *
- *  The passenger enters the bus that it is going to take her to the departure transfer terminal and occupies
- *  an available seat.
+ *  The passenger enters the bus she has been handed to, that it is going to take her to the departure transfer
+ *  terminal, and occupies an available seat.
  *  If it is already packed full, she issues an error message.
  *  If she is the last one to board the bus for the ride, she informs the driver he may start the journey.
  *
@@ -565,58 +720,70 @@ static void takeABus (unsigned int k, unsigned int id)
 
 static void enterTheBus (unsigned int k, unsigned int id)
 {
-	/* Enter Critical Region */
-	if (semDown (semgid, sh->access) == -1)
+	/* Enter Bus Seats Critical Region */
+	if (semDown (semgid, sh->seatsAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore seatsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	int i;
+	unsigned int i;
+	unsigned int b = PASSBUS (sh, id);
+	TRANSF_INFO *bus = &BUS (&sh->fSt, b);
 	// If it is already packed full, she issues an error message.
-	if(sh->fSt.bus.nOccup==T)
+	if(bus->nOccup==sh->fSt.dim.t)
 	{
 		perror ("error, the bus is full");
 		exit (EXIT_FAILURE);
 	}
 	//change state
-	sh->fSt.st.passStat[k][id].stat = TERMINAL_TRANSFER;
+	PASSSTAT (&(sh->fSt), k, id).stat = TERMINAL_TRANSFER;
 	// Decrement number of passengers who have executed either the operation enterTheBus or leaveTheBus
-	sh->nPassD--;
+	NPASSD (sh, b)--;
 
 	//leave the queue and enter the bus
-	for(i=0;i<T;i++)
+	for(i=0;i<sh->fSt.dim.t;i++)
 	{
-		if(sh->fSt.bus.seat[i]==EMPTYST)
+		if(SEAT (bus, i)==EMPTYST)
 		{
-			sh->fSt.bus.seat[i]=id;
-			sh->fSt.bus.nOccup++;
+			SEAT (bus, i)=id;
+			bus->nOccup++;
 			break;
 		}
 	}
 
 	//if she is the last one
-	if (sh->nPassD==0)
+	if (NPASSD (sh, b)==0)
 	{
 		//wake up the driver
-		if (semUp (semgid, sh->waitingPass) == -1)
+		if (semUp (semgid, WPASSSEM (sh, b)) == -1)
 		{
 			perror ("error on the up operation for semaphore waitingPass (PA)");
 			exit (EXIT_FAILURE);
 		}
 	}
 	//save state
-	saveState (nFic,k,&(sh->fSt));
+	if (semDown (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
+	logRingPut (semgid, sh, k, id);
+	if (semUp (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
 
-	/* Exit Critical Region */
-	if (semUp (semgid, sh->access) == -1)
+	/* Exit Bus Seats Critical Region */
+	if (semUp (semgid, sh->seatsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore seatsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
     /* insert your code here */
 	//sleep me
-	if (semDown (semgid, sh->pass[id]) == -1)
+	if (semDown (semgid, PASSSEM (sh, id)) == -1)
 	{
 		perror ("error on the down operation for semaphore Passenger[i] (PA)");
 		exit (EXIT_FAILURE);
@@ -638,52 +805,64 @@ static void enterTheBus (unsigned int k, unsigned int id)
 
 static void leaveTheBus (unsigned int k, unsigned int id)
 {
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	/* enter bus seats critical region */
+	if (semDown (semgid, sh->seatsAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore seatsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
-	int i;
+	unsigned int i;
+	unsigned int b = PASSBUS (sh, id);
+	TRANSF_INFO *bus = &BUS (&sh->fSt, b);
 	//if the bus is already empty
-	if(sh->fSt.bus.nOccup==0)
+	if(bus->nOccup==0)
 	{
 		//she issues an error message
 		perror ("error, the bus is already empty");
 		exit (EXIT_FAILURE);
 	}
 	//change state
-	sh->fSt.st.passStat[k][id].stat = AT_THE_DEPARTURE_TRANSFER_TERMINAL;
+	PASSSTAT (&(sh->fSt), k, id).stat = AT_THE_DEPARTURE_TRANSFER_TERMINAL;
 
 	//she leaves the bust
-	for(i=0;i<T;i++)
+	for(i=0;i<sh->fSt.dim.t;i++)
 	{
-		if(sh->fSt.bus.seat[i] == id)
+		if(SEAT (bus, i) == (int) id)
 		{
-			sh->fSt.bus.seat[i] = EMPTYST;
-			sh->fSt.bus.nOccup--;
+			SEAT (bus, i) = EMPTYST;
+			bus->nOccup--;
 			break;
 		}
 	}
 	// Decrement number of passengers who have executed either the operation enterTheBus or leaveTheBus
-	sh->nPassD--;
+	NPASSD (sh, b)--;
 
 	//if she is the last one to exit
-	if(sh->nPassD==0){
-		if (semUp (semgid, sh->waitingPass) == -1)
+	if(NPASSD (sh, b)==0){
+		if (semUp (semgid, WPASSSEM (sh, b)) == -1)
 		{
 			perror ("error on the up operation for semaphore waitingPass (PA)");
 			exit (EXIT_FAILURE);
 		}
 	}
 	//save state
-	saveState (nFic,k,&(sh->fSt));
+	if (semDown (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
+	logRingPut (semgid, sh, k, id);
+	if (semUp (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
 
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	/* exit bus seats critical region */
+	if (semUp (semgid, sh->seatsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore seatsAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 
@@ -694,9 +873,11 @@ static void leaveTheBus (unsigned int k, unsigned int id)
  *
  *  The passenger enters the departure terminal.
  *
- *  However, before actually doing that, she waits for all other passengers being ready to either exit the airport or
- *  also enter the departure terminal and, if she is the very last passenger of the very last flight, she informs the
- *  bus driver that his day's work is finished.
+ *  However, before actually doing that, she waits for all other passengers of her flight being ready to either exit
+ *  the airport or also enter the departure terminal (of the flight W-1 landings back, if several flights may be under
+ *  way) and, if she is the very last passenger of the very last flight, she informs the bus drivers that their day's
+ *  work is finished. If the airport is part of a network, she is handed off to the next airport, together with her
+ *  bags placed in the storeroom, unless its inbound channel is full.
  *
  *  State should be saved.
  *
@@ -706,61 +887,119 @@ static void leaveTheBus (unsigned int k, unsigned int id)
 
 static void prepareNextLeg (unsigned int k, unsigned int id)
 {
-	int counter=0,i;
-	/* enter critical region */
-	if (semDown (semgid, sh->access) == -1)
+	unsigned int sense;
+	bool pass;
+	/* enter landing critical region */
+	if (semDown (semgid, sh->landAccess) == -1)
 	{
-		perror ("error on the down operation for semaphore access (PA)");
+		perror ("error on the down operation for semaphore landAccess (PA)");
 		exit (EXIT_FAILURE);
 	}
 	/* insert your code here */
 	//state change
-	sh->fSt.st.passStat[k][id].stat = ENTERING_THE_DEPARTURE_TERMINAL;
+	PASSSTAT (&(sh->fSt), k, id).stat = ENTERING_THE_DEPARTURE_TERMINAL;
 
-	//She checks if all passengers are ready leave the airport or also enter the departure terminal
-	for(i=0; i<N; i++)
+	//She checks in at the end-of-flight barrier; the last one to arrive wakes up those waiting for her flight
+	pass = arriveAtFlightEnd (k, &sense);
+	/* enter statistics critical region */
+	if (semDown (semgid, sh->statsAccess) == -1)
 	{
-		if(sh->fSt.st.passStat[k][i].stat==ENTERING_THE_DEPARTURE_TERMINAL || sh->fSt.st.passStat[k][i].stat==EXITING_THE_ARRIVAL_TERMINAL)
-		{
-			counter++;
-		}
+		perror ("error on the down operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
+	logRingPut (semgid, sh, k, id);
+	/* exit statistics critical region */
+	if (semUp (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore statsAccess (PA)");
+		exit (EXIT_FAILURE);
+	}
+
+	/* exit landing critical region */
+	if (semUp (semgid, sh->landAccess) == -1)
+	{
+		perror ("error on the up operation for semaphore landAccess (PA)");
+		exit (EXIT_FAILURE);
 	}
-	//if they are
-	if(counter==N)
+	/* insert your code here */
+	//she is handed off to the next airport of the network, if there is one
+	if (shNext != NULL)
 	{
-		for(i=0; i<N; i++)
+		/* enter inbound channel critical region of the next airport */
+		if (semDown (semgidNext, shNext->net.inAccess) == -1)
+		{
+			perror ("error on the down operation for semaphore inAccess of the next airport (PA)");
+			exit (EXIT_FAILURE);
+		}
+		netHandOff (shNext, PASSSTAT (&(sh->fSt), k, id).nBagsReal);
+		/* exit inbound channel critical region of the next airport */
+		if (semUp (semgidNext, shNext->net.inAccess) == -1)
 		{
-			if(i!=id)
-				//semUp
-				if (semUp (semgid, sh->pass[i]) == -1)
-				{
-					perror ("error on the up operation for semaphore Passenger[i] (PA)");
-					exit (EXIT_FAILURE);
-				}
+			perror ("error on the up operation for semaphore inAccess of the next airport (PA)");
+			exit (EXIT_FAILURE);
 		}
-		//last passenger of last flight
-		if(k==K-1)
+	}
+	//if an earlier flight is not over yet (her own, when flights follow each other)
+	if(!pass)
+	{
+		//she waits
+		if (semDown (semgid, BARRIERSEM (&sh->flightEnd, sense)) == -1)
 		{
-			sh->fSt.dayEnded = true;
+			perror ("error on the down operation for semaphore flightEnd (PA)");
+			exit (EXIT_FAILURE);
 		}
 	}
-	saveState (nFic,k,&(sh->fSt));
+}
+
+/**
+ *  \brief Arrive at the end-of-flight barrier.
+ *
+ *  The passenger is counted among those going out of the arrival terminal in her flight. If she is the last one of the
+ *  flight, she wakes up all at once the passengers waiting for it to be over and, if it is the very last flight, she
+ *  informs the bus drivers that their day's work is finished. It must be called within the landing critical region.
+ *
+ *  \param k plane landing number
+ *  \param p_sense pointer to the location where the sense to wait on is to be stored
+ *
+ *  \return \c true, if she may go on
+ *  \return \c false, if she must wait for an earlier flight to be over (her own, with a window of one flight)
+ */
+
+static bool arriveAtFlightEnd (unsigned int k, unsigned int *p_sense)
+{
+	unsigned int nRel;
+	unsigned int stat = barrierArrive (&sh->flightEnd, k, p_sense, &nRel);
 
-	/* exit critical region */
-	if (semUp (semgid, sh->access) == -1)
+	if (stat == BARRIER_WAIT)
+		return false;
+	// Wake Up Passengers, all of them at once
+	if ((nRel > 0) && (semUpBy (semgid, BARRIERSEM (&sh->flightEnd, *p_sense), nRel) == -1))
 	{
-		perror ("error on the up operation for semaphore access (PA)");
+		perror ("error on the up operation for semaphore flightEnd (PA)");
 		exit (EXIT_FAILURE);
 	}
-	/* insert your code here */
-	//if not all can leave the airport
-	if(counter!=N)
+	//last passenger of last flight
+	if (stat == BARRIER_FINAL)
 	{
-		//she waits
-		if (semDown (semgid, sh->pass[id]) == -1)
+		/* enter bus queue critical region */
+		if (semDown (semgid, sh->queueAccess) == -1)
+		{
+			perror ("error on the down operation for semaphore queueAccess (PA)");
+			exit (EXIT_FAILURE);
+		}
+		sh->fSt.dayEnded = true;
+		//the drivers are told, all of them at once, so that they do not sleep forever on an empty queue
+		if (semUpMany (semgid, &DRIVESEM (sh, 0), sh->fSt.dim.b) == -1)
+		{
+			perror ("error on the up operation for semaphore waitingDrive (PA)");
+			exit (EXIT_FAILURE);
+		}
+		/* exit bus queue critical region */
+		if (semUp (semgid, sh->queueAccess) == -1)
 		{
-			perror ("error on the down operation for semaphore Passenger[i] (PA)");
+			perror ("error on the up operation for semaphore queueAccess (PA)");
 			exit (EXIT_FAILURE);
 		}
 	}
+	return true;
 }
@@ -8,7 +8,7 @@
  *  Synchronization based on semaphores and shared memory.
  *  Implementation with SVIPC.
  *
- *  Definition of the operations carried out by the porter process:
+ *  Definition of the operations carried out by the porter processes:
  *     \li take a rest
  *     \li try to collect a bag
  *     \li carry it to the appropriate store
@@ -33,9 +33,14 @@
 #include "probDataStruct.h"
 #include "cam.h"
 #include "logging.h"
+#include "logRing.h"
 #include "sharedDataSync.h"
+#include "resident.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#ifdef THREAD_ENGINE
+#include "probThreadAirportRhapsody.h"
+#endif
 
 /** \brief logging file name */
 static char nFic[51];
@@ -49,17 +54,26 @@ static int semgid;
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
+/** \brief semaphores of the passengers told their bags are missing (N entries, used by the last porter to find the
+ *         plane's hold empty only, so that it may be shared by the porter threads) */
+static unsigned int *missSem = NULL;
+
 /** \brief take a rest operation */
-static void takeARest (unsigned int k);
+static void takeARest (unsigned int id);
 
 /** \brief try to collect a bag operation */
-static bool tryToCollectABag (unsigned int k, BAG *p_bag);
+static bool tryToCollectABag (unsigned int k, BAG *p_bag, bool *p_last);
 
 /** \brief carry it to an appropriate store operation */
 static void carryItToAppropriateStore (unsigned int k, BAG *p_bag);
 
 /** \brief no more bags operation */
-static void noMoreBagsToCollect (unsigned int k);
+static void noMoreBagsToCollect (unsigned int k, bool last);
+
+/** \brief life cycle of the porter */
+static void lifeCycle (unsigned int id);
+
+#ifndef THREAD_ENGINE
 
 /**
  *  \brief Main program.
@@ -71,19 +85,24 @@ int main (int argc, char *argv[])
 {
   int key;                                                           /*access key to shared memory and semaphore set */
   char *tinp;                                                                      /* numerical parameters test flag */
-  unsigned int k;                                                                                   /* flight number */
-  BAG bag;                                                                       /* piece of luggage to be processed */
+  unsigned int p;                                                                           /* porter identification */
+  unsigned int nDays;                                                                        /* number of days lived */
 
   /* validation of command line parameters */
 
-  if (argc != 4)
+  if (argc != 5)
      { freopen ("error_GPO", "a", stderr);
        fprintf (stderr, "Number of parameters is incorrect!\n");
        return EXIT_FAILURE;
      }
-     else freopen (argv[3], "w", stderr);
-  strcpy (nFic, argv[1]);
-  key = (unsigned int) strtol (argv[2], &tinp, 0);
+     else freopen (argv[4], "w", stderr);
+  p = (unsigned int) strtol (argv[1], &tinp, 0);
+  if (*tinp != '\0')
+     { fprintf (stderr, "Porter process identification is wrong!\n");
+       return EXIT_FAILURE;
+     }
+  strcpy (nFic, argv[2]);
+  key = (unsigned int) strtol (argv[3], &tinp, 0);
   if (*tinp != '\0')
      { fprintf (stderr, "Error on the access key communication!\n");
        return EXIT_FAILURE;
@@ -104,17 +123,16 @@ int main (int argc, char *argv[])
      { perror ("error on mapping the shared region on the process address space");
        return EXIT_FAILURE;
      }
+  if (p >= sh->fSt.dim.p)
+     { fprintf (stderr, "Porter process identification is wrong!\n");
+       return EXIT_FAILURE;
+     }
 
-  /* simulation of the life cycle of the porter */
+  /* simulation of the life cycle of the porter, one day after another if the airport is resident */
 
-  for (k = 0; k < K; k++)
-  { takeARest (k);                                                           /* the porter waits for a plane to land */
-    while (tryToCollectABag (k, &bag))          /* the porter checks if there is still any luggage to collect at the
-                                                                          plane's hold, if it is so he picks a piece */
-      carryItToAppropriateStore (k, &bag);                         /* the porter carries it to the appropriate store
-                                                                                 (luggage conveyor belt / storeroom) */
-    noMoreBagsToCollect (k);                                                /* the porter goes back to the rest room */
-  }
+  nDays = 0;
+  while (dayBegin (semgid, sh, &nDays))
+    lifeCycle (p);
 
   /* unmapping the shared region off the process address space */
 
@@ -126,106 +144,203 @@ int main (int argc, char *argv[])
   return EXIT_SUCCESS;
 }
 
+#else
+
+/**
+ *  \brief Porters set up.
+ *
+ *  Connection to the semaphore set and the shared memory region of the engine based on threads. It must be called
+ *  once before the porter threads are launched.
+ *
+ *  \param fName logging file name
+ *  \param key access key to shared memory and semaphore set
+ */
+
+void porterSetup (char *fName, int key)
+{
+  strcpy (nFic, fName);
+  if ((semgid = semConnect (key)) == -1)
+     { perror ("error on connecting to the semaphore set (PO)");
+       exit (EXIT_FAILURE);
+     }
+  if ((shmid = shmemConnect (key)) == -1)
+     { perror ("error on connecting to the shared memory region (PO)");
+       exit (EXIT_FAILURE);
+     }
+  if (shmemAttach (shmid, (void **) &sh) == -1)
+     { perror ("error on mapping the shared region on the process address space (PO)");
+       exit (EXIT_FAILURE);
+     }
+}
+
+/**
+ *  \brief Porter thread.
+ *
+ *  Its role is to generate the life cycle of one of intervening entities in the problem: the porter.
+ *
+ *  \param arg pointer to the location where the porter identification is stored
+ *
+ *  \return \c NULL
+ */
+
+void *porterThread (void *arg)
+{
+  lifeCycle (*((unsigned int *) arg));
+  return NULL;
+}
+
+#endif /* THREAD_ENGINE */
+
+/**
+ *  \brief Life cycle of the porter.
+ *
+ *  \param id porter identification
+ */
+
+static void lifeCycle (unsigned int id)
+{
+  unsigned int k;                                                                                   /* flight number */
+  BAG bag;                                                                       /* piece of luggage to be processed */
+  bool last;                                                   /* the porter was the last one to find the hold empty */
+
+  for (k = 0; k < sh->fSt.dim.k; k++)
+  { takeARest (id);                                                          /* the porter waits for a plane to land */
+    while (tryToCollectABag (k, &bag, &last))   /* the porter checks if there is still any luggage to collect at the
+                                                                          plane's hold, if it is so he picks a piece */
+      carryItToAppropriateStore (k, &bag);                         /* the porter carries it to the appropriate store
+                                                                                 (luggage conveyor belt / storeroom) */
+    noMoreBagsToCollect (k, last);                                          /* the porter goes back to the rest room */
+  }
+}
+
 /**
  *  \brief Take a rest.
  *
  *  The porter reads the newspaper while waiting for next assignment.
  *  He waits while not all the N passengers have left the plane which has just landed. He proceeds otherwise.
  *
+ *  Every porter waits on a semaphore of his own, so that he is told once of every plane landing and never runs ahead
+ *  of the others into a plane which has not landed yet.
+ *
  *  No state should be saved.
  *
- *  \param k plane landing number
+ *  \param id porter identification
  */
 
-static void takeARest (unsigned int k)
+static void takeARest (unsigned int id)
 {
 	/* insert your code here */
 	// wait for the last passenger whatShouldIDo
-	if (semDown (semgid, sh->waitingFlight) == -1)
+	if (semDown (semgid, PORTSEM (sh, id)) == -1)
 	{
 		perror ("error on the down operation for semaphore waitingFlight (PO)");
 		exit (EXIT_FAILURE);
 	}
-
-	/* Enter Critical Region */
-	if (semDown (semgid, sh->access) == -1)
-	{
-	  perror ("error on the down operation for semaphore access (PO)");
-	  exit (EXIT_FAILURE);
-	}
-	/* insert your code here */
-	// Number of whatShouldIDo
-	sh->nPassP -= N;
-
-	/* Exit Critical Region */
-	if (semUp (semgid, sh->access) == -1)
-	{
-		perror ("error on the up operation for semaphore access (PO)");
-		exit (EXIT_FAILURE);
-	}
 }
 
 /**
  *  \brief Try to collect a bag.
  *
  *  The porter goes to the plane's hold and checks if there are bags still left to be collected. If so, he picks up one
- *  and leaves. If not, and before leaving, he informs the passengers who may be still waiting that there are no more
- *  bags left.
+ *  and leaves. If not, and he is the last porter to find the hold empty, before leaving, he informs the passengers who
+ *  may be still waiting that there are no more bags left, going over the belts one at a time. By then, every bag has
+ *  been carried to its store, so they are told exactly once.
  *
- *  State should be saved.
+ *  The bags are claimed by decrementing their number in the plane's hold atomically, without entering the landing
+ *  critical region, and the porters finding it empty count themselves out atomically as well.
+ *
+ *  State should be saved, unless he has found the hold empty and is not the last porter to do so: the porter state
+ *  is shared by all of them, and the others may still be at work.
  *
  *  \param k plane landing number
  *  \param p_bag pointer to the location where the retrieved bag should be stored
+ *  \param p_last pointer to the location where it is stored whether he was the last porter to find the hold empty
  *
  *  \return \c true, if he has picked up a bag
  *  \return \c false, otherwise
  */
 
-static bool tryToCollectABag (unsigned int k, BAG *p_bag)
+static bool tryToCollectABag (unsigned int k, BAG *p_bag, bool *p_last)
 {
 	bool ret = false;
-	/* Enter Critical Region */
-	if (semDown (semgid, sh->access) == -1)
+	unsigned int *p_n = &PLHOLD (&(sh->fSt), k).nBags;
+	unsigned int nBags = __atomic_load_n (p_n, __ATOMIC_RELAXED);
+	// Any Bag? (the other porters may be claiming one at the same time)
+	while ((nBags != 0) &&
+	       !__atomic_compare_exchange_n (p_n, &nBags, nBags - 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+	if (nBags != 0)
 	{
-		perror ("error on the down operation for semaphore access (PO)");
-		exit (EXIT_FAILURE);
-	}
-	/* insert your code here */
-	// Any Bag?
-	if (sh->fSt.plHold[k].nBags != 0)
-	{
-		*p_bag = sh->fSt.plHold[k].bag[sh->fSt.plHold[k].nBags - 1]; // save bag
-		sh->fSt.plHold[k].nBags--; // Decrease bags number
+		*p_bag = HOLDBAG (&PLHOLD (&(sh->fSt), k), nBags - 1); // save bag
 		// Return var
 		ret = true;
 	}
-	else{
-		int i = 0;
-		for (i = 0; i < N; i++)
+	// Only the last porter to find the hold empty informs the passengers
+	*p_last = !ret && (__atomic_add_fetch (&PLHOLD (&(sh->fSt), k).nPortDone, 1, __ATOMIC_ACQ_REL) == sh->fSt.dim.p);
+	if (*p_last)
+	{
+		unsigned int c, i, n;
+		if ((missSem == NULL) && ((missSem = malloc (sh->fSt.dim.n * sizeof (unsigned int))) == NULL))
 		{
-			// Passenger waiting for bags
-			if ((sh->fSt.st.passStat[k][i].sit == FD) &&
-			          		((sh->fSt.st.passStat[k][i].nBagsAct + sh->nCalls[i]) < sh->fSt.st.passStat[k][i].nBagsReal))
+			perror ("error on allocating the list of semaphores to be upped (PO)");
+			exit (EXIT_FAILURE);
+		}
+		// One belt at a time
+		for (c = 0; c < sh->fSt.dim.c; c++)
+		{
+			/* Enter Belt Critical Region */
+			if (semDown (semgid, BELTSEM (sh, c)) == -1)
+			{
+				perror ("error on the down operation for semaphore beltAccess (PO)");
+				exit (EXIT_FAILURE);
+			}
+			n = 0;
+			for (i = c; i < sh->fSt.dim.n; i += sh->fSt.dim.c)
 			{
-				// Inform Passenger Missing Bags
-				if (semUp (semgid, sh->pass[i]) == -1)
+				// Passenger waiting for bags
+				if ((PASSSTAT (&(sh->fSt), k, i).sit == FD) &&
+				          		((PASSSTAT (&(sh->fSt), k, i).nBagsAct + NCALLS (sh, i)) < PASSSTAT (&(sh->fSt), k, i).nBagsReal))
 				{
-					perror ("error on the up operation for semaphore Passenger[i] (PO)");
-					exit (EXIT_FAILURE);
+					// Inform Passenger Missing Bags (all of them at once, below)
+					missSem[n++] = PASSSEM (sh, i);
+					// increase number of calls
+					NCALLS (sh, i)++;
 				}
-				// increase number of calls
-				sh->nCalls[i]++;
+			}
+			if (semUpMany (semgid, missSem, n) == -1)
+			{
+				perror ("error on the up operation for semaphore Passenger[i] (PO)");
+				exit (EXIT_FAILURE);
+			}
+			/* Exit Belt Critical Region */
+			if (semUp (semgid, BELTSEM (sh, c)) == -1)
+			{
+				perror ("error on the up operation for semaphore beltAccess (PO)");
+				exit (EXIT_FAILURE);
 			}
 		}
 	}
-	/* Change State */
+	/* The other porters leave the state to those still at work */
+	if (!ret && !*p_last)
+		return ret;
+	/* Change State (the statistics critical region is only needed if the state may be saved) */
+	if (!LOGACTIVE (&(sh->fSt)))
+	{
+		sh->fSt.st.porterStat = AT_THE_PLANES_HOLD;
+		return ret;
+	}
+	/* Enter Statistics Critical Region */
+	if (semDown (semgid, sh->statsAccess) == -1)
+	{
+		perror ("error on the down operation for semaphore statsAccess (PO)");
+		exit (EXIT_FAILURE);
+	}
 	sh->fSt.st.porterStat = AT_THE_PLANES_HOLD;
-	saveState (nFic,k,&(sh->fSt));
+	logRingPut (semgid, sh, k, LOGPORTER);
 
-	/* Exit Critical Region */
-	if (semUp (semgid, sh->access) == -1)
+	/* Exit Statistics Critical Region */
+	if (semUp (semgid, sh->statsAccess) == -1)
 	{
-		perror ("error on the up operation for semaphore access (PO)");
+		perror ("error on the up operation for semaphore statsAccess (PO)");
 		exit (EXIT_FAILURE);
 	}
 	return ret;
@@ -236,8 +351,8 @@ static bool tryToCollectABag (unsigned int k, BAG *p_bag)
  *
  *  The porter checks the bag identification. If it is unknown, he issues an error message.
  *  He then checks the passenger flight situation. If she has this airport as her final destination, he deposits the
- *  bag on the belt conveyor and informs the passenger. Otherwise, he takes the bag to the storeroom for temporary
- *  storage. He also updates statistical data in both cases.
+ *  bag on the belt conveyor she collects from and informs her. Otherwise, he takes the bag to the storeroom for
+ *  temporary storage. He also updates statistical data in both cases.
  *
  *  State should be saved.
  *
@@ -247,44 +362,71 @@ static bool tryToCollectABag (unsigned int k, BAG *p_bag)
 
 static void carryItToAppropriateStore (unsigned int k, BAG *p_bag)
 {
-	if (semDown (semgid, sh->access) == -1)                                                   /* enter critical region */
-	{
-		perror ("error on the down operation for semaphore access (PO)");
-		exit (EXIT_FAILURE);
-	}
 	// The porter checks the bag identification. If it is unknown, he issues an error message.
-	if (p_bag->id > N)
+	if (p_bag->id >= sh->fSt.dim.n)
 	{
 		// Error Message
 		perror ("ID Unknown");
 		exit (EXIT_FAILURE);
 	}
-	if (sh->fSt.st.passStat[k][p_bag->id].sit == FD)
+	if (PASSSTAT (&(sh->fSt), k, p_bag->id).sit == FD)
 	{
-		// Update Statistical Data
-		sh->fSt.nToTBagsPCB++;
+		// The bag goes to the belt its owner collects from
+		unsigned int c = BELTOF (&(sh->fSt), p_bag->id);
+		if (semDown (semgid, BELTSEM (sh, c)) == -1)                                         /* enter belt critical region */
+		{
+			perror ("error on the down operation for semaphore beltAccess (PO)");
+			exit (EXIT_FAILURE);
+		}
 		// Inform Passenger
-		sh->nCalls[p_bag->id]++;
+		NCALLS (sh, p_bag->id)++;
 		// Update CAM (camIn bag)
-		camIn (&sh->fSt.convBelt, p_bag->id);
+		camIn (&BELT (&(sh->fSt), c), p_bag->id);
+		if (semDown (semgid, sh->statsAccess) == -1)                                   /* enter statistics critical region */
+		{
+			perror ("error on the down operation for semaphore statsAccess (PO)");
+			exit (EXIT_FAILURE);
+		}
+		// Update Statistical Data
+		sh->fSt.nToTBagsPCB++;
 		// Change State
 		sh->fSt.st.porterStat = AT_THE_LUGGAGE_BELT_CONVEYOR;
-		saveState (nFic,k,&(sh->fSt));
+		logRingPut (semgid, sh, k, LOGPORTER);
+		if (semUp (semgid, sh->statsAccess) == -1)                                      /* exit statistics critical region */
+		{
+			perror ("error on the up operation for semaphore statsAccess (PO)");
+			exit (EXIT_FAILURE);
+		}
 		// Wake Up Passenger
-		if (semUp (semgid, sh->pass[p_bag->id]) == -1)
+		if (semUp (semgid, PASSSEM (sh, p_bag->id)) == -1)
 		{
 			perror ("error on the up operation for semaphore Passenger[i] (PO)");
 			exit (EXIT_FAILURE);
 		}
+		if (semUp (semgid, BELTSEM (sh, c)) == -1)                                            /* exit belt critical region */
+		{
+			perror ("error on the up operation for semaphore beltAccess (PO)");
+			exit (EXIT_FAILURE);
+		}
 	}
 	// if passenger is in transit
-	else if (sh->fSt.st.passStat[k][p_bag->id].sit == TRT)
+	else if (PASSSTAT (&(sh->fSt), k, p_bag->id).sit == TRT)
 	{
+		if (semDown (semgid, sh->statsAccess) == -1)                                   /* enter statistics critical region */
+		{
+			perror ("error on the down operation for semaphore statsAccess (PO)");
+			exit (EXIT_FAILURE);
+		}
 		// Update Statistical Data
 		sh->fSt.nToTBagsPSR++;
 		// Change State
 		sh->fSt.st.porterStat = AT_THE_STOREROOM;
-		saveState (nFic,k,&(sh->fSt));
+		logRingPut (semgid, sh, k, LOGPORTER);
+		if (semUp (semgid, sh->statsAccess) == -1)                                      /* exit statistics critical region */
+		{
+			perror ("error on the up operation for semaphore statsAccess (PO)");
+			exit (EXIT_FAILURE);
+		}
 	}
 	// error case
 	else
@@ -292,12 +434,6 @@ static void carryItToAppropriateStore (unsigned int k, BAG *p_bag)
 		printf ("Error Situation");
 		// exit (EXIT_FAILURE);
 	}
-	/* Exit Critical Region */
-	if (semUp (semgid, sh->access) == -1)
-	{
-		perror ("error on the up operation for semaphore access (PO)");
-		exit (EXIT_FAILURE);
-	}
 }
 
 /**
@@ -305,26 +441,29 @@ static void carryItToAppropriateStore (unsigned int k, BAG *p_bag)
  *
  *  The porter goes back to his office.
  *
- *  State should be saved.
+ *  State should be saved, and the summary of the flight with it, by the last porter to find the hold empty only.
  *
  *  \param k plane landing number
+ *  \param last the porter was the last one to find the hold empty
  */
 
-static void noMoreBagsToCollect (unsigned int k)
+static void noMoreBagsToCollect (unsigned int k, bool last)
 {
-	if (semDown (semgid, sh->access) == -1)                                                   /* enter critical region */
+	if (!last)
+		return;
+	if (semDown (semgid, sh->statsAccess) == -1)                                   /* enter statistics critical region */
 	{
-		perror ("error on the down operation for semaphore access (PO)");
+		perror ("error on the down operation for semaphore statsAccess (PO)");
 		exit (EXIT_FAILURE);
 	}
 
 	// Change State
 	sh->fSt.st.porterStat = WAITING_FOR_A_PLANE_TO_LAND;
-	saveState (nFic,k,&(sh->fSt));
+	logRingPut (semgid, sh, k, LOGSUMMARY);
 
-	if (semUp (semgid, sh->access) == -1)                                                      /* exit critical region */
+	if (semUp (semgid, sh->statsAccess) == -1)                                      /* exit statistics critical region */
 	{
-		perror ("error on the up operation for semaphore access (PO)");
+		perror ("error on the up operation for semaphore statsAccess (PO)");
 		exit (EXIT_FAILURE);
 	}
 }
@@ -9,12 +9,21 @@
  *     \li destruction of a previously created set of semaphores
  *     \li signaling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>down</em> of a semaphore within the set, with a time limit
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li <em>up</em> of a semaphore within the set several times at once
+ *     \li <em>up</em> of several semaphores within the set at once.
  *
  *  \author António Rui Borges - October 1995
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/sem.h>
@@ -22,14 +31,36 @@
 /** \brief access permission: user r-w */
 #define  MASK           0600
 
+/** \brief largest value a semaphore may take (SEMVMX), and so the largest increment of a single up operation */
+#define  UPMAX          32767
+
+/** \brief largest number of operations submitted in one semop call (it is lowered to the system limit, if need be) */
+#define  BATCH          256
+
+/**
+ *  \brief Definition of the argument of semctl (it is left to the caller to define it).
+ */
+union semun
+      { /** \brief value for SETVAL */
+        int val;
+        /** \brief buffer for IPC_STAT and IPC_SET */
+        struct semid_ds *buf;
+        /** \brief array for GETALL and SETALL */
+        unsigned short *array;
+        /** \brief buffer for IPC_INFO */
+        struct seminfo *__buf;
+      };
+
 /**
  *  \brief Creation of a set of semaphores.
  *
  *  All semaphores in the set will be in set to <em>red state</em> upon creation.
- *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>.
+ *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>, and also, with
+ *  <tt>errno</tt> set to <tt>ERANGE</tt>, if the set would hold more semaphores than the system allows in a single
+ *  set (<tt>SEMMSL</tt>, the first field of <tt>/proc/sys/kernel/sem</tt>).
  *
  *  \param key creation key
- *  \param snum number of semaphores in the set (>= 1)
+ *  \param snum number of semaphores in the set (1 .. SEMMSL - 1)
  *
  *  \return set identifier, upon success
  *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
@@ -37,6 +68,14 @@
 
 int semCreate (int key, unsigned int snum)
 {
+  struct seminfo info;                                                                              /* system limits */
+  union semun arg;                                                                             /* argument of semctl */
+
+  arg.__buf = &info;
+  if ((semctl (0, 0, IPC_INFO, arg) != -1) && (info.semmsl > 0) && (snum >= (unsigned int) info.semmsl))
+     { errno = ERANGE;
+       return -1;
+     }
   return semget ((key_t) key, snum+1, MASK | IPC_CREAT | IPC_EXCL);
 }
 
@@ -117,6 +156,32 @@ int semDown (int semgid, unsigned int sindex)
   return semop (semgid, &down, 1);
 }
 
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, with a time limit.
+ *
+ *  The calling process is blocked at most <tt>us</tt> microseconds waiting for the semaphore to be in green state.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or the time limit
+ *  expires, in which case <tt>errno</tt> is set to <tt>EAGAIN</tt> and the semaphore is not changed.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param us time limit (in microseconds)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDownTimed (int semgid, unsigned int sindex, unsigned int us)
+{
+  struct sembuf down = { 0, -1, 0 };                                                      /* specific down operation */
+  struct timespec lim;                                                                                /* time limit */
+
+  down.sem_num = (unsigned short) sindex;
+  lim.tv_sec = us / 1000000;
+  lim.tv_nsec = (long) (us % 1000000) * 1000L;
+  return semtimedop (semgid, &down, 1, &lim);
+}
+
 /**
  *  \brief <em>Up</em> of a semaphore within the set.
  *
@@ -136,3 +201,93 @@ int semUp (int semgid, unsigned int sindex)
   up.sem_num = (unsigned short) sindex;
   return semop (semgid, &up, 1);
 }
+
+/**
+ *  \brief <em>Up</em> of a semaphore within the set several times at once.
+ *
+ *  Up to <tt>n</tt> processes blocked on the semaphore are released together, as if it had been <em>upped</em>
+ *  <tt>n</tt> times in a row.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>. An increment larger
+ *  than the largest value a semaphore may take (<tt>SEMVMX</tt>) is submitted in several <tt>semop</tt> calls. A
+ *  step that would take the value beyond <tt>SEMVMX</tt>, because the processes released by the previous ones have not
+ *  carried out their <em>down</em> yet, is retried, the processor being yielded in between, until they have. So, such
+ *  an increment must not exceed <tt>SEMVMX</tt> plus the number of <em>downs</em> which are bound to take place.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of times (>= 1; beyond SEMVMX, in steps of at most SEMVMX)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpBy (int semgid, unsigned int sindex, unsigned int n)
+{
+  struct sembuf up = { 0, 1, 0 };                                                           /* specific up operation */
+  unsigned int s;                                                                                       /* step size */
+  bool split = (n > UPMAX);                                                  /* the increment is carried out in steps */
+
+  up.sem_num = (unsigned short) sindex;
+  do
+  { s = (n < UPMAX) ? n : UPMAX;
+    up.sem_op = (short) s;
+    if (semop (semgid, &up, 1) == -1)
+       { if (!split || (errno != ERANGE)) return -1;
+         sched_yield ();                                           /* the value has not drained yet: try it again */
+         continue;
+       }
+    n -= s;
+  } while (n > 0);
+  return 0;
+}
+
+/**
+ *  \brief <em>Up</em> of several semaphores within the set at once.
+ *
+ *  Every semaphore in the list is <em>upped</em> once (a semaphore listed twice is <em>upped</em> twice).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or some semaphore
+ *  location is out of range; nothing is changed if it fails on that account. A list too long for a single
+ *  <tt>semop</tt> call is submitted in several ones, after all its locations have been checked.
+ *
+ *  \param semgid set identifier
+ *  \param sindex list of semaphore locations in the set (1 .. snum)
+ *  \param n number of semaphores in the list
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpMany (int semgid, unsigned int *sindex, unsigned int n)
+{
+  static unsigned int max = 0;                                 /* largest number of operations submitted in one call */
+  struct sembuf up[BATCH];                                                                 /* batch of up operations */
+  struct seminfo info;                                                                              /* system limits */
+  struct semid_ds ds;                                                                 /* status of the semaphore set */
+  union semun arg;                                                                             /* argument of semctl */
+  unsigned int i, j, b;                                                         /* counting variables and batch size */
+
+  if (max == 0)
+     { arg.__buf = &info;
+       max = ((semctl (0, 0, IPC_INFO, arg) != -1) && (info.semopm > 0) && (info.semopm < BATCH))
+             ? (unsigned int) info.semopm : BATCH;
+     }
+  if (n > max)                                  /* several calls: all the locations are checked before the first one */
+     { arg.buf = &ds;
+       if (semctl (semgid, 0, IPC_STAT, arg) == -1) return -1;
+       for (i = 0; i < n; i++)
+         if (sindex[i] >= ds.sem_nsems)
+            { errno = EFBIG;
+              return -1;
+            }
+     }
+  for (i = 0; i < n; i += b)                                   /* all of them in one call, unless there are too many */
+  { b = (n - i < max) ? n - i : max;
+    for (j = 0; j < b; j++)
+    { up[j].sem_num = (unsigned short) sindex[i+j];
+      up[j].sem_op = 1;
+      up[j].sem_flg = 0;
+    }
+    if (semop (semgid, up, b) == -1) return -1;
+  }
+  return 0;
+}
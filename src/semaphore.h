@@ -9,7 +9,10 @@
  *     \li destruction of a previously created set of semaphores
  *     \li signaling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>down</em> of a semaphore within the set, with a time limit
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li <em>up</em> of a semaphore within the set several times at once
+ *     \li <em>up</em> of several semaphores within the set at once.
  *
  *  \author António Rui Borges - October 1995
  */
@@ -21,7 +24,9 @@
  *  \brief Creation of a set of semaphores.
  *
  *  All semaphores in the set will be in set to <em>red state</em> upon creation.
- *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>.
+ *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>, and also, with
+ *  <tt>errno</tt> set to <tt>ERANGE</tt>, if the implementation limits the size of a set and <tt>snum</tt> goes beyond
+ *  it (the one based on System V semaphores takes at most <tt>SEMMSL</tt> - 1).
  *
  *  \param key creation key
  *  \param snum number of semaphores in the set (>= 1)
@@ -85,6 +90,23 @@ extern int semSignal (int semgid);
 
 extern int semDown (int semgid, unsigned int sindex);
 
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, with a time limit.
+ *
+ *  The calling process is blocked at most <tt>us</tt> microseconds waiting for the semaphore to be in green state.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or the time limit
+ *  expires, in which case <tt>errno</tt> is set to <tt>EAGAIN</tt> and the semaphore is not changed.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param us time limit (in microseconds)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semDownTimed (int semgid, unsigned int sindex, unsigned int us);
+
 /**
  *  \brief <em>Up</em> of a semaphore within the set.
  *
@@ -99,4 +121,40 @@ extern int semDown (int semgid, unsigned int sindex);
 
 extern int semUp (int semgid, unsigned int sindex);
 
+/**
+ *  \brief <em>Up</em> of a semaphore within the set several times at once.
+ *
+ *  Up to <tt>n</tt> processes blocked on the semaphore are released together, as if it had been <em>upped</em>
+ *  <tt>n</tt> times in a row.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>. With System V
+ *  semaphores, an increment larger than <tt>SEMVMX</tt> (32767) is carried out in several steps, so it is not atomic
+ *  as a whole.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of times (>= 1; beyond SEMVMX, in steps of at most SEMVMX)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semUpBy (int semgid, unsigned int sindex, unsigned int n);
+
+/**
+ *  \brief <em>Up</em> of several semaphores within the set at once.
+ *
+ *  Every semaphore in the list is <em>upped</em> once (a semaphore listed twice is <em>upped</em> twice).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or some semaphore
+ *  location is out of range; nothing is changed if it fails on that account.
+ *
+ *  \param semgid set identifier
+ *  \param sindex list of semaphore locations in the set (1 .. snum)
+ *  \param n number of semaphores in the list
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int semUpMany (int semgid, unsigned int *sindex, unsigned int n);
+
 #endif /* SEMAPHORE_H_ */
@@ -0,0 +1,499 @@
+/**
+ *  \file semaphoreFutex.c (implementation file)
+ *
+ *  \brief Semaphore management.
+ *
+ *  Operations defined on semaphores:
+ *     \li creation of a set of semaphores
+ *     \li connection to a previously created set of semaphores
+ *     \li destruction of a previously created set of semaphores
+ *     \li signaling start of operations
+ *     \li <em>down</em> of a semaphore within the set
+ *     \li <em>down</em> of a semaphore within the set, with a time limit
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li <em>up</em> of a semaphore within the set several times at once
+ *     \li <em>up</em> of several semaphores within the set at once.
+ *
+ *  Implementation with futexes: the counters of the set are kept in a POSIX shared memory object named after the
+ *  creation key. A <em>down</em> on a semaphore in green state and an <em>up</em> with nobody waiting are atomic
+ *  operations carried out in user space; the kernel is only called upon to put a process to sleep or to wake it up.
+ *  An <em>up</em> of several semaphores wakes the sleepers two at a time, with <tt>FUTEX_WAKE_OP</tt>.
+ *
+ *  Like <tt>semop</tt>, a <em>down</em> that is interrupted by a signal fails with <tt>errno</tt> set to
+ *  <tt>EINTR</tt>.
+ *
+ *  \author António Rui Borges - October 1995
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/** \brief access permission: user r-w */
+#define  MASK           0600
+
+/** \brief maximum number of semaphore sets a process may be connected to */
+#define  NSETS          16
+
+/** \brief size of a cache line */
+#define  CLINE          64
+
+/**
+ *  \brief Definition of <em>semaphore</em> data type.
+ *
+ *  Every semaphore takes a whole cache line, so that operations on different semaphores do not interfere.
+ */
+typedef struct
+        { /** \brief counter (it is also the futex word) */
+          unsigned int val;
+          /** \brief number of processes which are sleeping, or about to sleep, on the counter */
+          unsigned int nWait;
+          /** \brief padding up to the cache line size */
+          char pad[CLINE - 2 * sizeof (unsigned int)];
+        } SEMAPHORE;
+
+/**
+ *  \brief Definition of <em>shared set of semaphores</em> data type.
+ */
+typedef struct
+        { /** \brief number of semaphores in the set (including the start of operations one) */
+          unsigned int snum;
+          /** \brief padding up to the cache line size */
+          char pad[CLINE - sizeof (unsigned int)];
+          /** \brief semaphores */
+          SEMAPHORE sem[];
+        } SEMSET;
+
+/**
+ *  \brief Definition of <em>connection to a set of semaphores</em> data type.
+ */
+typedef struct
+        { /** \brief creation key */
+          int key;
+          /** \brief mapping size (in bytes) */
+          size_t size;
+          /** \brief local address of the set */
+          SEMSET *set;
+        } CONNECTION;
+
+/** \brief table of connections (the set identifier is the table index) */
+static CONNECTION conn[NSETS];
+
+/**
+ *  \brief Name of the shared memory object holding a set of semaphores.
+ *
+ *  \param key creation key
+ *  \param name pointer to the location where the name is to be stored (at least 32 characters)
+ */
+
+static void semName (int key, char *name)
+{
+  sprintf (name, "/airport.sem.%08x", (unsigned int) key);
+}
+
+/**
+ *  \brief Storing of a new connection in the table of connections.
+ *
+ *  \param key creation key
+ *  \param set local address of the set
+ *  \param size mapping size (in bytes)
+ *
+ *  \return set identifier, upon success
+ *  \return -\c 1, when the table is full (<tt>errno</tt> is set to <tt>ENOSPC</tt>)
+ */
+
+static int connIn (int key, SEMSET *set, size_t size)
+{
+  int semgid;                                                                            /* semaphore set identifier */
+
+  for (semgid = 0; semgid < NSETS; semgid++)
+    if (conn[semgid].set == NULL)
+       { conn[semgid].key = key;
+         conn[semgid].size = size;
+         conn[semgid].set = set;
+         return semgid;
+       }
+  errno = ENOSPC;
+  return -1;
+}
+
+/**
+ *  \brief Location of a semaphore.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return pointer to the semaphore, upon success
+ *  \return \c NULL, when there is no such semaphore (<tt>errno</tt> is set to <tt>EINVAL</tt>)
+ */
+
+static SEMAPHORE *semLocate (int semgid, unsigned int sindex)
+{
+  if ((semgid < 0) || (semgid >= NSETS) || (conn[semgid].set == NULL) || (sindex >= conn[semgid].set->snum))
+     { errno = EINVAL;
+       return NULL;
+     }
+  return &(conn[semgid].set->sem[sindex]);
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore.
+ *
+ *  \param p_s pointer to the semaphore
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int down (SEMAPHORE *p_s)
+{
+  unsigned int val;                                                                                 /* counter value */
+  long stat;                                                                                  /* status of operation */
+  int err;                                                                                           /* error number */
+
+  for (;;)
+  { val = __atomic_load_n (&(p_s->val), __ATOMIC_ACQUIRE);
+    while (val > 0)                                                                                     /* fast path */
+      if (__atomic_compare_exchange_n (&(p_s->val), &val, val - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+         return 0;
+    __atomic_add_fetch (&(p_s->nWait), 1, __ATOMIC_SEQ_CST);
+    stat = syscall (SYS_futex, &(p_s->val), FUTEX_WAIT, 0, NULL, NULL, 0);        /* sleep while the counter is zero */
+    err = errno;
+    __atomic_sub_fetch (&(p_s->nWait), 1, __ATOMIC_SEQ_CST);
+    if ((stat == -1) && (err != EAGAIN))
+       { errno = err;
+         return -1;
+       }
+  }
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore, with a time limit.
+ *
+ *  The sleep is bounded by an absolute time on the monotonic clock, so that wake ups which find the semaphore taken
+ *  by someone else do not extend the limit.
+ *
+ *  \param p_s pointer to the semaphore
+ *  \param us time limit (in microseconds)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs or the time limit expires (<tt>errno</tt> is set to <tt>EAGAIN</tt>)
+ */
+
+static int downTimed (SEMAPHORE *p_s, unsigned int us)
+{
+  struct timespec t;                                                                          /* absolute time limit */
+  unsigned int val;                                                                                 /* counter value */
+  long stat;                                                                                  /* status of operation */
+  int err;                                                                                           /* error number */
+
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  t.tv_sec += us / 1000000;
+  t.tv_nsec += (long) (us % 1000000) * 1000L;
+  if (t.tv_nsec >= 1000000000L)
+     { t.tv_sec += 1;
+       t.tv_nsec -= 1000000000L;
+     }
+  for (;;)
+  { val = __atomic_load_n (&(p_s->val), __ATOMIC_ACQUIRE);
+    while (val > 0)                                                                                     /* fast path */
+      if (__atomic_compare_exchange_n (&(p_s->val), &val, val - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+         return 0;
+    __atomic_add_fetch (&(p_s->nWait), 1, __ATOMIC_SEQ_CST);
+    stat = syscall (SYS_futex, &(p_s->val), FUTEX_WAIT_BITSET, 0, &t, NULL,      /* sleep while the counter is zero */
+                    FUTEX_BITSET_MATCH_ANY);                                         /* or up to the absolute time */
+    err = errno;
+    __atomic_sub_fetch (&(p_s->nWait), 1, __ATOMIC_SEQ_CST);
+    if ((stat == -1) && (err == ETIMEDOUT))
+       { errno = EAGAIN;
+         return -1;
+       }
+    if ((stat == -1) && (err != EAGAIN))
+       { errno = err;
+         return -1;
+       }
+  }
+}
+
+/**
+ *  \brief <em>Up</em> of a semaphore.
+ *
+ *  \param p_s pointer to the semaphore
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int up (SEMAPHORE *p_s)
+{
+  __atomic_add_fetch (&(p_s->val), 1, __ATOMIC_SEQ_CST);
+  if ((__atomic_load_n (&(p_s->nWait), __ATOMIC_SEQ_CST) > 0) &&                                        /* slow path */
+      (syscall (SYS_futex, &(p_s->val), FUTEX_WAKE, 1, NULL, NULL, 0) == -1))
+     return -1;
+  return 0;
+}
+
+/**
+ *  \brief Creation of a set of semaphores.
+ *
+ *  All semaphores in the set will be in set to <em>red state</em> upon creation.
+ *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *  \param snum number of semaphores in the set (>= 1)
+ *
+ *  \return set identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semCreate (int key, unsigned int snum)
+{
+  char name[32];                                                                 /* name of the shared memory object */
+  int fd;                                                                                         /* file descriptor */
+  size_t size;                                                                                /* set size (in bytes) */
+  SEMSET *set;                                                                           /* local address of the set */
+  int semgid;                                                                            /* semaphore set identifier */
+
+  semName (key, name);
+  size = sizeof (SEMSET) + (snum + 1) * sizeof (SEMAPHORE);
+  if ((fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, MASK)) == -1)
+     return -1;
+  if (ftruncate (fd, size) == -1)                                                    /* all counters are set to zero */
+     { close (fd);
+       shm_unlink (name);
+       return -1;
+     }
+  set = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (set == MAP_FAILED)
+     { shm_unlink (name);
+       return -1;
+     }
+  set->snum = snum + 1;
+  if ((semgid = connIn (key, set, size)) == -1)
+     { munmap (set, size);
+       shm_unlink (name);
+     }
+  return semgid;
+}
+
+/**
+ *  \brief Connection to a previously created set of semaphores.
+ *
+ *  The function fails if there is no semaphore set with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *
+ *  \return set identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semConnect (int key)
+{
+  char name[32];                                                                 /* name of the shared memory object */
+  int fd;                                                                                         /* file descriptor */
+  struct stat st;                                                                               /* object attributes */
+  SEMSET *set;                                                                           /* local address of the set */
+  int semgid;                                                                            /* semaphore set identifier */
+
+  semName (key, name);
+  if ((fd = shm_open (name, O_RDWR, MASK)) == -1)
+     return -1;
+  if (fstat (fd, &st) == -1)
+     { close (fd);
+       return -1;
+     }
+  set = mmap (NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (set == MAP_FAILED)
+     return -1;
+  if ((semgid = connIn (key, set, st.st_size)) == -1)
+     { munmap (set, st.st_size);
+       return -1;
+     }
+  if ((down (&(set->sem[0])) == -1) || (up (&(set->sem[0])) == -1))              /* wait for the start of operations */
+     return -1;
+  return semgid;
+}
+
+/**
+ *  \brief Destruction of a previously created set of semaphores.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDestroy (int semgid)
+{
+  char name[32];                                                                 /* name of the shared memory object */
+
+  if (semLocate (semgid, 0) == NULL) return -1;
+  semName (conn[semgid].key, name);
+  munmap (conn[semgid].set, conn[semgid].size);
+  conn[semgid].set = NULL;
+  return shm_unlink (name);
+}
+
+/**
+ *  \brief Signaling start of operations upon initialization of shared data structures.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semSignal (int semgid)
+{
+  SEMAPHORE *p_s;                                                                             /* start of operations */
+
+  if ((p_s = semLocate (semgid, 0)) == NULL) return -1;
+  return up (p_s);
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore within the set.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDown (int semgid, unsigned int sindex)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  return down (p_s);
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, with a time limit.
+ *
+ *  The calling process is blocked at most <tt>us</tt> microseconds waiting for the semaphore to be in green state.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or the time limit
+ *  expires, in which case <tt>errno</tt> is set to <tt>EAGAIN</tt> and the semaphore is not changed.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param us time limit (in microseconds)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDownTimed (int semgid, unsigned int sindex, unsigned int us)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  return downTimed (p_s, us);
+}
+
+/**
+ *  \brief <em>Up</em> of a semaphore within the set.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUp (int semgid, unsigned int sindex)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  return up (p_s);
+}
+
+/**
+ *  \brief <em>Up</em> of a semaphore within the set several times at once.
+ *
+ *  Up to <tt>n</tt> processes blocked on the semaphore are released together, as if it had been <em>upped</em>
+ *  <tt>n</tt> times in a row.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of times (>= 1)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpBy (int semgid, unsigned int sindex, unsigned int n)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  __atomic_add_fetch (&(p_s->val), n, __ATOMIC_SEQ_CST);
+  if ((__atomic_load_n (&(p_s->nWait), __ATOMIC_SEQ_CST) > 0) &&                                        /* slow path */
+      (syscall (SYS_futex, &(p_s->val), FUTEX_WAKE, n, NULL, NULL, 0) == -1))           /* all the sleepers at once */
+     return -1;
+  return 0;
+}
+
+/**
+ *  \brief <em>Up</em> of several semaphores within the set at once.
+ *
+ *  Every semaphore in the list is <em>upped</em> once (a semaphore listed twice is <em>upped</em> twice).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or some semaphore
+ *  location is out of range; nothing is changed if it fails on that account.
+ *
+ *  \param semgid set identifier
+ *  \param sindex list of semaphore locations in the set (1 .. snum)
+ *  \param n number of semaphores in the list
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpMany (int semgid, unsigned int *sindex, unsigned int n)
+{
+  SEMAPHORE *p_s,                                                                                       /* semaphore */
+            *p_w = NULL;                                          /* semaphore whose sleeper is still to be woken up */
+  unsigned int i;                                                                               /* counting variable */
+
+  for (i = 0; i < n; i++)                                                              /* all of them must be there */
+    if (semLocate (semgid, sindex[i]) == NULL) return -1;
+  for (i = 0; i < n; i++)
+  { p_s = semLocate (semgid, sindex[i]);
+    __atomic_add_fetch (&(p_s->val), 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n (&(p_s->nWait), __ATOMIC_SEQ_CST) == 0) continue;                       /* nobody sleeping */
+    if (p_w == NULL)
+       { p_w = p_s;
+         continue;
+       }
+    if (syscall (SYS_futex, &(p_w->val), FUTEX_WAKE_OP, 1, (void *) 1UL, &(p_s->val),  /* wake both sleepers at once */
+                 FUTEX_OP (FUTEX_OP_ADD, 0, FUTEX_OP_CMP_GE, 0)) == -1)
+       return -1;
+    p_w = NULL;
+  }
+  if ((p_w != NULL) && (syscall (SYS_futex, &(p_w->val), FUTEX_WAKE, 1, NULL, NULL, 0) == -1))
+     return -1;
+  return 0;
+}
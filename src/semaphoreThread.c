@@ -0,0 +1,392 @@
+/**
+ *  \file semaphoreThread.c (implementation file)
+ *
+ *  \brief Semaphore management.
+ *
+ *  Operations defined on semaphores:
+ *     \li creation of a set of semaphores
+ *     \li connection to a previously created set of semaphores
+ *     \li destruction of a previously created set of semaphores
+ *     \li signaling start of operations
+ *     \li <em>down</em> of a semaphore within the set
+ *     \li <em>down</em> of a semaphore within the set, with a time limit
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li <em>up</em> of a semaphore within the set several times at once
+ *     \li <em>up</em> of several semaphores within the set at once.
+ *
+ *  Implementation with POSIX threads: the sets are kept in the process private memory and every semaphore is a
+ *  counter protected by a mutex, with a condition variable where the threads block on <em>down</em>. It is meant for
+ *  entities which run as threads of a single process.
+ *
+ *  \author António Rui Borges - October 1995
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+/** \brief maximum number of semaphore sets */
+#define  NSETS          16
+
+/**
+ *  \brief Definition of <em>semaphore</em> data type.
+ */
+typedef struct
+        { /** \brief access to the counter */
+          pthread_mutex_t access;
+          /** \brief threads waiting for the counter to become positive */
+          pthread_cond_t wait;
+          /** \brief counter */
+          unsigned int val;
+        } SEMAPHORE;
+
+/**
+ *  \brief Definition of <em>set of semaphores</em> data type.
+ */
+typedef struct
+        { /** \brief creation key */
+          int key;
+          /** \brief number of semaphores in the set (including the start of operations one) */
+          unsigned int snum;
+          /** \brief semaphores */
+          SEMAPHORE *sem;
+        } SEMSET;
+
+/** \brief table of semaphore sets (the set identifier is the table index) */
+static SEMSET set[NSETS];
+
+/** \brief access to the table of semaphore sets */
+static pthread_mutex_t tabAccess = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ *  \brief Location of a semaphore.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (0 .. snum)
+ *
+ *  \return pointer to the semaphore, upon success
+ *  \return \c NULL, when there is no such semaphore (<tt>errno</tt> is set to <tt>EINVAL</tt>)
+ */
+
+static SEMAPHORE *semLocate (int semgid, unsigned int sindex)
+{
+  if ((semgid < 0) || (semgid >= NSETS) || (set[semgid].sem == NULL) || (sindex >= set[semgid].snum))
+     { errno = EINVAL;
+       return NULL;
+     }
+  return &(set[semgid].sem[sindex]);
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore.
+ *
+ *  \param p_s pointer to the semaphore
+ */
+
+static void down (SEMAPHORE *p_s)
+{
+  pthread_mutex_lock (&(p_s->access));
+  while (p_s->val == 0)
+    pthread_cond_wait (&(p_s->wait), &(p_s->access));
+  p_s->val -= 1;
+  pthread_mutex_unlock (&(p_s->access));
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore, with a time limit.
+ *
+ *  \param p_s pointer to the semaphore
+ *  \param us time limit (in microseconds)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the time limit expires (<tt>errno</tt> is set to <tt>EAGAIN</tt>)
+ */
+
+static int downTimed (SEMAPHORE *p_s, unsigned int us)
+{
+  struct timespec t;                                                                          /* absolute time limit */
+  int stat = 0;                                                                               /* status of operation */
+
+  clock_gettime (CLOCK_REALTIME, &t);
+  t.tv_sec += us / 1000000;
+  t.tv_nsec += (long) (us % 1000000) * 1000L;
+  if (t.tv_nsec >= 1000000000L)
+     { t.tv_sec += 1;
+       t.tv_nsec -= 1000000000L;
+     }
+  pthread_mutex_lock (&(p_s->access));
+  while ((p_s->val == 0) && (stat != ETIMEDOUT))
+    stat = pthread_cond_timedwait (&(p_s->wait), &(p_s->access), &t);
+  if (p_s->val == 0)
+     { pthread_mutex_unlock (&(p_s->access));
+       errno = EAGAIN;
+       return -1;
+     }
+  p_s->val -= 1;
+  pthread_mutex_unlock (&(p_s->access));
+  return 0;
+}
+
+/**
+ *  \brief <em>Up</em> of a semaphore.
+ *
+ *  \param p_s pointer to the semaphore
+ */
+
+static void up (SEMAPHORE *p_s)
+{
+  pthread_mutex_lock (&(p_s->access));
+  p_s->val += 1;
+  pthread_cond_signal (&(p_s->wait));
+  pthread_mutex_unlock (&(p_s->access));
+}
+
+/**
+ *  \brief Creation of a set of semaphores.
+ *
+ *  All semaphores in the set will be in set to <em>red state</em> upon creation.
+ *  The function fails if there is already a semaphore set with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *  \param snum number of semaphores in the set (>= 1)
+ *
+ *  \return set identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semCreate (int key, unsigned int snum)
+{
+  int semgid = -1;                                                                       /* semaphore set identifier */
+  unsigned int i;                                                                               /* counting variable */
+  int n;                                                                                        /* counting variable */
+
+  pthread_mutex_lock (&tabAccess);
+  for (n = 0; n < NSETS; n++)
+    if (set[n].sem != NULL)
+       { if (set[n].key == key)
+            { pthread_mutex_unlock (&tabAccess);
+              errno = EEXIST;
+              return -1;
+            }
+       }
+       else if (semgid == -1)
+               semgid = n;
+  if (semgid == -1)
+     { pthread_mutex_unlock (&tabAccess);
+       errno = ENOSPC;
+       return -1;
+     }
+  if ((set[semgid].sem = malloc ((snum + 1) * sizeof (SEMAPHORE))) == NULL)
+     { pthread_mutex_unlock (&tabAccess);
+       errno = ENOMEM;
+       return -1;
+     }
+  set[semgid].key = key;
+  set[semgid].snum = snum + 1;
+  for (i = 0; i < snum + 1; i++)
+  { pthread_mutex_init (&(set[semgid].sem[i].access), NULL);
+    pthread_cond_init (&(set[semgid].sem[i].wait), NULL);
+    set[semgid].sem[i].val = 0;
+  }
+  pthread_mutex_unlock (&tabAccess);
+  return semgid;
+}
+
+/**
+ *  \brief Connection to a previously created set of semaphores.
+ *
+ *  The function fails if there is no semaphore set with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *
+ *  \return set identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semConnect (int key)
+{
+  int semgid;                                                                            /* semaphore set identifier */
+
+  pthread_mutex_lock (&tabAccess);
+  for (semgid = 0; semgid < NSETS; semgid++)
+    if ((set[semgid].sem != NULL) && (set[semgid].key == key)) break;
+  pthread_mutex_unlock (&tabAccess);
+  if (semgid == NSETS)
+     { errno = ENOENT;
+       return -1;
+     }
+  down (&(set[semgid].sem[0]));                                                  /* wait for the start of operations */
+  up (&(set[semgid].sem[0]));
+  return semgid;
+}
+
+/**
+ *  \brief Destruction of a previously created set of semaphores.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDestroy (int semgid)
+{
+  unsigned int i;                                                                               /* counting variable */
+
+  pthread_mutex_lock (&tabAccess);
+  if (semLocate (semgid, 0) == NULL)
+     { pthread_mutex_unlock (&tabAccess);
+       return -1;
+     }
+  for (i = 0; i < set[semgid].snum; i++)
+  { pthread_mutex_destroy (&(set[semgid].sem[i].access));
+    pthread_cond_destroy (&(set[semgid].sem[i].wait));
+  }
+  free (set[semgid].sem);
+  set[semgid].sem = NULL;
+  pthread_mutex_unlock (&tabAccess);
+  return 0;
+}
+
+/**
+ *  \brief Signaling start of operations upon initialization of shared data structures.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semSignal (int semgid)
+{
+  SEMAPHORE *p_s;                                                                             /* start of operations */
+
+  if ((p_s = semLocate (semgid, 0)) == NULL) return -1;
+  up (p_s);
+  return 0;
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore within the set.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDown (int semgid, unsigned int sindex)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  down (p_s);
+  return 0;
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, with a time limit.
+ *
+ *  The calling process is blocked at most <tt>us</tt> microseconds waiting for the semaphore to be in green state.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or the time limit
+ *  expires, in which case <tt>errno</tt> is set to <tt>EAGAIN</tt> and the semaphore is not changed.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param us time limit (in microseconds)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semDownTimed (int semgid, unsigned int sindex, unsigned int us)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  return downTimed (p_s, us);
+}
+
+/**
+ *  \brief <em>Up</em> of a semaphore within the set.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUp (int semgid, unsigned int sindex)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  up (p_s);
+  return 0;
+}
+
+/**
+ *  \brief <em>Up</em> of a semaphore within the set several times at once.
+ *
+ *  Up to <tt>n</tt> processes blocked on the semaphore are released together, as if it had been <em>upped</em>
+ *  <tt>n</tt> times in a row.
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param n number of times (>= 1)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpBy (int semgid, unsigned int sindex, unsigned int n)
+{
+  SEMAPHORE *p_s;                                                                                       /* semaphore */
+
+  if ((p_s = semLocate (semgid, sindex)) == NULL) return -1;
+  pthread_mutex_lock (&(p_s->access));
+  p_s->val += n;
+  pthread_cond_broadcast (&(p_s->wait));
+  pthread_mutex_unlock (&(p_s->access));
+  return 0;
+}
+
+/**
+ *  \brief <em>Up</em> of several semaphores within the set at once.
+ *
+ *  Every semaphore in the list is <em>upped</em> once (a semaphore listed twice is <em>upped</em> twice).
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt> or some semaphore
+ *  location is out of range; nothing is changed if it fails on that account.
+ *
+ *  \param semgid set identifier
+ *  \param sindex list of semaphore locations in the set (1 .. snum)
+ *  \param n number of semaphores in the list
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int semUpMany (int semgid, unsigned int *sindex, unsigned int n)
+{
+  unsigned int i;                                                                               /* counting variable */
+
+  for (i = 0; i < n; i++)                                                              /* all of them must be there */
+    if (semLocate (semgid, sindex[i]) == NULL) return -1;
+  for (i = 0; i < n; i++)
+    up (semLocate (semgid, sindex[i]));
+  return 0;
+}
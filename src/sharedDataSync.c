@@ -0,0 +1,336 @@
+/**
+ *  \file sharedDataSync.c (implementation file)
+ *
+ *  \brief Problem name: Airport rhapsody.
+ *
+ *  \brief Concept: António Rui Borges
+ *
+ *  Synchronization based on semaphores and shared memory.
+ *  Implementation with SVIPC.
+ *
+ *  \brief Layout and initialization of the shared data.
+ *
+ *  The shared region is made of a fixed size header, the <em>SHARED_DATA</em> structure, followed by the arrays
+ *  whose size depends on the problem dimensions. The header keeps the dimensions and the location of each array, so
+ *  that the intervening entities only need to map the region to find them.
+ *
+ *  \author António Rui Borges - December 2013
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "cam.h"
+#include "queue.h"
+#include "logging.h"
+#include "departure.h"
+#include "sharedDataSync.h"
+#include "barrier.h"
+
+/** \brief alignment of the arrays in the shared region (cache line size) */
+#define  ALIGN          64
+
+/**
+ *  \brief Reservation of space for an array in the shared region.
+ *
+ *  Should the top of the region not be representable, it is set to <tt>SIZE_MAX</tt> and stays so.
+ *
+ *  \param p_top pointer to the location where the present top of the region is stored
+ *  \param n number of elements of the array
+ *  \param size element size (in bytes)
+ *
+ *  \return offset of the array to the beginning of the region
+ */
+
+static size_t place (size_t *p_top, size_t n, size_t size)
+{
+  size_t off;                                                                                 /* offset of the array */
+
+  if (*p_top > SIZE_MAX - ALIGN)                                                    /* the region is already too big */
+     return *p_top = SIZE_MAX;
+  off = (*p_top + ALIGN - 1) / ALIGN * ALIGN;
+  if (__builtin_mul_overflow (n, size, &size) || __builtin_add_overflow (off, size, p_top))
+     *p_top = SIZE_MAX;
+  return off;
+}
+
+/**
+ *  \brief Smallest power of two not less than a given value.
+ *
+ *  \param n value
+ *
+ *  \return the power of two
+ */
+
+static unsigned int pow2Ceil (unsigned int n)
+{
+  unsigned int p = 1;                                                                              /* power of two */
+
+  while (p < n)
+    p <<= 1;
+  return p;
+}
+
+/**
+ *  \brief Placement of the arrays in the shared region.
+ *
+ *  Offsets are computed relative to the beginning of the region. If <tt>sh</tt> is not a null pointer, they are
+ *  converted to offsets relative to the structures which refer to them and stored there.
+ *
+ *  \param sh pointer to the shared region
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *
+ *  \return size of the shared region (in bytes)
+ */
+
+static size_t layout (SHARED_DATA *sh, DIM *p_dim)
+{
+  size_t top = sizeof (SHARED_DATA);                                                    /* present top of the region */
+  size_t passStat, plHold, bag, belt, cnt, queue, qTime, bus, seat, park, pass, passBus,    /* offsets of the arrays */
+         beltSem, nCalls, port, drive, wPass, nPassD, nPassP, epis, log, sel, in;
+  unsigned int qSize = pow2Ceil (p_dim->n);               /* bus queue and inbound channel capacity (a power of two) */
+  unsigned int pSize = pow2Ceil (p_dim->b);                     /* parked buses queue capacity (a power of two, too) */
+  unsigned int shard = (p_dim->n + p_dim->c - 1) / p_dim->c;          /* largest number of passengers sharing a belt */
+  unsigned int k, b, c;                                                                        /* counting variables */
+
+  passStat = place (&top, (size_t) p_dim->k * p_dim->n, sizeof (STAT_PASSENGER));
+  plHold = place (&top, p_dim->k, sizeof (LOAD));
+  bag = place (&top, (size_t) p_dim->k * p_dim->m, (size_t) p_dim->n * sizeof (BAG));
+  belt = place (&top, p_dim->c, sizeof (CAM));
+  cnt = place (&top, (size_t) p_dim->c * p_dim->n, sizeof (unsigned int));
+  queue = place (&top, qSize, sizeof (unsigned int));
+  qTime = place (&top, p_dim->n, sizeof (unsigned long long));
+  bus = place (&top, p_dim->b, sizeof (TRANSF_INFO));
+  seat = place (&top, (size_t) p_dim->b * p_dim->t, sizeof (int));
+  park = place (&top, pSize, sizeof (unsigned int));
+  pass = place (&top, p_dim->n, sizeof (unsigned int));
+  passBus = place (&top, p_dim->n, sizeof (unsigned int));
+  beltSem = place (&top, p_dim->c, sizeof (unsigned int));
+  nCalls = place (&top, p_dim->n, sizeof (unsigned int));
+  port = place (&top, p_dim->p, sizeof (unsigned int));
+  drive = place (&top, p_dim->b, sizeof (unsigned int));
+  wPass = place (&top, p_dim->b, sizeof (unsigned int));
+  nPassD = place (&top, p_dim->b, sizeof (unsigned int));
+  nPassP = place (&top, p_dim->w, sizeof (unsigned int));
+  epis = place (&top, (size_t) p_dim->w + 1, sizeof (unsigned int));
+  log = place (&top, LOGSLOTS, snapSize (p_dim));
+  sel = place (&top, p_dim->n, sizeof (bool));
+  in = place (&top, qSize, sizeof (unsigned int));
+  if (sh == NULL) return top;
+
+  sh->fSt.dim = *p_dim;
+  sh->fSt.passStatOff = passStat - offsetof (SHARED_DATA, fSt);
+  sh->fSt.plHoldOff = plHold - offsetof (SHARED_DATA, fSt);
+  for (k = 0; k < p_dim->k; k++)
+    PLHOLD (&(sh->fSt), k).bagOff = bag + (size_t) k * p_dim->m * p_dim->n * sizeof (BAG)
+                                    - (plHold + k * sizeof (LOAD));
+  sh->fSt.beltOff = belt - offsetof (SHARED_DATA, fSt);
+  for (c = 0; c < p_dim->c; c++)
+  { BELT (&(sh->fSt), c).memOff = cnt + (size_t) c * p_dim->n * sizeof (unsigned int) - (belt + c * sizeof (CAM));
+    BELT (&(sh->fSt), c).nKeys = p_dim->n;
+    BELT (&(sh->fSt), c).size = p_dim->m * shard;
+  }
+  sh->fSt.busQueue.memOff = queue - offsetof (SHARED_DATA, fSt.busQueue);
+  sh->fSt.busQueue.size = qSize;
+  sh->fSt.qTimeOff = qTime - offsetof (SHARED_DATA, fSt);
+  sh->fSt.busOff = bus - offsetof (SHARED_DATA, fSt);
+  for (b = 0; b < p_dim->b; b++)
+  { BUS (&(sh->fSt), b).seatOff = seat + (size_t) b * p_dim->t * sizeof (int) - (bus + b * sizeof (TRANSF_INFO));
+    BUS (&(sh->fSt), b).nSeats = p_dim->t;
+  }
+  sh->parkQueue.memOff = park - offsetof (SHARED_DATA, parkQueue);
+  sh->parkQueue.size = pSize;
+  sh->passOff = pass;
+  sh->passBusOff = passBus;
+  sh->beltSemOff = beltSem;
+  sh->nCallsOff = nCalls;
+  sh->portOff = port;
+  sh->driveOff = drive;
+  sh->wPassOff = wPass;
+  sh->nPassDOff = nPassD;
+  sh->nPassPOff = nPassP;
+  sh->flightEnd.countOff = epis - offsetof (SHARED_DATA, flightEnd);
+  sh->log.memOff = log - offsetof (SHARED_DATA, log);
+  sh->log.size = LOGSLOTS;
+  sh->log.recSize = snapSize (p_dim);
+  sh->fSt.logCtl.selOff = sel - offsetof (SHARED_DATA, fSt.logCtl);
+  sh->net.inbound.memOff = in - offsetof (SHARED_DATA, net.inbound);
+  sh->net.inbound.size = qSize;
+  return top;
+}
+
+/**
+ *  \brief Size of the shared region.
+ *
+ *  The region is made of a <em>SHARED_DATA</em> header followed by the arrays whose size depends on the problem
+ *  dimensions.
+ *
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *
+ *  \return size of the shared region (in bytes)
+ *  \return \c 0, if it is too big to be represented
+ */
+
+size_t sharedDataSize (DIM *p_dim)
+{
+  size_t size = layout (NULL, p_dim);                                                   /* size of the shared region */
+
+  return (size == SIZE_MAX) ? 0 : size;
+}
+
+/**
+ *  \brief Layout of the shared region.
+ *
+ *  The problem dimensions are stored in the header and the offsets and sizes of all the arrays are set so that the
+ *  intervening entities can find them. The contents of the arrays is left unspecified.
+ *
+ *  \param sh pointer to the shared region (at least <tt>sharedDataSize (p_dim)</tt> bytes long)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ */
+
+void sharedDataLayout (SHARED_DATA *sh, DIM *p_dim)
+{
+  layout (sh, p_dim);
+}
+
+/**
+ *  \brief Initialization of the shared region.
+ *
+ *  The region is laid out and the full state of the problem is set to the start of the day: the passengers of every
+ *  plane landing are generated at random, together with the contents of the planes' hold, and the identification of
+ *  the semaphores is stored. The random number generator must have been seeded before.
+ *
+ *  \param sh pointer to the shared region (at least <tt>sharedDataSize (p_dim)</tt> bytes long)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ */
+
+void sharedDataInit (SHARED_DATA *sh, DIM *p_dim)
+{
+  unsigned int k, p, b, c, i;                                                                  /* counting variables */
+
+  layout (sh, p_dim);                                                      /* locate the arrays in the shared region */
+
+  sh->fSt.nLand = 0;                                                                     /* initialize plane landing */
+  sh->fSt.st.porterStat = WAITING_FOR_A_PLANE_TO_LAND;        /* the porter is reading a newspaper while waiting for
+                                                                                                     next assignment */
+  for (k = 0; k < p_dim->k; k++)
+    sharedDataFlight (&(sh->fSt), k, 0);                        /* generate the passengers and load of every flight */
+  for (c = 0; c < p_dim->c; c++)
+    camInit (&BELT (&(sh->fSt), c));                                            /* set conveyor belts to empty state */
+  queueInit (&(sh->fSt.busQueue));                                                   /* set bus queue to empty state */
+  queueInit (&(sh->parkQueue));                                           /* set parked buses queue to empty state */
+  for (b = 0; b < p_dim->b; b++)
+  { BUS (&(sh->fSt), b).driverStat = PARKING_AT_THE_ARRIVAL_TERMINAL;   /* the driver has parked at the arrival
+                                                               transfer terminal waiting for passengers to transport */
+    queueIn (&(sh->parkQueue), b);                                             /* the buses are dispatched in order */
+    BUS (&(sh->fSt), b).nOccup = 0;                                                     /* initialize bus occupation */
+    for (i = 0; i < p_dim->t; i++)
+      SEAT (&BUS (&(sh->fSt), b), i) = EMPTYST;                                                /* list seat as empty */
+    BUS (&(sh->fSt), b).nDep = BUS (&(sh->fSt), b).nPass = 0;                      /* initialize figures of the rides */
+  }
+  sh->fSt.nToTPassFD = 0;  /* initialize total number of passengers for whom the airport was their final destination */
+  sh->fSt.nToTPassTST = 0;                                       /* initialize total number of passengers in transit */
+  sh->fSt.nToTBagsPCB = 0;                            /* initialize total number of bags placed in the belt conveyor */
+  sh->fSt.nToTBagsPSR = 0;                                /* initialize total number of bags placed in the storeroom */
+  sh->fSt.nToTMBags = 0;                                                  /* initialize total number of missing bags */
+  sh->fSt.dayEnded = false;                                           /* initialize flag signaling driver day's work */
+  logSetup (&(sh->fSt), NULL, NULL, 1);                                 /* every state is saved unless told otherwise */
+  depSetup (&(sh->fSt), NULL, 0);                                    /* default timetable, unless told otherwise too */
+
+  for (k = 0; k < p_dim->w; k++)
+    NPASSP (sh, k) = 0;                /* initialize number of passengers who have executed the operation whatShouldIDo
+                                                                                     in each plane landing under way */
+  for (p = 0; p < p_dim->n; p++)
+    NCALLS (sh, p) = 0;                           /* initialize number of calls made by the porter to each passenger */
+  for (b = 0; b < p_dim->b; b++)
+    NPASSD (sh, b) = 0;       /* initialize number of passengers who have executed either the operation enterTheBus
+                                                                                 or leaveTheBus in each bus transfer */
+  sh->log.ii = sh->log.ri = 0;                                               /* set ring of logging records to empty */
+  sh->net.airport = 0;                                                   /* the airport stands alone, unless linked */
+  sh->net.nAirports = 1;
+  sh->net.nextKey = -1;
+  queueInit (&(sh->net.inbound));                                              /* set inbound channel to empty state */
+  sh->net.nOffered = sh->net.nRefused = 0;                              /* initialize figures of the inbound channel */
+  sh->net.nIn = sh->net.nBagsIn = 0;
+  sh->day.resident = false;                                        /* the entities live a single day, unless told so */
+  sh->day.day = 0;
+  sh->day.quit = false;
+
+  sh->landAccess = LANDACCESS;                                /* identification of landing critical region semaphore */
+  sh->queueAccess = QUEUEACCESS;                            /* identification of bus queue critical region semaphore */
+  sh->seatsAccess = SEATSACCESS;                            /* identification of bus seats critical region semaphore */
+  sh->statsAccess = STATSACCESS;               /* identification of statistics and logging critical region semaphore */
+  sh->logFree = LOGFREE;                                         /* identification of free logging records semaphore */
+  sh->logFull = LOGFULL;                                       /* identification of filled logging records semaphore */
+  sh->net.inAccess = INACCESS;                        /* identification of inbound channel critical region semaphore */
+  barrierInit (&(sh->flightEnd), p_dim->n, p_dim->k, p_dim->w,
+               B_FLIGHT (p_dim->n, p_dim->p, p_dim->b, p_dim->c));                 /* passengers leaving each flight */
+  sh->day.endSem = B_DAY (p_dim->n, p_dim->p, p_dim->b, p_dim->c, p_dim->w);     /* identification of the day
+                                                                                                          semaphores */
+  sh->day.startSem = sh->day.endSem + 1;
+  for (p = 0; p < p_dim->n; p++)
+    PASSSEM (sh, p) = B_PASS + p;                                               /* identification of passenger semaphore */
+  for (c = 0; c < p_dim->c; c++)
+    BELTSEM (sh, c) = B_BELT (p_dim->n, p_dim->p, p_dim->b) + c;     /* identification of conveyor belt critical region
+                                                                                                           semaphore */
+  for (p = 0; p < p_dim->p; p++)
+    PORTSEM (sh, p) = B_PORT (p_dim->n) + p;                   /* identification of porter waiting for work semaphore */
+  for (b = 0; b < p_dim->b; b++)
+  { DRIVESEM (sh, b) = B_DRIVE (p_dim->n, p_dim->p) + b;            /* identification of bus driver waiting for starting
+                                                                                          a new journey semaphore */
+    WPASSSEM (sh, b) = B_WPASS (p_dim->n, p_dim->p, p_dim->b) + b;      /* identification of bus driver waiting for
+                                                                              passengers to board / unboard semaphore */
+  }
+}
+
+/**
+ *  \brief Generation of a plane landing.
+ *
+ *  The passengers of plane landing k are generated at random, together with the contents of the plane's hold. The
+ *  first nIn of them are passengers in transit handed off by the previous airport of the network: the number of
+ *  pieces of luggage they are supposed to be carrying is already set and kept.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param k plane landing number
+ *  \param nIn number of passengers handed off by the previous airport
+ */
+
+void sharedDataFlight (FULL_STAT *p_fSt, unsigned int k, unsigned int nIn)
+{
+  unsigned int p, i, j;                                                                        /* counting variables */
+  unsigned int nTot = 0;                                                                    /* plane load per flight */
+
+  for (p = 0; p < p_fSt->dim.n; p++)
+  { PASSSTAT (p_fSt, k, p).stat = AT_THE_DISEMBARKING_ZONE;              /* the passenger is coming out of the plane
+                                                                                                       after landing */
+    if (((unsigned int) floor (9.0*random ()/RAND_MAX+1.5)) < 4)
+       PASSSTAT (p_fSt, k, p).sit = TRT;                                              /* the passenger is in transit */
+       else PASSSTAT (p_fSt, k, p).sit = FD;              /* the passenger has this airport as her final destination */
+    if (p >= nIn)                                      /* number of pieces of luggage she is supposed to be carrying */
+       PASSSTAT (p_fSt, k, p).nBagsReal = (unsigned int) floor (((double) p_fSt->dim.m)*random ()/RAND_MAX+0.5);
+                                                             /* number of pieces of luggage she is actually carrying */
+    if ((PASSSTAT (p_fSt, k, p).sit == TRT) || (PASSSTAT (p_fSt, k, p).nBagsReal == 0))
+       PASSSTAT (p_fSt, k, p).nBagsAct = PASSSTAT (p_fSt, k, p).nBagsReal;                        /* no need to consider
+                                                                                                        missing bags */
+       else if (((unsigned int) floor (9.0*random ()/RAND_MAX+1.5)) < 5)
+                                                                                   /* the passenger has lost one bag */
+               PASSSTAT (p_fSt, k, p).nBagsAct = PASSSTAT (p_fSt, k, p).nBagsReal - 1;
+               else PASSSTAT (p_fSt, k, p).nBagsAct = PASSSTAT (p_fSt, k, p).nBagsReal;             /* the passenger
+                                                                                                          has no bag */
+    nTot += PASSSTAT (p_fSt, k, p).nBagsAct;                                                    /* update plane load */
+  }
+  PLHOLD (p_fSt, k).nBags = nTot;                                               /* set number of bags for plane load */
+  PLHOLD (p_fSt, k).nPortDone = 0;                                     /* no porter has found the plane's hold empty */
+  for (p = 0, i = 0; p < p_fSt->dim.n; p++)                                                    /* fill in plane load */
+  { for (j = 0; j < PASSSTAT (p_fSt, k, p).nBagsAct; j++, i++)
+      HOLDBAG (&PLHOLD (p_fSt, k), i).id = p;
+    PASSSTAT (p_fSt, k, p).nBagsAct = 0;                       /* reset number of pieces of luggage the passenger is
+                                                                                                   actually carrying */
+  }
+}
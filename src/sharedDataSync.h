@@ -13,6 +13,55 @@
  *  Both the format of the shared data, which represents the full state of the problem, and the identification of
  *  the different semaphores, which carry out the synchronization among the intervening entities, are provided.
  *
+ *  The shared data is partitioned in independent regions, each one of them with its own critical region semaphore:
+ *     \li <em>landing</em> - number of passengers who have left the plane in each of the flights under way, plane
+ *         landing number and the end-of-flight barrier of the passengers going out of the arrival terminal
+ *         (including the end of the drivers' day)
+ *     \li <em>belt</em> - one region per luggage conveyor belt: the belt, calls made by the porters to the
+ *         passengers who collect their bags from it and number of pieces of luggage already collected by them
+ *     \li <em>queue</em> - queue for the transfer ride, queue of the buses parked at the arrival transfer terminal, bus
+ *         each passenger has been handed to and flag signaling the end of the drivers' day
+ *     \li <em>seats</em> - occupation of the buses and number of passengers who have entered / left each bus in a
+ *         transfer
+ *     \li <em>stats</em> - statistical data and the logging file
+ *     \li <em>inbound</em> - channel of the passengers in transit handed off by the previous airport of the network
+ *         and its figures (see <tt>network.h</tt>).
+ *
+ *  A process holding more than one lock must have acquired them in the order they are listed above (landing, belt,
+ *  queue, seats, stats, inbound), and never the locks of two belts at a time, which rules out deadlock. The lock of
+ *  the inbound channel of the next airport is taken holding no other one. The state of each
+ *  intervening entity is only written by the entity itself. Saving the state requires holding the <em>stats</em>
+ *  lock alone: fields of the other regions are then read without mutual exclusion, so a logging line may show them
+ *  one step ahead.
+ *
+ *  The number of pieces of luggage left in each plane's hold is not guarded by a lock: the porters claim them by
+ *  decrementing it atomically, so that they unload the hold concurrently. The number of porters who have found it
+ *  empty is incremented atomically too.
+ *
+ *  Passenger p collects her bags from belt p mod C, so that the passengers waiting for their luggage only contend
+ *  with the ones sharing their belt and the porters with each other only when they deposit on the same belt.
+ *
+ *  The buses parked at the arrival transfer terminal are dispatched in the order they have arrived: the driver of
+ *  the bus at the head of the queue of parked buses is the only one who watches the queue for the transfer ride, and
+ *  the next boarding batch is handed to him. As he takes it out, he leaves the queue of parked buses and the driver of
+ *  the bus next in line takes over.
+ *
+ *  Up to W flights may be under way at once. A passenger leaving flight k only waits for flight k-W+1 to be over,
+ *  so that she may land again while the slowest passengers of the previous flights are still going out. The porters
+ *  start unloading a plane once all of its passengers have landed, as before: the passengers of a flight are the ones
+ *  of the previous flight landing anew, so none of them is still collecting her bags from the earlier one by then.
+ *  With W = 1, the flights follow each other strictly.
+ *
+ *  Several airports may be run side by side, each one with a shared region, a semaphore set and intervening entities
+ *  of its own. The passengers in transit are then handed off to the next airport over its inbound channel, whose lock
+ *  is the only one shared by two airports, and take a seat in one of its planes (see <tt>network.h</tt>).
+ *
+ *  Saving the state takes a snapshot into a ring of logging records, which is drained by the log writer.
+ *
+ *  A resident airport lives one day after another: the intervening entities, as their day's work is over, wait to be
+ *  let into the next one instead of terminating, the shared region being initialized anew in between (see
+ *  <tt>resident.h</tt>).
+ *
  *  \author António Rui Borges - December 2013
  */
 
@@ -22,48 +71,277 @@
 #include "probConst.h"
 #include "probDataStruct.h"
 
+/** \brief number of records in the ring of logging records */
+#define  LOGSLOTS     256
+
+/**
+ *  \brief Definition of <em>ring of logging records</em> data type.
+ *
+ *  Every record is a snapshot of the state. Records are put in by the intervening entities, within the statistics
+ *  critical region, and taken out by the log writer; the number of free and filled records is kept by a pair of
+ *  semaphores.
+ */
+typedef struct
+        { /** \brief offset of the storage region */
+          size_t memOff;
+          /** \brief number of records */
+          unsigned int size;
+          /** \brief size of a record (in bytes) */
+          unsigned int recSize;
+          /** \brief insertion pointer */
+          unsigned int ii;
+          /** \brief retrieval pointer */
+          unsigned int ri;
+        } LOGRING;
+
+/**
+ *  \brief Definition of <em>reusable barrier</em> data type (see <tt>barrier.h</tt>).
+ */
+typedef struct
+        { /** \brief number of participants in every episode */
+          unsigned int nPart;
+          /** \brief number of episodes */
+          unsigned int nEpis;
+          /** \brief number of episodes which may be under way at once */
+          unsigned int window;
+          /** \brief offset of the array of the number of participants who have arrived in each episode under way
+           *  (one per sense, window + 1) */
+          size_t countOff;
+          /** \brief identification of the release semaphore of sense 0 (one per sense, in order) */
+          unsigned int sem0;
+        } BARRIER;
+
+/**
+ *  \brief Definition of <em>link to the airport network</em> data type (see <tt>network.h</tt>).
+ */
+typedef struct
+        { /** \brief airport number */
+          unsigned int airport;
+          /** \brief number of airports in the network (1, if the airport stands alone) */
+          unsigned int nAirports;
+          /** \brief access key to the shared memory and semaphore set of the next airport (-1, if there is none) */
+          int nextKey;
+          /** \brief seed of the random number generator of the plane landings generated anew around the passengers
+           *  handed off by the previous airport (it is drawn by the generator; landing k is drawn from seed + k) */
+          unsigned int seed;
+          /** \brief identification of inbound channel critical region semaphore */
+          unsigned int inAccess;
+          /** \brief inbound channel: number of pieces of luggage of each passenger handed off by the previous airport
+           *  who has not boarded a plane yet */
+          QUEUE inbound;
+          /** \brief number of passengers the previous airport has tried to hand off */
+          unsigned int nOffered;
+          /** \brief number of them who were turned away, the inbound channel being full */
+          unsigned int nRefused;
+          /** \brief number of passengers handed off by the previous airport who have boarded a plane */
+          unsigned int nIn;
+          /** \brief number of pieces of luggage they have brought along */
+          unsigned int nBagsIn;
+        } NETLINK;
+
+/**
+ *  \brief Definition of <em>day of a resident airport</em> data type (see <tt>resident.h</tt>).
+ */
+typedef struct
+        { /** \brief the intervening entities live one day after another, instead of terminating after the first */
+          bool resident;
+          /** \brief day number */
+          unsigned int day;
+          /** \brief the intervening entities are to terminate, instead of living the next day */
+          bool quit;
+          /** \brief identification of the end of the day semaphore */
+          unsigned int endSem;
+          /** \brief identification of the release semaphore of the days of sense 0 (that of sense 1 follows) */
+          unsigned int startSem;
+        } DAYLINK;
+
 /**
  *  \brief Definition of <em>shared information</em> data type.
  */
 typedef struct
         { /** \brief full state of the problem */
           FULL_STAT fSt;
-          /** \brief identification of critical region semaphore */
-          unsigned int access;
-          /** \brief identification of porter waiting for work semaphore */
-          unsigned int waitingFlight;
-          /** \brief number of passengers who have executed the operation whatShouldIDo in each plane landing */
-          unsigned int nPassP;
-          /** \brief identification of passengers semaphore array (one per passenger) */
-          unsigned int pass[N];
-          /** \brief array of the number of calls made by the porter to each passenger */
-          unsigned int nCalls[N];
-          /** \brief identification of bus driver waiting for starting a new journey semaphore */
-          unsigned int waitingDrive;
-          /** \brief identification of bus driver waiting for passengers to board / unboard semaphore */
-          unsigned int waitingPass;
-          /** \brief number of passengers who have executed either the operation enterTheBus or
-           *  leaveTheBus in each bus transfer
+          /** \brief identification of landing critical region semaphore */
+          unsigned int landAccess;
+          /** \brief identification of bus queue critical region semaphore */
+          unsigned int queueAccess;
+          /** \brief identification of bus seats critical region semaphore */
+          unsigned int seatsAccess;
+          /** \brief identification of statistics and logging critical region semaphore */
+          unsigned int statsAccess;
+          /** \brief offset of the array of the number of passengers who have executed the operation whatShouldIDo in
+           *  each plane landing under way (one per flight in the window) */
+          size_t nPassPOff;
+          /** \brief passengers going out of the arrival terminal at the end of each plane landing */
+          BARRIER flightEnd;
+          /** \brief offset of the identification of passengers semaphore array (one per passenger) */
+          size_t passOff;
+          /** \brief offset of the identification of conveyor belts critical region semaphore array (one per belt) */
+          size_t beltSemOff;
+          /** \brief offset of the array of the number of calls made by the porter to each passenger */
+          size_t nCallsOff;
+          /** \brief offset of the identification of porters waiting for work semaphore array (one per porter) */
+          size_t portOff;
+          /** \brief queue of the buses parked at the arrival transfer terminal, in the order they have arrived */
+          QUEUE parkQueue;
+          /** \brief offset of the array of the bus each passenger has been handed to for the transfer ride */
+          size_t passBusOff;
+          /** \brief offset of the identification of bus drivers waiting for starting a new journey semaphore array
+           *  (one per bus)
            */
-          unsigned int nPassD;
+          size_t driveOff;
+          /** \brief offset of the identification of bus drivers waiting for passengers to board / unboard semaphore
+           *  array (one per bus)
+           */
+          size_t wPassOff;
+          /** \brief offset of the array of the number of passengers who have executed either the operation
+           *  enterTheBus or leaveTheBus in each transfer of each bus
+           */
+          size_t nPassDOff;
+          /** \brief ring of logging records */
+          LOGRING log;
+          /** \brief identification of free logging records semaphore */
+          unsigned int logFree;
+          /** \brief identification of filled logging records semaphore */
+          unsigned int logFull;
+          /** \brief link to the airport network */
+          NETLINK net;
+          /** \brief day of a resident airport */
+          DAYLINK day;
         } SHARED_DATA;
 
-/** \brief number of semaphores in the set */
-#define SEM_NU                 (N+4)
+/** \brief number of passengers who have executed the operation whatShouldIDo in plane landing k */
+#define NPASSP(sh,k)           (((unsigned int *) SHADDR (sh, (sh)->nPassPOff))[(k) % (sh)->fSt.dim.w])
+
+/** \brief identification of the semaphore of passenger p */
+#define PASSSEM(sh,p)          (((unsigned int *) SHADDR (sh, (sh)->passOff))[p])
+
+/** \brief identification of the critical region semaphore of conveyor belt c */
+#define BELTSEM(sh,c)          (((unsigned int *) SHADDR (sh, (sh)->beltSemOff))[c])
+
+/** \brief number of calls made by the porter to passenger p */
+#define NCALLS(sh,p)           (((unsigned int *) SHADDR (sh, (sh)->nCallsOff))[p])
+
+/** \brief identification of the semaphore of porter i */
+#define PORTSEM(sh,i)          (((unsigned int *) SHADDR (sh, (sh)->portOff))[i])
+
+/** \brief bus passenger p has been handed to for the transfer ride */
+#define PASSBUS(sh,p)          (((unsigned int *) SHADDR (sh, (sh)->passBusOff))[p])
+
+/** \brief identification of the semaphore of the driver of bus b waiting for starting a new journey */
+#define DRIVESEM(sh,b)         (((unsigned int *) SHADDR (sh, (sh)->driveOff))[b])
+
+/** \brief identification of the semaphore of the driver of bus b waiting for passengers to board / unboard */
+#define WPASSSEM(sh,b)         (((unsigned int *) SHADDR (sh, (sh)->wPassOff))[b])
 
-/** \brief index of critical region semaphore */
-#define ACCESS                     1
+/** \brief number of passengers who have executed either the operation enterTheBus or leaveTheBus in the present
+ *  transfer of bus b */
+#define NPASSD(sh,b)           (((unsigned int *) SHADDR (sh, (sh)->nPassDOff))[b])
 
-/** \brief index of porter waiting for work semaphore */
-#define WAITINGFLIGHT              2
+/** \brief number of semaphores in the set for n passengers per flight, np porters, nb buses, nc conveyor belts and a
+ *  window of w flights; with System V semaphores it must stay below SEMMSL (32000 by default), which bounds n to
+ *  some tens of thousands, whereas the implementation based on futexes has no such limit */
+#define SEM_NU(n,np,nb,nc,w)   ((n)+(np)+2*(nb)+(nc)+(w)+11)
 
-/** \brief index of bus driver waiting for starting a new journey semaphore */
-#define WAITINGDRIVE               3
+/** \brief index of landing critical region semaphore (first of the critical region semaphores) */
+#define LANDACCESS                 1
 
-/** \brief index of bus driver waiting for passengers to board / unboard semaphore */
-#define WAITINGPASS                4
+/** \brief index of bus queue critical region semaphore */
+#define QUEUEACCESS                2
+
+/** \brief index of bus seats critical region semaphore */
+#define SEATSACCESS                3
+
+/** \brief index of statistics and logging critical region semaphore (last of the critical region semaphores) */
+#define STATSACCESS                4
+
+/** \brief index of free logging records semaphore */
+#define LOGFREE                    5
+
+/** \brief index of filled logging records semaphore */
+#define LOGFULL                    6
+
+/** \brief index of inbound channel critical region semaphore */
+#define INACCESS                   7
 
 /** \brief base index of passengers semaphore array (one per passenger) */
-#define B_PASS                     5
+#define B_PASS                     8
+
+/** \brief base index of porters waiting for work semaphore array (one per porter), for n passengers per flight */
+#define B_PORT(n)                 (B_PASS+(n))
+
+/** \brief base index of bus drivers waiting for starting a new journey semaphore array (one per bus), for n
+ *  passengers per flight and np porters */
+#define B_DRIVE(n,np)             (B_PORT(n)+(np))
+
+/** \brief base index of bus drivers waiting for passengers to board / unboard semaphore array (one per bus), for n
+ *  passengers per flight, np porters and nb buses */
+#define B_WPASS(n,np,nb)          (B_DRIVE(n,np)+(nb))
+
+/** \brief base index of conveyor belts critical region semaphore array (one per belt), for n passengers per flight,
+ *  np porters and nb buses */
+#define B_BELT(n,np,nb)           (B_WPASS(n,np,nb)+(nb))
+
+/** \brief base index of the release semaphores of the end-of-flight barrier (one per sense), for n passengers per
+ *  flight, np porters, nb buses and nc conveyor belts */
+#define B_FLIGHT(n,np,nb,nc)      (B_BELT(n,np,nb)+(nc))
+
+/** \brief base index of the day semaphores of a resident airport (end of the day, followed by the release of the
+ *  days of sense 0 and 1), for n passengers per flight, np porters, nb buses, nc conveyor belts and a window of w
+ *  flights */
+#define B_DAY(n,np,nb,nc,w)       (B_FLIGHT(n,np,nb,nc)+(w)+1)
+
+/**
+ *  \brief Size of the shared region.
+ *
+ *  The region is made of a <em>SHARED_DATA</em> header followed by the arrays whose size depends on the problem
+ *  dimensions.
+ *
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ *
+ *  \return size of the shared region (in bytes)
+ *  \return \c 0, if it is too big to be represented
+ */
+
+extern size_t sharedDataSize (DIM *p_dim);
+
+/**
+ *  \brief Layout of the shared region.
+ *
+ *  The problem dimensions are stored in the header and the offsets and sizes of all the arrays are set so that the
+ *  intervening entities can find them. The contents of the arrays is left unspecified.
+ *
+ *  \param sh pointer to the shared region (at least <tt>sharedDataSize (p_dim)</tt> bytes long)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ */
+
+extern void sharedDataLayout (SHARED_DATA *sh, DIM *p_dim);
+
+/**
+ *  \brief Initialization of the shared region.
+ *
+ *  The region is laid out and the full state of the problem is set to the start of the day: the passengers of every
+ *  plane landing are generated at random, together with the contents of the planes' hold, and the identification of
+ *  the semaphores is stored. The random number generator must have been seeded before.
+ *
+ *  \param sh pointer to the shared region (at least <tt>sharedDataSize (p_dim)</tt> bytes long)
+ *  \param p_dim pointer to the location where the problem dimensions are stored
+ */
+
+extern void sharedDataInit (SHARED_DATA *sh, DIM *p_dim);
+
+/**
+ *  \brief Generation of a plane landing.
+ *
+ *  The passengers of plane landing k are generated at random, together with the contents of the plane's hold. The
+ *  first nIn of them are passengers in transit handed off by the previous airport of the network: the number of
+ *  pieces of luggage they are supposed to be carrying is already set and kept.
+ *
+ *  \param p_fSt pointer to the location where the full internal state is stored
+ *  \param k plane landing number
+ *  \param nIn number of passengers handed off by the previous airport
+ */
+
+extern void sharedDataFlight (FULL_STAT *p_fSt, unsigned int k, unsigned int nIn);
 
 #endif /* SHAREDDATASYNC_H_ */
@@ -33,7 +33,7 @@
  *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
  */
 
-int shmemCreate (int key, unsigned int size)
+int shmemCreate (int key, size_t size)
 {
   return shmget ((key_t) key, size, MASK | IPC_CREAT | IPC_EXCL);
 }
@@ -84,14 +84,14 @@ int shmemDestroy (int shmid)
 
 int shmemAttach (int shmid, void **pAttAdd)
 {
-  int stat;                                                                                   /* status of operation */
+  void *stat;                                                                                 /* status of operation */
 
-  stat = (int) shmat (shmid, (char *) NULL, 0);
-  if (stat != -1)
-     { *pAttAdd = (void *) stat;
+  stat = shmat (shmid, (char *) NULL, 0);
+  if (stat != (void *) -1)
+     { *pAttAdd = stat;
        return 0;
      }
-     else return stat;
+     else return -1;
 }
 
 /**
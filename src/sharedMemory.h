@@ -16,6 +16,8 @@
 #ifndef SHAREDMEMORY_H_
 #define SHAREDMEMORY_H_
 
+#include <stddef.h>
+
 /**
  *  \brief Creation of a new block.
  *
@@ -28,7 +30,7 @@
  *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
  */
 
-extern int shmemCreate (int key, unsigned int size);
+extern int shmemCreate (int key, size_t size);
 
 /**
  *  \brief Connection to a previously created block.
@@ -0,0 +1,301 @@
+/**
+ *  \file sharedMemoryPosix.c (implementation file)
+ *
+ *  \brief Shared memory management.
+ *
+ *   Operations defined on hared memory:
+ *      \li creation of a new block
+ *      \li connection to a previously created block
+ *      \li destruction of a previously created block
+ *      \li mapping of the block on the process address space
+ *      \li unmapping of the block off the process address space.
+ *
+ *  Implementation with POSIX shared memory objects, named after the creation key, which are mapped with
+ *  <tt>mmap</tt>. The block size is not bounded by the SVIPC <tt>shmmax</tt> limit.
+ *
+ *  Build options:
+ *     \li <tt>SHMEM_HUGETLB</tt> - the block is created in a <em>hugetlbfs</em> mount point (<tt>SHMEM_HUGEDIR</tt>,
+ *         <tt>/dev/hugepages</tt> by default) and mapped with huge pages
+ *     \li <tt>SHMEM_POPULATE</tt> - the page tables are prefaulted when the block is mapped
+ *     \li <tt>SHMEM_MLOCK</tt> - the block is locked in memory when it is mapped.
+ *
+ *  \author António Rui Borges - October 1995
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/** \brief access permission: user r-w */
+#define  MASK           0600
+
+/** \brief maximum number of blocks a process may be connected to */
+#define  NBLOCKS        16
+
+#ifdef SHMEM_HUGETLB
+#ifndef SHMEM_HUGEDIR
+/** \brief hugetlbfs mount point */
+#define  SHMEM_HUGEDIR  "/dev/hugepages"
+#endif
+/** \brief huge page size */
+#define  HPAGESZ        (2UL * 1024 * 1024)
+#endif
+
+/**
+ *  \brief Definition of <em>block</em> data type.
+ */
+typedef struct
+        { /** \brief creation key */
+          int key;
+          /** \brief file descriptor of the shared memory object (-1, if the table entry is free) */
+          int fd;
+          /** \brief block size (in bytes) */
+          size_t size;
+          /** \brief local address of the block (NULL, if it is not mapped) */
+          void *addr;
+        } BLOCK;
+
+/** \brief table of blocks (the block identifier is the table index) */
+static BLOCK block[NBLOCKS] = { [0 ... NBLOCKS-1] = { 0, -1, 0, NULL } };
+
+/**
+ *  \brief Name of the shared memory object holding a block.
+ *
+ *  \param key creation key
+ *  \param name pointer to the location where the name is to be stored (at least 64 characters)
+ */
+
+static void shmemName (int key, char *name)
+{
+#ifdef SHMEM_HUGETLB
+  sprintf (name, "%s/airport.%08x", SHMEM_HUGEDIR, (unsigned int) key);
+#else
+  sprintf (name, "/airport.%08x", (unsigned int) key);
+#endif
+}
+
+/**
+ *  \brief Opening of the shared memory object holding a block.
+ *
+ *  \param name object name
+ *  \param flags opening flags
+ *
+ *  \return file descriptor, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int shmemOpen (char *name, int flags)
+{
+#ifdef SHMEM_HUGETLB
+  return open (name, flags, MASK);
+#else
+  return shm_open (name, flags, MASK);
+#endif
+}
+
+/**
+ *  \brief Removal of the name of the shared memory object holding a block.
+ *
+ *  \param name object name
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+static int shmemUnlink (char *name)
+{
+#ifdef SHMEM_HUGETLB
+  return unlink (name);
+#else
+  return shm_unlink (name);
+#endif
+}
+
+/**
+ *  \brief Storing of a new block in the table of blocks.
+ *
+ *  \param key creation key
+ *  \param fd file descriptor of the shared memory object
+ *  \param size block size (in bytes)
+ *
+ *  \return block identifier, upon success
+ *  \return -\c 1, when the table is full (<tt>errno</tt> is set to <tt>ENOSPC</tt>)
+ */
+
+static int blockIn (int key, int fd, size_t size)
+{
+  int shmid;                                                                                     /* block identifier */
+
+  for (shmid = 0; shmid < NBLOCKS; shmid++)
+    if (block[shmid].fd == -1)
+       { block[shmid].key = key;
+         block[shmid].fd = fd;
+         block[shmid].size = size;
+         block[shmid].addr = NULL;
+         return shmid;
+       }
+  errno = ENOSPC;
+  return -1;
+}
+
+/**
+ *  \brief Creation of a new block.
+ *
+ *  The function fails if there is already a block of shared memory with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *  \param size block size (in bytes)
+ *
+ *  \return block identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemCreate (int key, size_t size)
+{
+  char name[64];                                                                 /* name of the shared memory object */
+  int fd;                                                                                         /* file descriptor */
+  size_t bsize = size;                                                                      /* block size (in bytes) */
+  int shmid;                                                                                     /* block identifier */
+
+  shmemName (key, name);
+#ifdef SHMEM_HUGETLB
+  bsize = (bsize + HPAGESZ - 1) & ~(HPAGESZ - 1);                                    /* a whole number of huge pages */
+#endif
+  if ((fd = shmemOpen (name, O_RDWR | O_CREAT | O_EXCL)) == -1)
+     return -1;
+  if ((ftruncate (fd, (off_t) bsize) == -1) || ((shmid = blockIn (key, fd, bsize)) == -1))
+     { close (fd);
+       shmemUnlink (name);
+       return -1;
+     }
+  return shmid;
+}
+
+/**
+ *  \brief Connection to a previously created block.
+ *
+ *  The function fails if there is no block with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *
+ *  \return block identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemConnect (int key)
+{
+  char name[64];                                                                 /* name of the shared memory object */
+  int fd;                                                                                         /* file descriptor */
+  struct stat st;                                                                               /* object attributes */
+  int shmid;                                                                                     /* block identifier */
+
+  shmemName (key, name);
+  if ((fd = shmemOpen (name, O_RDWR)) == -1)
+     return -1;
+  if ((fstat (fd, &st) == -1) || ((shmid = blockIn (key, fd, st.st_size)) == -1))
+     { close (fd);
+       return -1;
+     }
+  return shmid;
+}
+
+/**
+ *  \brief Destruction of a previously created block.
+ *
+ *  The function fails if there is no block with an identifier equal to <tt>shmid</tt>.
+ *
+ *  \param shmid block identifier
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemDestroy (int shmid)
+{
+  char name[64];                                                                 /* name of the shared memory object */
+
+  if ((shmid < 0) || (shmid >= NBLOCKS) || (block[shmid].fd == -1))
+     { errno = EINVAL;
+       return -1;
+     }
+  shmemName (block[shmid].key, name);
+  if (block[shmid].addr != NULL)
+     munmap (block[shmid].addr, block[shmid].size);
+  close (block[shmid].fd);
+  block[shmid].fd = -1;
+  block[shmid].addr = NULL;
+  return shmemUnlink (name);
+}
+
+/**
+ *  \brief Mapping of the block in the process address space.
+ *
+ *  The function fails if there is no block with an identifier equal to <tt>shmid</tt>.
+ *
+ *  \param shmid block identifier
+ *  \param pAttAdd pointer to the location where the local address of the attached block is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemAttach (int shmid, void **pAttAdd)
+{
+  int flags = MAP_SHARED;                                                                           /* mapping flags */
+  void *addr;                                                                          /* local address of the block */
+
+  if ((shmid < 0) || (shmid >= NBLOCKS) || (block[shmid].fd == -1))
+     { errno = EINVAL;
+       return -1;
+     }
+  if (block[shmid].addr != NULL)                                                                   /* already mapped */
+     { *pAttAdd = block[shmid].addr;
+       return 0;
+     }
+#ifdef SHMEM_HUGETLB
+  flags |= MAP_HUGETLB;
+#endif
+#ifdef SHMEM_POPULATE
+  flags |= MAP_POPULATE;
+#endif
+  if ((addr = mmap (NULL, block[shmid].size, PROT_READ | PROT_WRITE, flags, block[shmid].fd, 0)) == MAP_FAILED)
+     return -1;
+#ifdef SHMEM_MLOCK
+  if (mlock (addr, block[shmid].size) == -1)
+     { munmap (addr, block[shmid].size);
+       return -1;
+     }
+#endif
+  block[shmid].addr = *pAttAdd = addr;
+  return 0;
+}
+
+/**
+ *  \brief Unmapping of the block off the process address space.
+ *
+ *  The function fails if the pointer does not locate a region of the address space
+ *  where a mapping took previously place.
+ *
+ *  \param attAdd local address of the attached block
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemDettach (void *attAdd)
+{
+  int shmid;                                                                                     /* block identifier */
+
+  for (shmid = 0; shmid < NBLOCKS; shmid++)
+    if ((block[shmid].fd != -1) && (block[shmid].addr == attAdd) && (attAdd != NULL))
+       { block[shmid].addr = NULL;
+         return munmap (attAdd, block[shmid].size);
+       }
+  errno = EINVAL;
+  return -1;
+}
@@ -0,0 +1,188 @@
+/**
+ *  \file sharedMemoryThread.c (implementation file)
+ *
+ *  \brief Shared memory management.
+ *
+ *   Operations defined on hared memory:
+ *      \li creation of a new block
+ *      \li connection to a previously created block
+ *      \li destruction of a previously created block
+ *      \li mapping of the block on the process address space
+ *      \li unmapping of the block off the process address space.
+ *
+ *  Implementation with POSIX threads: the blocks are allocated in the process private memory, which is shared by all
+ *  the threads, so mapping a block just returns its address. It is meant for entities which run as threads of a
+ *  single process.
+ *
+ *  \author António Rui Borges - October 1995
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
+
+/** \brief maximum number of blocks */
+#define  NBLOCKS        16
+
+/**
+ *  \brief Definition of <em>block</em> data type.
+ */
+typedef struct
+        { /** \brief creation key */
+          int key;
+          /** \brief local address of the block */
+          void *addr;
+        } BLOCK;
+
+/** \brief table of blocks (the block identifier is the table index) */
+static BLOCK block[NBLOCKS];
+
+/** \brief access to the table of blocks */
+static pthread_mutex_t tabAccess = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ *  \brief Creation of a new block.
+ *
+ *  The function fails if there is already a block of shared memory with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *  \param size block size (in bytes)
+ *
+ *  \return block identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemCreate (int key, size_t size)
+{
+  int shmid = -1;                                                                                /* block identifier */
+  int n;                                                                                        /* counting variable */
+
+  pthread_mutex_lock (&tabAccess);
+  for (n = 0; n < NBLOCKS; n++)
+    if (block[n].addr != NULL)
+       { if (block[n].key == key)
+            { pthread_mutex_unlock (&tabAccess);
+              errno = EEXIST;
+              return -1;
+            }
+       }
+       else if (shmid == -1)
+               shmid = n;
+  if (shmid == -1)
+     { pthread_mutex_unlock (&tabAccess);
+       errno = ENOSPC;
+       return -1;
+     }
+  if ((block[shmid].addr = calloc (1, size)) == NULL)
+     { pthread_mutex_unlock (&tabAccess);
+       errno = ENOMEM;
+       return -1;
+     }
+  block[shmid].key = key;
+  pthread_mutex_unlock (&tabAccess);
+  return shmid;
+}
+
+/**
+ *  \brief Connection to a previously created block.
+ *
+ *  The function fails if there is no block with a creation key equal to <tt>key</tt>.
+ *
+ *  \param key creation key
+ *
+ *  \return block identifier, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemConnect (int key)
+{
+  int shmid;                                                                                     /* block identifier */
+
+  pthread_mutex_lock (&tabAccess);
+  for (shmid = 0; shmid < NBLOCKS; shmid++)
+    if ((block[shmid].addr != NULL) && (block[shmid].key == key)) break;
+  pthread_mutex_unlock (&tabAccess);
+  if (shmid == NBLOCKS)
+     { errno = ENOENT;
+       return -1;
+     }
+  return shmid;
+}
+
+/**
+ *  \brief Destruction of a previously created block.
+ *
+ *  The function fails if there is no block with an identifier equal to <tt>shmid</tt>.
+ *
+ *  \param shmid block identifier
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemDestroy (int shmid)
+{
+  pthread_mutex_lock (&tabAccess);
+  if ((shmid < 0) || (shmid >= NBLOCKS) || (block[shmid].addr == NULL))
+     { pthread_mutex_unlock (&tabAccess);
+       errno = EINVAL;
+       return -1;
+     }
+  free (block[shmid].addr);
+  block[shmid].addr = NULL;
+  pthread_mutex_unlock (&tabAccess);
+  return 0;
+}
+
+/**
+ *  \brief Mapping of the block in the process address space.
+ *
+ *  The function fails if there is no block with an identifier equal to <tt>shmid</tt>.
+ *
+ *  \param shmid block identifier
+ *  \param pAttAdd pointer to the location where the local address of the attached block is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemAttach (int shmid, void **pAttAdd)
+{
+  pthread_mutex_lock (&tabAccess);
+  if ((shmid < 0) || (shmid >= NBLOCKS) || (block[shmid].addr == NULL))
+     { pthread_mutex_unlock (&tabAccess);
+       errno = EINVAL;
+       return -1;
+     }
+  *pAttAdd = block[shmid].addr;
+  pthread_mutex_unlock (&tabAccess);
+  return 0;
+}
+
+/**
+ *  \brief Unmapping of the block off the process address space.
+ *
+ *  The function fails if the pointer does not locate a region of the address space
+ *  where a mapping took previously place.
+ *
+ *  \param attAdd local address of the attached block
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemDettach (void *attAdd)
+{
+  int shmid;                                                                                     /* block identifier */
+
+  pthread_mutex_lock (&tabAccess);
+  for (shmid = 0; shmid < NBLOCKS; shmid++)
+    if ((block[shmid].addr != NULL) && (block[shmid].addr == attAdd)) break;
+  pthread_mutex_unlock (&tabAccess);
+  if (shmid == NBLOCKS)
+     { errno = EINVAL;
+       return -1;
+     }
+  return 0;
+}